@@ -4,15 +4,40 @@
 
 #include "content/browser/accessibility/accessibility_tree_snapshot_combiner.h"
 
+#include "base/metrics/field_trial_params.h"
 #include "base/metrics/histogram_macros.h"
 #include "content/browser/renderer_host/render_frame_host_impl.h"
 
 namespace content {
 
+BASE_FEATURE(kAccessibilitySnapshotCombinerDeadline,
+             "AccessibilitySnapshotCombinerDeadline",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+namespace {
+
+// Allowance for IPC and scheduling on top of the per-frame snapshot timeout.
+const base::FeatureParam<base::TimeDelta> kDeadlineGracePeriod{
+    &kAccessibilitySnapshotCombinerDeadline, "grace_period",
+    base::Seconds(1)};
+
+}  // namespace
+
 AccessibilityTreeSnapshotCombiner::AccessibilityTreeSnapshotCombiner(
     base::OnceCallback<void(ui::AXTreeUpdate&)> callback,
     mojom::SnapshotAccessibilityTreeParamsPtr params)
-    : callback_(std::move(callback)), params_(std::move(params)) {}
+    : callback_(std::move(callback)), params_(std::move(params)) {
+  // A zero timeout means the snapshots are not time limited, so there is no
+  // point at which waiting for a frame can be considered hopeless.
+  if (base::FeatureList::IsEnabled(kAccessibilitySnapshotCombinerDeadline) &&
+      params_->timeout.is_positive()) {
+    // Unretained is safe because `this` owns `deadline_timer_`.
+    deadline_timer_.Start(
+        FROM_HERE, params_->timeout + kDeadlineGracePeriod.Get(),
+        base::BindOnce(&AccessibilityTreeSnapshotCombiner::OnDeadline,
+                       base::Unretained(this)));
+  }
+}
 
 void AccessibilityTreeSnapshotCombiner::RequestSnapshotOnRenderFrameHost(
     RenderFrameHostImpl* rfhi) {
@@ -21,28 +46,66 @@ void AccessibilityTreeSnapshotCombiner::RequestSnapshotOnRenderFrameHost(
   // responses from the renderer and run their respective callbacks, all
   // references to this will be removed and the destructor will be called.
   rfhi->RequestAXTreeSnapshot(
-      base::BindOnce(&AccessibilityTreeSnapshotCombiner::
-                         ReceiveSnapshotFromRenderFrameHost,
-                     this, rfhi->AccessibilityIsRootFrame()),
+      CreateSnapshotCallback(rfhi->AccessibilityIsRootFrame()),
       params_.Clone());
 }
 
+base::OnceCallback<void(ui::AXTreeUpdate&)>
+AccessibilityTreeSnapshotCombiner::CreateSnapshotCallbackForTesting(
+    bool is_root_frame) {
+  return CreateSnapshotCallback(is_root_frame);
+}
+
+base::OnceCallback<void(ui::AXTreeUpdate&)>
+AccessibilityTreeSnapshotCombiner::CreateSnapshotCallback(bool is_root_frame) {
+  ++pending_snapshot_count_;
+  return base::BindOnce(
+      &AccessibilityTreeSnapshotCombiner::ReceiveSnapshotFromRenderFrameHost,
+      this, is_root_frame);
+}
+
 void AccessibilityTreeSnapshotCombiner::ReceiveSnapshotFromRenderFrameHost(
     bool is_root_frame,
     ui::AXTreeUpdate& snapshot) {
+  DCHECK_GT(pending_snapshot_count_, 0u);
+  --pending_snapshot_count_;
+  if (!callback_) {
+    // The deadline already delivered the combined snapshot without this one.
+    return;
+  }
   combiner_.AddTree(snapshot, is_root_frame);
 }
 
+void AccessibilityTreeSnapshotCombiner::OnDeadline() {
+  UMA_HISTOGRAM_COUNTS_100(
+      "Accessibility.SnapshotCombiner.FramesMissingAtDeadline",
+      pending_snapshot_count_);
+  RunCallback();
+}
+
 // This is called automatically after the last call to
 // ReceiveSnapshotFromRenderFrameHost when there are no more references to this
 // object.
 AccessibilityTreeSnapshotCombiner::~AccessibilityTreeSnapshotCombiner() {
+  if (callback_) {
+    RunCallback();
+  }
+}
+
+void AccessibilityTreeSnapshotCombiner::RunCallback() {
+  deadline_timer_.Stop();
   combiner_.Combine();
-  CHECK(combiner_.combined());
 
-  // This ensures a move of `combiner_.combined()`. It should be safe to steal
-  // `combiner_`'s resources since we're being destroyed.
-  ui::AXTreeUpdate update = std::move(combiner_.combined().value());
+  ui::AXTreeUpdate update;
+  if (combiner_.combined()) {
+    // This ensures a move of `combiner_.combined()`. It should be safe to steal
+    // `combiner_`'s resources since no more trees are added after this.
+    update = std::move(combiner_.combined().value());
+  } else {
+    // Only possible if the deadline passed before the root frame's snapshot
+    // arrived.
+    CHECK_GT(pending_snapshot_count_, 0u);
+  }
   std::move(callback_).Run(update);
 }
 
@@ -5,7 +5,10 @@
 #ifndef CONTENT_BROWSER_ACCESSIBILITY_ACCESSIBILITY_TREE_SNAPSHOT_COMBINER_H_
 #define CONTENT_BROWSER_ACCESSIBILITY_ACCESSIBILITY_TREE_SNAPSHOT_COMBINER_H_
 
+#include "base/feature_list.h"
 #include "base/memory/ref_counted.h"
+#include "base/timer/timer.h"
+#include "content/common/content_export.h"
 #include "content/common/frame.mojom.h"
 #include "ui/accessibility/ax_tree_combiner.h"
 
@@ -13,12 +16,18 @@ namespace content {
 
 class RenderFrameHostImpl;
 
+// When enabled, the combined snapshot is delivered once the per-frame snapshot
+// timeout plus a grace period has passed, with whichever frame snapshots have
+// arrived by then, instead of waiting for the slowest renderer.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kAccessibilitySnapshotCombinerDeadline);
+
 // Helper class for use during one-off accessibility tree snapshots. This class
 // combines AXTreeUpdates into a single AXTreeUpdate using the AXTreeCombiner.
 // The class is RefCounted, and when there are no more references and the
 // destructor is called, the class will call AXTreeCombiner::Combine and pass
-// the resulting AXTreeUpdate to the provided callback.
-class AccessibilityTreeSnapshotCombiner
+// the resulting AXTreeUpdate to the provided callback, unless the deadline
+// above has already done so.
+class CONTENT_EXPORT AccessibilityTreeSnapshotCombiner
     : public base::RefCounted<AccessibilityTreeSnapshotCombiner> {
  public:
   AccessibilityTreeSnapshotCombiner(
@@ -31,17 +40,35 @@ class AccessibilityTreeSnapshotCombiner
   // single update that is passed to the callback provided in the constructor.
   void RequestSnapshotOnRenderFrameHost(RenderFrameHostImpl* rfhi);
 
+  // Returns the callback RequestSnapshotOnRenderFrameHost() would pass to a
+  // frame, so tests can deliver snapshots, or not, on behalf of frames.
+  base::OnceCallback<void(ui::AXTreeUpdate&)> CreateSnapshotCallbackForTesting(
+      bool is_root_frame);
+
  private:
   friend class base::RefCounted<AccessibilityTreeSnapshotCombiner>;
 
   ~AccessibilityTreeSnapshotCombiner();
 
+  // Returns a callback that adds a frame's snapshot to the combined one. The
+  // callback holds a reference to `this`.
+  base::OnceCallback<void(ui::AXTreeUpdate&)> CreateSnapshotCallback(
+      bool is_root_frame);
+
   void ReceiveSnapshotFromRenderFrameHost(bool is_root,
                                           ui::AXTreeUpdate& snapshot);
 
+  void OnDeadline();
+
+  // Combines the snapshots received so far and passes the result to
+  // `callback_`.
+  void RunCallback();
+
   ui::AXTreeCombiner combiner_;
   base::OnceCallback<void(ui::AXTreeUpdate&)> callback_;
   mojom::SnapshotAccessibilityTreeParamsPtr params_;
+  size_t pending_snapshot_count_ = 0;
+  base::OneShotTimer deadline_timer_;
 };
 
 }  // namespace content
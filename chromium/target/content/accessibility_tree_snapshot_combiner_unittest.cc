@@ -0,0 +1,160 @@
+// Copyright 2025 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/accessibility/accessibility_tree_snapshot_combiner.h"
+
+#include <optional>
+
+#include "base/memory/scoped_refptr.h"
+#include "base/test/bind.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/time/time.h"
+#include "content/common/frame.mojom.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/accessibility/ax_node_data.h"
+#include "ui/accessibility/ax_tree_id.h"
+#include "ui/accessibility/ax_tree_update.h"
+
+namespace content {
+
+namespace {
+
+constexpr char kFramesMissingAtDeadlineHistogram[] =
+    "Accessibility.SnapshotCombiner.FramesMissingAtDeadline";
+
+// Returns a snapshot of a frame with a single root node.
+ui::AXTreeUpdate CreateFrameSnapshot(const ui::AXTreeID& tree_id) {
+  ui::AXNodeData root;
+  root.id = 1;
+  root.role = ax::mojom::Role::kRootWebArea;
+
+  ui::AXTreeUpdate snapshot;
+  snapshot.has_tree_data = true;
+  snapshot.tree_data.tree_id = tree_id;
+  snapshot.root_id = root.id;
+  snapshot.nodes = {root};
+  return snapshot;
+}
+
+class AccessibilityTreeSnapshotCombinerTest : public testing::Test {
+ protected:
+  // Creates a combiner whose frame snapshots time out after `timeout`. The
+  // combined snapshot is stored in `combined_snapshot_`.
+  scoped_refptr<AccessibilityTreeSnapshotCombiner> CreateCombiner(
+      base::TimeDelta timeout) {
+    auto params = mojom::SnapshotAccessibilityTreeParams::New();
+    params->timeout = timeout;
+    return base::MakeRefCounted<AccessibilityTreeSnapshotCombiner>(
+        base::BindLambdaForTesting([this](ui::AXTreeUpdate& snapshot) {
+          EXPECT_FALSE(combined_snapshot_) << "Delivered more than once.";
+          combined_snapshot_ = snapshot;
+        }),
+        std::move(params));
+  }
+
+  BrowserTaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  base::HistogramTester histogram_tester_;
+  const ui::AXTreeID root_tree_id_ = ui::AXTreeID::CreateNewAXTreeID();
+  const ui::AXTreeID child_tree_id_ = ui::AXTreeID::CreateNewAXTreeID();
+  std::optional<ui::AXTreeUpdate> combined_snapshot_;
+};
+
+// Without the deadline, the combined snapshot waits for every frame.
+TEST_F(AccessibilityTreeSnapshotCombinerTest, WaitsForAllFramesByDefault) {
+  auto combiner = CreateCombiner(base::Seconds(1));
+  auto root_callback =
+      combiner->CreateSnapshotCallbackForTesting(/*is_root_frame=*/true);
+  auto child_callback =
+      combiner->CreateSnapshotCallbackForTesting(/*is_root_frame=*/false);
+  combiner.reset();
+
+  ui::AXTreeUpdate root_snapshot = CreateFrameSnapshot(root_tree_id_);
+  std::move(root_callback).Run(root_snapshot);
+  task_environment_.FastForwardBy(base::Minutes(1));
+  EXPECT_FALSE(combined_snapshot_);
+
+  ui::AXTreeUpdate child_snapshot = CreateFrameSnapshot(child_tree_id_);
+  std::move(child_callback).Run(child_snapshot);
+  ASSERT_TRUE(combined_snapshot_);
+  histogram_tester_.ExpectTotalCount(kFramesMissingAtDeadlineHistogram, 0);
+}
+
+// With the deadline, the combined snapshot is delivered once the timeout and
+// the grace period have passed, and frames that reply later are dropped.
+TEST_F(AccessibilityTreeSnapshotCombinerTest, DeliversAtDeadline) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeatureWithParameters(
+      kAccessibilitySnapshotCombinerDeadline, {{"grace_period", "1s"}});
+  auto combiner = CreateCombiner(base::Seconds(1));
+  auto root_callback =
+      combiner->CreateSnapshotCallbackForTesting(/*is_root_frame=*/true);
+  auto child_callback =
+      combiner->CreateSnapshotCallbackForTesting(/*is_root_frame=*/false);
+  combiner.reset();
+
+  ui::AXTreeUpdate root_snapshot = CreateFrameSnapshot(root_tree_id_);
+  std::move(root_callback).Run(root_snapshot);
+  task_environment_.FastForwardBy(base::Milliseconds(1999));
+  EXPECT_FALSE(combined_snapshot_);
+
+  task_environment_.FastForwardBy(base::Milliseconds(1));
+  ASSERT_TRUE(combined_snapshot_);
+  ASSERT_EQ(1u, combined_snapshot_->nodes.size());
+  EXPECT_EQ(ax::mojom::Role::kRootWebArea, combined_snapshot_->nodes[0].role);
+  histogram_tester_.ExpectUniqueSample(kFramesMissingAtDeadlineHistogram, 1, 1);
+
+  // The late snapshot is dropped rather than delivered a second time.
+  ui::AXTreeUpdate child_snapshot = CreateFrameSnapshot(child_tree_id_);
+  std::move(child_callback).Run(child_snapshot);
+  ASSERT_EQ(1u, combined_snapshot_->nodes.size());
+}
+
+// If the root frame misses the deadline, there is nothing to attach the other
+// frames to, so an empty snapshot is delivered.
+TEST_F(AccessibilityTreeSnapshotCombinerTest, EmptySnapshotWithoutRootFrame) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeatureWithParameters(
+      kAccessibilitySnapshotCombinerDeadline, {{"grace_period", "1s"}});
+  auto combiner = CreateCombiner(base::Seconds(1));
+  auto root_callback =
+      combiner->CreateSnapshotCallbackForTesting(/*is_root_frame=*/true);
+  auto child_callback =
+      combiner->CreateSnapshotCallbackForTesting(/*is_root_frame=*/false);
+  combiner.reset();
+
+  ui::AXTreeUpdate child_snapshot = CreateFrameSnapshot(child_tree_id_);
+  std::move(child_callback).Run(child_snapshot);
+  task_environment_.FastForwardBy(base::Seconds(2));
+  ASSERT_TRUE(combined_snapshot_);
+  EXPECT_TRUE(combined_snapshot_->nodes.empty());
+
+  ui::AXTreeUpdate root_snapshot = CreateFrameSnapshot(root_tree_id_);
+  std::move(root_callback).Run(root_snapshot);
+  EXPECT_TRUE(combined_snapshot_->nodes.empty());
+}
+
+// Snapshots without a timeout have no deadline either.
+TEST_F(AccessibilityTreeSnapshotCombinerTest, NoDeadlineWithoutTimeout) {
+  base::test::ScopedFeatureList feature_list(
+      kAccessibilitySnapshotCombinerDeadline);
+  auto combiner = CreateCombiner(base::TimeDelta());
+  auto root_callback =
+      combiner->CreateSnapshotCallbackForTesting(/*is_root_frame=*/true);
+  combiner.reset();
+
+  task_environment_.FastForwardBy(base::Minutes(1));
+  EXPECT_FALSE(combined_snapshot_);
+
+  ui::AXTreeUpdate root_snapshot = CreateFrameSnapshot(root_tree_id_);
+  std::move(root_callback).Run(root_snapshot);
+  ASSERT_TRUE(combined_snapshot_);
+  EXPECT_EQ(1u, combined_snapshot_->nodes.size());
+}
+
+}  // namespace
+
+}  // namespace content
@@ -4,7 +4,13 @@
 
 #include "content/browser/attribution_reporting/attribution_features.h"
 
+#include "base/feature_list.h"
+
 namespace content {
 // TODO(crbug.com/384870263): Add feature flag to gate report delivery on
 // navigation.
+
+BASE_FEATURE(kAttributionSourceBatching,
+             "AttributionSourceBatching",
+             base::FEATURE_DISABLED_BY_DEFAULT);
 }  // namespace content
@@ -5,9 +5,16 @@
 #ifndef CONTENT_BROWSER_ATTRIBUTION_REPORTING_ATTRIBUTION_FEATURES_H_
 #define CONTENT_BROWSER_ATTRIBUTION_REPORTING_ATTRIBUTION_FEATURES_H_
 
+#include "base/feature_list.h"
+#include "content/common/content_export.h"
+
 namespace content {
 // TODO(crbug.com/384870263): Add feature flag to gate report delivery on
 // navigation.
+
+// Coalesces source registrations received in the same task into a single
+// storage transaction.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kAttributionSourceBatching);
 }  // namespace content
 
 #endif  // CONTENT_BROWSER_ATTRIBUTION_REPORTING_ATTRIBUTION_FEATURES_H_
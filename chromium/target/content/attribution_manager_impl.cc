@@ -33,6 +33,7 @@
 #include "base/metrics/histogram_macros.h"
 #include "base/notreached.h"
 #include "base/observer_list.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
 #include "base/task/updateable_sequenced_task_runner.h"
@@ -175,8 +176,7 @@ class AttributionManagerImpl::ReportScheduler
       return;
     }
 
-    manager_->attribution_resolver_
-        .AsyncCall(&AttributionResolver::GetNextReportTime)
+    manager_->resolver().AsyncCall(&AttributionResolver::GetNextReportTime)
         .WithArgs(now)
         .Then(std::move(callback));
   }
@@ -200,7 +200,7 @@ class AttributionManagerImpl::ReportScheduler
     // offline so they are not temporally joinable. We do this in storage to
     // avoid pulling an unbounded number of reports into memory, only to
     // immediately issue async storage calls to modify their report times.
-    manager_->attribution_resolver_
+    manager_->resolver()
         .AsyncCall(&AttributionResolver::AdjustOfflineReportTimes)
         .Then(std::move(maybe_set_timer_cb));
   }
@@ -799,10 +799,56 @@ void AttributionManagerImpl::HandleSource(
       break;
   }
 
-  attribution_resolver_.AsyncCall(&AttributionResolver::StoreSource)
-      .WithArgs(std::move(source))
-      .Then(base::BindOnce(&AttributionManagerImpl::OnSourceStored,
-                           weak_factory_.GetWeakPtr(), cleared_debug_key));
+  StoreSource(std::move(source), cleared_debug_key);
+}
+
+void AttributionManagerImpl::StoreSource(
+    StorableSource source,
+    std::optional<uint64_t> cleared_debug_key) {
+  if (!base::FeatureList::IsEnabled(kAttributionSourceBatching)) {
+    resolver().AsyncCall(&AttributionResolver::StoreSource)
+        .WithArgs(std::move(source))
+        .Then(base::BindOnce(&AttributionManagerImpl::OnSourceStored,
+                             weak_factory_.GetWeakPtr(), cleared_debug_key));
+    return;
+  }
+
+  if (pending_sources_.empty()) {
+    base::SequencedTaskRunner::GetCurrentDefault()->PostTask(
+        FROM_HERE, base::BindOnce(&AttributionManagerImpl::StorePendingSources,
+                                  weak_factory_.GetWeakPtr()));
+  }
+  pending_sources_.push_back(std::move(source));
+  pending_sources_cleared_debug_keys_.push_back(cleared_debug_key);
+}
+
+void AttributionManagerImpl::StorePendingSources() {
+  DCHECK_EQ(pending_sources_.size(),
+            pending_sources_cleared_debug_keys_.size());
+  if (pending_sources_.empty()) {
+    return;
+  }
+  attribution_resolver_.AsyncCall(&AttributionResolver::StoreSources)
+      .WithArgs(std::exchange(pending_sources_, {}))
+      .Then(base::BindOnce(&AttributionManagerImpl::OnSourcesStored,
+                           weak_factory_.GetWeakPtr(),
+                           std::exchange(pending_sources_cleared_debug_keys_,
+                                         {})));
+}
+
+base::SequenceBound<AttributionResolver>& AttributionManagerImpl::resolver() {
+  // Calls made after sources were handled must not overtake them.
+  StorePendingSources();
+  return attribution_resolver_;
+}
+
+void AttributionManagerImpl::OnSourcesStored(
+    std::vector<std::optional<uint64_t>> cleared_debug_keys,
+    std::vector<StoreSourceResult> results) {
+  CHECK_EQ(cleared_debug_keys.size(), results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    OnSourceStored(cleared_debug_keys[i], std::move(results[i]));
+  }
 }
 
 void AttributionManagerImpl::OnSourceStored(
@@ -876,8 +922,7 @@ void AttributionManagerImpl::HandleTrigger(
       break;
   }
 
-  attribution_resolver_
-      .AsyncCall(&AttributionResolver::MaybeCreateAndStoreReport)
+  resolver().AsyncCall(&AttributionResolver::MaybeCreateAndStoreReport)
       .WithArgs(std::move(trigger))
       .Then(base::BindOnce(&AttributionManagerImpl::OnReportStored,
                            weak_factory_.GetWeakPtr(), cleared_debug_key,
@@ -954,8 +999,7 @@ void AttributionManagerImpl::GetActiveSourcesForWebUI(
   OnUserVisibleTaskStarted();
 
   const int kMaxSources = 1000;
-  attribution_resolver_
-      .AsyncCall(&AttributionResolver::GetActiveSourcesWithLimit)
+  resolver().AsyncCall(&AttributionResolver::GetActiveSourcesWithLimit)
       .WithArgs(kMaxSources)
       .Then(std::move(callback).Then(
           base::BindOnce(&AttributionManagerImpl::OnUserVisibleTaskComplete,
@@ -967,8 +1011,7 @@ void AttributionManagerImpl::GetPendingReportsForInternalUse(
     base::OnceCallback<void(std::vector<AttributionReport>)> callback) {
   OnUserVisibleTaskStarted();
 
-  attribution_resolver_
-      .AsyncCall(&AttributionResolver::GetAttributionReportsWithLimit)
+  resolver().AsyncCall(&AttributionResolver::GetAttributionReportsWithLimit)
       .WithArgs(/*max_report_time=*/base::Time::Max(), limit)
       .Then(std::move(callback).Then(
           base::BindOnce(&AttributionManagerImpl::OnUserVisibleTaskComplete,
@@ -984,7 +1027,7 @@ void AttributionManagerImpl::SendReportForWebUI(AttributionReport::Id id,
       base::BindOnce(&AttributionManagerImpl::OnUserVisibleTaskComplete,
                      weak_factory_.GetWeakPtr()));
 
-  attribution_resolver_.AsyncCall(&AttributionResolver::GetReport)
+  resolver().AsyncCall(&AttributionResolver::GetReport)
       .WithArgs(id)
       .Then(base::BindOnce(&AttributionManagerImpl::OnGetReportToSendFromWebUI,
                            weak_factory_.GetWeakPtr(), std::move(done)));
@@ -1021,7 +1064,7 @@ void AttributionManagerImpl::ClearData(
     OnUserVisibleTaskStarted();
   }
 
-  attribution_resolver_.AsyncCall(&AttributionResolver::ClearData)
+  resolver().AsyncCall(&AttributionResolver::ClearData)
       .WithArgs(delete_begin, delete_end, std::move(filter),
                 delete_rate_limit_data)
       .Then(std::move(done).Then(
@@ -1057,7 +1100,7 @@ void AttributionManagerImpl::OnClearDataComplete(bool was_user_visible) {
 void AttributionManagerImpl::GetAllDataKeys(
     base::OnceCallback<void(std::set<DataKey>)> callback) {
   OnUserVisibleTaskStarted();
-  attribution_resolver_.AsyncCall(&AttributionResolver::GetAllDataKeys)
+  resolver().AsyncCall(&AttributionResolver::GetAllDataKeys)
       .Then(std::move(callback).Then(
           base::BindOnce(&AttributionManagerImpl::OnUserVisibleTaskComplete,
                          weak_factory_.GetWeakPtr())));
@@ -1077,7 +1120,7 @@ void AttributionManagerImpl::RemoveAttributionDataByDataKey(
 
   OnUserVisibleTaskStarted();
 
-  attribution_resolver_.AsyncCall(&AttributionResolver::DeleteByDataKey)
+  resolver().AsyncCall(&AttributionResolver::DeleteByDataKey)
       .WithArgs(data_key)
       .Then(std::move(callback).Then(base::BindOnce(
           &AttributionManagerImpl::OnClearDataComplete,
@@ -1098,7 +1141,7 @@ void AttributionManagerImpl::GetReportsToSend() {
   //
   // TODO(apaseltiner): Consider limiting the number of reports being sent at
   // once, to avoid pulling an arbitrary number of reports into memory.
-  attribution_resolver_.AsyncCall(&AttributionResolver::GetAttributionReports)
+  resolver().AsyncCall(&AttributionResolver::GetAttributionReports)
       .WithArgs(/*max_report_time=*/base::Time::Now())
       .Then(base::BindOnce(&AttributionManagerImpl::SendReports,
                            weak_factory_.GetWeakPtr()));
@@ -1256,8 +1299,7 @@ void AttributionManagerImpl::OnReportSent(base::OnceClosure done,
       new_report_time);
 
   if (new_report_time) {
-    attribution_resolver_
-        .AsyncCall(&AttributionResolver::UpdateReportForSendFailure)
+    resolver().AsyncCall(&AttributionResolver::UpdateReportForSendFailure)
         .WithArgs(report.id(), *new_report_time)
         .Then(std::move(then));
 
@@ -1268,7 +1310,7 @@ void AttributionManagerImpl::OnReportSent(base::OnceClosure done,
 
   NotifyReportSent(/*is_debug_report=*/false, report, info);
 
-  attribution_resolver_.AsyncCall(&AttributionResolver::DeleteReport)
+  resolver().AsyncCall(&AttributionResolver::DeleteReport)
       .WithArgs(report.id())
       .Then(std::move(then));
 
@@ -1385,8 +1427,7 @@ void AttributionManagerImpl::MaybeSendAggregatableDebugReport(
       source_id.emplace(success->source_id);
     }
 
-    attribution_resolver_
-        .AsyncCall(&AttributionResolver::ProcessAggregatableDebugReport)
+    resolver().AsyncCall(&AttributionResolver::ProcessAggregatableDebugReport)
         .WithArgs(*std::move(debug_report),
                   result.source()
                       .registration()
@@ -1417,8 +1458,7 @@ void AttributionManagerImpl::MaybeSendAggregatableDebugReport(
         source.has_value()) {
       source_id.emplace(source->source_id());
     }
-    attribution_resolver_
-        .AsyncCall(&AttributionResolver::ProcessAggregatableDebugReport)
+    resolver().AsyncCall(&AttributionResolver::ProcessAggregatableDebugReport)
         .WithArgs(*std::move(debug_report),
                   /*remaining_budget=*/std::nullopt, source_id)
         .Then(base::BindOnce(
@@ -1615,7 +1655,7 @@ void AttributionManagerImpl::HandleOsRegistration(OsRegistration registration) {
     return;
   }
 
-  attribution_resolver_.AsyncCall(&AttributionResolver::StoreOsRegistrations)
+  resolver().AsyncCall(&AttributionResolver::StoreOsRegistrations)
       .WithArgs(std::move(origins));
 
   os_level_manager_->Register(
@@ -1676,7 +1716,7 @@ void AttributionManagerImpl::SetDebugMode(std::optional<bool> enabled,
       enabled.value_or(base::CommandLine::ForCurrentProcess()->HasSwitch(
           switches::kAttributionReportingDebugMode));
 
-  attribution_resolver_.AsyncCall(&AttributionResolver::SetDelegate)
+  resolver().AsyncCall(&AttributionResolver::SetDelegate)
       .WithArgs(MakeResolverDelegate(debug_mode))
       .Then(std::move(done).Then(base::BindOnce(
           [](base::WeakPtr<AttributionManagerImpl> manager,
@@ -24,6 +24,7 @@
 #include "content/browser/attribution_reporting/attribution_report.h"
 #include "content/browser/attribution_reporting/attribution_reporting.mojom-forward.h"
 #include "content/browser/attribution_reporting/process_aggregatable_debug_report_result.mojom-forward.h"
+#include "content/browser/attribution_reporting/storable_source.h"
 #include "content/common/content_export.h"
 #include "content/public/browser/storage_partition.h"
 
@@ -203,8 +204,16 @@ class CONTENT_EXPORT AttributionManagerImpl : public AttributionManager {
       AggregationService::AssemblyStatus);
   void MarkReportCompleted(AttributionReport::Id report_id);
 
+  void StoreSource(StorableSource source,
+                   std::optional<uint64_t> cleared_debug_key);
+  void StorePendingSources();
+  // Returns `attribution_resolver_` after storing the pending sources, which
+  // keeps calls on the resolver in the order they were made.
+  base::SequenceBound<AttributionResolver>& resolver();
   void OnSourceStored(std::optional<uint64_t> cleared_debug_key,
                       StoreSourceResult result);
+  void OnSourcesStored(std::vector<std::optional<uint64_t>> cleared_debug_keys,
+                       std::vector<StoreSourceResult> results);
   void OnReportStored(std::optional<uint64_t> cleared_debug_key,
                       bool cookie_based_debug_allowed,
                       CreateReportResult result);
@@ -293,6 +302,11 @@ class CONTENT_EXPORT AttributionManagerImpl : public AttributionManager {
 
   std::optional<base::Time> last_navigation_time_;
 
+  // Sources received in the current task, waiting to be stored together when
+  // `kAttributionSourceBatching` is enabled. The two vectors are parallel.
+  std::vector<StorableSource> pending_sources_;
+  std::vector<std::optional<uint64_t>> pending_sources_cleared_debug_keys_;
+
   base::WeakPtrFactory<AttributionManagerImpl> weak_factory_{this};
 };
 
@@ -1639,6 +1639,61 @@ TEST_F(AttributionManagerImplTest, HandleSource_NotifiesObservers) {
   EXPECT_THAT(StoredSources(), SizeIs(2));
 }
 
+class AttributionManagerImplSourceBatchingTest
+    : public AttributionManagerImplTest {
+ public:
+  AttributionManagerImplSourceBatchingTest() {
+    source_batching_feature_list_.InitAndEnableFeature(
+        kAttributionSourceBatching);
+  }
+
+ protected:
+  void ConfigureStorageDelegate(
+      ConfigurableStorageDelegate& delegate) const override {
+    delegate.set_max_sources_per_origin(2);
+  }
+
+ private:
+  base::test::ScopedFeatureList source_batching_feature_list_;
+};
+
+// Sources handled in the same task are stored together, in order, and the
+// per-origin source limit applies across them.
+TEST_F(AttributionManagerImplSourceBatchingTest,
+       SourcesInSameTask_StoredTogether) {
+  MockAttributionObserver observer;
+  base::ScopedObservation<AttributionManager, AttributionObserver> observation(
+      &observer);
+  observation.Observe(attribution_manager_.get());
+
+  std::vector<StorableSource> sources;
+  for (uint64_t i = 1; i <= 3; ++i) {
+    sources.push_back(SourceBuilder()
+                          .SetSourceEventId(i)
+                          .SetExpiry(kImpressionExpiry)
+                          .Build());
+  }
+
+  {
+    InSequence seq;
+    EXPECT_CALL(observer, OnSourceHandled(sources[0], _, _,
+                                          StorableSource::Result::kSuccess));
+    EXPECT_CALL(observer, OnSourceHandled(sources[1], _, _,
+                                          StorableSource::Result::kSuccess));
+    EXPECT_CALL(
+        observer,
+        OnSourceHandled(sources[2], _, _,
+                        StorableSource::Result::kInsufficientSourceCapacity));
+  }
+
+  for (const StorableSource& source : sources) {
+    attribution_manager_->HandleSource(source, kFrameId);
+  }
+  // The sources are still waiting to be batched here, so this also checks that
+  // later resolver calls don't overtake them.
+  EXPECT_THAT(StoredSources(), SizeIs(2));
+}
+
 TEST_F(AttributionManagerImplTest, HandleTrigger_NotifiesObservers) {
   MockAttributionObserver observer;
   base::ScopedObservation<AttributionManager, AttributionObserver> observation(
@@ -53,6 +53,12 @@ class AttributionResolver {
   // Unconverted matching sources are not modified.
   virtual StoreSourceResult StoreSource(StorableSource source) = 0;
 
+  // Stores a burst of sources as if by calling `StoreSource()` for each of
+  // them in order, but within a single transaction. Returns one result per
+  // source, in the same order.
+  virtual std::vector<StoreSourceResult> StoreSources(
+      std::vector<StorableSource> sources) = 0;
+
   // Finds all stored sources matching a given `trigger`, and creates a
   // new associated report. Only active sources will receive new attributions.
   // Returns whether a new report has been scheduled/added to storage.
@@ -11,6 +11,7 @@
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "base/check.h"
 #include "base/check_op.h"
@@ -523,6 +524,50 @@ StoreSourceResult AttributionResolverImpl::StoreSource(StorableSource source) {
                                                 stored_source->source_id()));
 }
 
+void AttributionResolverImpl::SetFailSourceBatchCommitForTesting(bool fail) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  storage_.set_fail_source_batch_commit_for_testing(fail);
+}
+
+std::vector<StoreSourceResult> AttributionResolverImpl::StoreSources(
+    std::vector<StorableSource> sources) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  std::vector<StoreSourceResult> results;
+  results.reserve(sources.size());
+
+  std::unique_ptr<AttributionStorageSql::SourceBatch> batch =
+      storage_.StartSourceBatch();
+  if (!batch) {
+    for (StorableSource& source : sources) {
+      results.push_back(StoreSource(std::move(source)));
+    }
+    return results;
+  }
+
+  // Each source is copied so that a result can still be reported for it if
+  // the batch fails to commit.
+  for (const StorableSource& source : sources) {
+    results.push_back(StoreSource(source));
+  }
+
+  if (batch->Commit()) {
+    return results;
+  }
+
+  // Nothing in the batch was persisted.
+  const base::Time now = base::Time::Now();
+  std::vector<StoreSourceResult> error_results;
+  error_results.reserve(sources.size());
+  for (StorableSource& source : sources) {
+    error_results.emplace_back(std::move(source), /*is_noised=*/false,
+                               /*source_time=*/now,
+                               /*destination_limit=*/std::nullopt,
+                               StoreSourceResult::InternalError());
+  }
+  return error_results;
+}
+
 CreateReportResult AttributionResolverImpl::MaybeCreateAndStoreReport(
     AttributionTrigger trigger) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
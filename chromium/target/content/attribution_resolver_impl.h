@@ -53,9 +53,14 @@ class CONTENT_EXPORT AttributionResolverImpl : public AttributionResolver {
   AttributionResolverImpl& operator=(AttributionResolverImpl&&) = delete;
   ~AttributionResolverImpl() override;
 
+  // Makes every `StoreSources()` batch fail to commit while `fail` is true.
+  void SetFailSourceBatchCommitForTesting(bool fail);
+
  private:
   // AttributionResolver:
   StoreSourceResult StoreSource(StorableSource source) override;
+  std::vector<StoreSourceResult> StoreSources(
+      std::vector<StorableSource> sources) override;
   CreateReportResult MaybeCreateAndStoreReport(
       AttributionTrigger trigger) override;
   std::vector<AttributionReport> GetAttributionReportsWithLimit(
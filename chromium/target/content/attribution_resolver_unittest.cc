@@ -767,6 +767,76 @@ TEST_F(AttributionResolverTest, MaxImpressionsPerOrigin_ExpiredSourcesIgnored) {
               ElementsAre(SourceEventIdIs(222u)));
 }
 
+TEST_F(AttributionResolverTest, StoreSources_MaxImpressionsPerOriginEnforced) {
+  delegate()->set_max_sources_per_origin(2);
+
+  const auto kOriginA = *SuitableOrigin::Deserialize("https://a.example");
+  const auto kOriginB = *SuitableOrigin::Deserialize("https://b.example");
+
+  std::vector<StorableSource> sources;
+  sources.push_back(
+      SourceBuilder().SetSourceOrigin(kOriginA).SetSourceEventId(1).Build());
+  sources.push_back(
+      SourceBuilder().SetSourceOrigin(kOriginA).SetSourceEventId(2).Build());
+  sources.push_back(
+      SourceBuilder().SetSourceOrigin(kOriginB).SetSourceEventId(3).Build());
+  // The per-origin count is served from memory within the batch, so it must
+  // account for the sources inserted earlier in the same batch.
+  sources.push_back(
+      SourceBuilder().SetSourceOrigin(kOriginA).SetSourceEventId(4).Build());
+
+  std::vector<StoreSourceResult> results =
+      storage()->StoreSources(std::move(sources));
+  ASSERT_THAT(results, SizeIs(4));
+  EXPECT_EQ(results[0].status(), StorableSource::Result::kSuccess);
+  EXPECT_EQ(results[1].status(), StorableSource::Result::kSuccess);
+  EXPECT_EQ(results[2].status(), StorableSource::Result::kSuccess);
+  EXPECT_EQ(results[3].status(),
+            StorableSource::Result::kInsufficientSourceCapacity);
+
+  EXPECT_THAT(storage()->GetActiveSources(),
+              ElementsAre(SourceEventIdIs(1u), SourceEventIdIs(2u),
+                          SourceEventIdIs(3u)));
+
+  // The batch is committed, and later registrations see its sources.
+  EXPECT_EQ(storage()
+                ->StoreSource(SourceBuilder()
+                                  .SetSourceOrigin(kOriginA)
+                                  .SetSourceEventId(5)
+                                  .Build())
+                .status(),
+            StorableSource::Result::kInsufficientSourceCapacity);
+}
+
+TEST_F(AttributionResolverTest, StoreSources_CommitFailureDropsBatch) {
+  delegate()->set_max_sources_per_origin(2);
+  auto* resolver = static_cast<AttributionResolverImpl*>(storage());
+  resolver->SetFailSourceBatchCommitForTesting(true);
+
+  std::vector<StorableSource> sources;
+  sources.push_back(SourceBuilder().SetSourceEventId(1).Build());
+  sources.push_back(SourceBuilder().SetSourceEventId(2).Build());
+  std::vector<StoreSourceResult> results =
+      storage()->StoreSources(std::move(sources));
+  ASSERT_THAT(results, SizeIs(2));
+  EXPECT_EQ(results[0].status(), StorableSource::Result::kInternalError);
+  EXPECT_EQ(results[1].status(), StorableSource::Result::kInternalError);
+  EXPECT_THAT(storage()->GetActiveSources(), IsEmpty());
+
+  // The active source count of the failed batch, which included its own
+  // sources, is dropped along with them, so the origin still has capacity.
+  resolver->SetFailSourceBatchCommitForTesting(false);
+  sources.clear();
+  sources.push_back(SourceBuilder().SetSourceEventId(3).Build());
+  sources.push_back(SourceBuilder().SetSourceEventId(4).Build());
+  results = storage()->StoreSources(std::move(sources));
+  ASSERT_THAT(results, SizeIs(2));
+  EXPECT_EQ(results[0].status(), StorableSource::Result::kSuccess);
+  EXPECT_EQ(results[1].status(), StorableSource::Result::kSuccess);
+  EXPECT_THAT(storage()->GetActiveSources(),
+              ElementsAre(SourceEventIdIs(3u), SourceEventIdIs(4u)));
+}
+
 TEST_F(AttributionResolverTest, MaxEventLevelReportsPerDestination) {
   SourceBuilder source_builder = TestAggregatableSourceProvider().GetBuilder();
 
@@ -552,6 +552,28 @@ bool AttributionStorageSql::Transaction::Commit() {
   return transaction_.Commit();
 }
 
+AttributionStorageSql::SourceBatch::SourceBatch(
+    AttributionStorageSql& storage,
+    std::unique_ptr<Transaction> transaction)
+    : storage_(storage), transaction_(std::move(transaction)) {
+  DCHECK(transaction_);
+  DCHECK(!storage_->active_source_counts_.has_value());
+  storage_->active_source_counts_.emplace();
+}
+
+AttributionStorageSql::SourceBatch::~SourceBatch() {
+  // Rolls back the transaction if it was not committed.
+  transaction_.reset();
+  storage_->active_source_counts_.reset();
+}
+
+bool AttributionStorageSql::SourceBatch::Commit() {
+  if (storage_->fail_source_batch_commit_for_testing_) {
+    return false;
+  }
+  return transaction_->Commit();
+}
+
 AttributionStorageSql::AttributionStorageSql(
     const base::FilePath& user_data_directory,
     AttributionResolverDelegate* delegate)
@@ -580,9 +602,30 @@ AttributionStorageSql::StartTransaction() {
   return Transaction::CreateAndStart(db_);
 }
 
+std::unique_ptr<AttributionStorageSql::SourceBatch>
+AttributionStorageSql::StartSourceBatch() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!LazyInit(DbCreationPolicy::kCreateIfAbsent)) {
+    return nullptr;
+  }
+  std::unique_ptr<Transaction> transaction = Transaction::CreateAndStart(db_);
+  if (!transaction) {
+    return nullptr;
+  }
+  return std::unique_ptr<SourceBatch>(
+      new SourceBatch(*this, std::move(transaction)));
+}
+
+void AttributionStorageSql::InvalidateActiveSourceCounts() {
+  if (active_source_counts_.has_value()) {
+    active_source_counts_->clear();
+  }
+}
+
 bool AttributionStorageSql::DeactivateSources(
     base::span<const StoredSource::Id> sources) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  InvalidateActiveSourceCounts();
 
   sql::Transaction transaction(&db_);
   if (!transaction.Begin()) {
@@ -743,6 +786,16 @@ std::optional<StoredSource> AttributionStorageSql::InsertSource(
 
   const StoredSource::Id source_id(db_.GetLastInsertRowId());
 
+  // The new source is active as `aggregatable_active` is always set.
+  if (active_source_counts_.has_value()) {
+    if (auto it = active_source_counts_->find(
+            common_info.source_origin().Serialize());
+        it != active_source_counts_->end()) {
+      it->second.count++;
+      it->second.valid_until = std::min(it->second.valid_until, expiry_time);
+    }
+  }
+
   static constexpr char kInsertDestinationSql[] =
       "INSERT INTO source_destinations(source_id,destination_site)"
       "VALUES(?,?)";
@@ -829,6 +882,7 @@ AttributionStorageSql::GetReportWithMinPriority(StoredSource::Id source_id,
 
 bool AttributionStorageSql::DeactivateSourceAtEventLevel(StoredSource::Id id) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  InvalidateActiveSourceCounts();
 
   static constexpr char kDeactivateSql[] =
       "UPDATE sources SET event_level_active=0 WHERE source_id=?";
@@ -1709,6 +1763,7 @@ void AttributionStorageSql::ClearDataWithFilter(
 
 void AttributionStorageSql::ClearAllDataAllTime(bool delete_rate_limit_data) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  InvalidateActiveSourceCounts();
   if (!LazyInit(DbCreationPolicy::kIgnoreIfAbsent)) {
     return;
   }
@@ -1796,6 +1851,37 @@ int64_t AttributionStorageSql::CountActiveSourcesWithSourceOrigin(
     const SuitableOrigin& origin,
     const base::Time now) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  if (active_source_counts_.has_value()) {
+    std::string serialized_origin = origin.Serialize();
+    if (auto it = active_source_counts_->find(serialized_origin);
+        it != active_source_counts_->end() && now >= it->second.counted_at &&
+        now < it->second.valid_until) {
+      return it->second.count;
+    }
+
+    // Also query the earliest expiry time, so that the count can be reused
+    // until one of the counted sources expires.
+    sql::Statement statement(db_.GetCachedStatement(
+        SQL_FROM_HERE,
+        attribution_queries::kCountActiveSourcesWithMinExpirySql));
+    statement.BindString(0, serialized_origin);
+    statement.BindTime(1, now);
+    if (!statement.Step()) {
+      return -1;
+    }
+    const int64_t count = statement.ColumnInt64(0);
+    active_source_counts_->insert_or_assign(
+        std::move(serialized_origin),
+        CachedActiveSourceCount{
+            .count = count,
+            .counted_at = now,
+            .valid_until =
+                count > 0 ? statement.ColumnTime(1) : base::Time::Max(),
+        });
+    return count;
+  }
+
   sql::Statement statement(db_.GetCachedStatement(
       SQL_FROM_HERE,
       attribution_queries::kCountActiveSourcesFromSourceOriginSql));
@@ -2485,6 +2571,7 @@ void AttributionStorageSql::DatabaseErrorCallback(int extended_error,
 bool AttributionStorageSql::DeleteSources(
     base::span<const StoredSource::Id> source_ids) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  InvalidateActiveSourceCounts();
   sql::Transaction transaction(&db_);
   if (!transaction.Begin()) {
     return false;
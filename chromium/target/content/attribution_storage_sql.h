@@ -14,11 +14,14 @@
 #include <vector>
 
 #include "base/containers/enum_set.h"
+#include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
 #include "base/containers/span.h"
 #include "base/files/file_path.h"
+#include "base/memory/raw_ref.h"
 #include "base/sequence_checker.h"
 #include "base/thread_annotations.h"
+#include "base/time/time.h"
 #include "base/types/expected.h"
 #include "content/browser/attribution_reporting/aggregatable_debug_rate_limit_table.h"
 #include "content/browser/attribution_reporting/attribution_report.h"
@@ -41,8 +44,6 @@ class SuitableOrigin;
 }  // namespace attribution_reporting
 
 namespace base {
-class Time;
-class TimeDelta;
 class Uuid;
 }  // namespace base
 
@@ -60,6 +61,19 @@ class Origin;
 
 namespace content {
 
+namespace attribution_queries {
+
+// Counts the active, unexpired sources of a source origin, like
+// `kCountActiveSourcesFromSourceOriginSql`, and also selects the earliest
+// expiry time among them.
+inline constexpr char kCountActiveSourcesWithMinExpirySql[] =
+    "SELECT COUNT(*),MIN(expiry_time)FROM sources "
+    "WHERE source_origin=? "
+    "AND(event_level_active=1 OR aggregatable_active=1)"
+    "AND expiry_time>?";
+
+}  // namespace attribution_queries
+
 class AggregatableDebugReport;
 class AttributionResolverDelegate;
 class AttributionTrigger;
@@ -110,6 +124,30 @@ class CONTENT_EXPORT AttributionStorageSql {
     sql::Transaction transaction_;
   };
 
+  // Scoper which runs a burst of source registrations in a single
+  // transaction. While a batch is open, the number of active sources per
+  // source origin is served from memory and updated incrementally as sources
+  // are inserted, instead of being recounted for every registration.
+  class SourceBatch {
+   public:
+    SourceBatch(const SourceBatch&) = delete;
+    SourceBatch& operator=(const SourceBatch&) = delete;
+    SourceBatch(SourceBatch&&) = delete;
+    SourceBatch& operator=(SourceBatch&&) = delete;
+    ~SourceBatch();
+
+    [[nodiscard]] bool Commit();
+
+   private:
+    friend class AttributionStorageSql;
+
+    SourceBatch(AttributionStorageSql& storage,
+                std::unique_ptr<Transaction> transaction);
+
+    const raw_ref<AttributionStorageSql> storage_;
+    std::unique_ptr<Transaction> transaction_;
+  };
+
   struct Error {};
 
   // If `user_data_directory` is empty, the DB is created in memory and no data
@@ -192,6 +230,9 @@ class CONTENT_EXPORT AttributionStorageSql {
 
   [[nodiscard]] std::unique_ptr<Transaction> StartTransaction();
 
+  // Creates the database if necessary. Returns null on failure.
+  [[nodiscard]] std::unique_ptr<SourceBatch> StartSourceBatch();
+
   // Deletes corrupt sources/reports if `deletion_counts` is not `nullptr`.
   void VerifyReports(DeletionCounts* deletion_counts);
 
@@ -240,6 +281,10 @@ class CONTENT_EXPORT AttributionStorageSql {
   void StoreOsRegistrations(const base::flat_set<url::Origin>&);
   void SetDelegate(AttributionResolverDelegate*);
 
+  void set_fail_source_batch_commit_for_testing(bool fail) {
+    fail_source_batch_commit_for_testing_ = fail;
+  }
+
   // Rate-limiting
   [[nodiscard]] bool AddRateLimitForSource(const StoredSource& source,
                                            int64_t destination_limit_priority);
@@ -434,6 +479,14 @@ class CONTENT_EXPORT AttributionStorageSql {
 
   struct ReportCorruptionStatusSetAndIds;
 
+  struct CachedActiveSourceCount {
+    int64_t count;
+    // The count is only valid from the time it was queried until the earliest
+    // expiry time among the counted sources.
+    base::Time counted_at;
+    base::Time valid_until;
+  };
+
   enum class DbStatus {
     kOpen,
     // The database has never been created, i.e. there is no database file at
@@ -473,6 +526,10 @@ class CONTENT_EXPORT AttributionStorageSql {
   [[nodiscard]] bool RemoveScopesDataForSource(StoredSource::Id)
       VALID_CONTEXT_REQUIRED(sequence_checker_);
 
+  // Must be called whenever sources are deactivated or deleted.
+  void InvalidateActiveSourceCounts()
+      VALID_CONTEXT_REQUIRED(sequence_checker_);
+
   // Returns false on failure.
   [[nodiscard]] bool InitializeSchema(bool db_empty)
       VALID_CONTEXT_REQUIRED(sequence_checker_);
@@ -562,6 +619,13 @@ class CONTENT_EXPORT AttributionStorageSql {
   OsRegistrationsTable os_registrations_table_
       GUARDED_BY_CONTEXT(sequence_checker_);
 
+  // Active source counts keyed by serialized source origin. Only set while a
+  // `SourceBatch` is open.
+  std::optional<base::flat_map<std::string, CachedActiveSourceCount>>
+      active_source_counts_ GUARDED_BY_CONTEXT(sequence_checker_);
+
+  bool fail_source_batch_commit_for_testing_ = false;
+
   SEQUENCE_CHECKER(sequence_checker_);
 };
 
@@ -13,6 +13,7 @@
 #include "base/test/gmock_expected_support.h"
 #include "content/browser/attribution_reporting/attribution_resolver.h"
 #include "content/browser/attribution_reporting/attribution_resolver_impl.h"
+#include "content/browser/attribution_reporting/attribution_storage_sql.h"
 #include "content/browser/attribution_reporting/attribution_test_utils.h"
 #include "content/browser/attribution_reporting/sql_queries.h"
 #include "content/browser/attribution_reporting/sql_query_plan_test_util.h"
@@ -109,6 +110,12 @@ TEST_F(AttributionSqlQueryPlanTest, kCountSourcesSql) {
       ValueIs(UsesIndex("active_sources_by_source_origin")));
 }
 
+TEST_F(AttributionSqlQueryPlanTest, kCountActiveSourcesWithMinExpirySql) {
+  EXPECT_THAT(
+      GetPlan(attribution_queries::kCountActiveSourcesWithMinExpirySql),
+      ValueIs(UsesIndex("active_sources_by_source_origin")));
+}
+
 TEST_F(AttributionSqlQueryPlanTest, kDedupKeySql) {
   EXPECT_THAT(GetPlan(attribution_queries::kDedupKeySql),
               ValueIs(UsesPrimaryKey()));
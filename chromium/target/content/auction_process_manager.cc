@@ -386,9 +386,23 @@ bool AuctionProcessManager::RequestWorkletService(
   // assignment logic.
   (*GetPendingRequestMap(worklet_type))[origin].insert(process_handle);
 
+  if (worklet_type == WorkletType::kBidder) {
+    for (Observer& observer : observers_) {
+      observer.OnBidderProcessRequestQueued();
+    }
+  }
+
   return false;
 }
 
+void AuctionProcessManager::AddObserver(Observer* observer) {
+  observers_.AddObserver(observer);
+}
+
+void AuctionProcessManager::RemoveObserver(Observer* observer) {
+  observers_.RemoveObserver(observer);
+}
+
 void AuctionProcessManager::MaybeStartAnticipatoryProcess(
     const url::Origin& origin,
     SiteInstance* frame_site_instance,
@@ -18,6 +18,8 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/observer_list.h"
+#include "base/observer_list_types.h"
 #include "base/process/process_handle.h"
 #include "base/timer/timer.h"
 #include "content/common/content_export.h"
@@ -92,6 +94,15 @@ class CONTENT_EXPORT AuctionProcessManager {
 
   class ProcessHandle;
 
+  // Observes requests that have to wait for a process.
+  class Observer : public base::CheckedObserver {
+   public:
+    // Invoked when a bidder worklet request is queued because the bidder
+    // process limit was reached. Observers holding on to idle bidder processes
+    // should release them.
+    virtual void OnBidderProcessRequestQueued() = 0;
+  };
+
   // Refcounted class that creates / holds Mojo Remote for an
   // AuctionWorkletService. Only public so it can be used by ProcessHandle and
   // by test classes.
@@ -367,6 +378,14 @@ class CONTENT_EXPORT AuctionProcessManager {
                                      SiteInstance* frame_site_instance,
                                      WorkletType worklet_type);
 
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+  // Returns true if any bidder worklet requests are waiting for a process.
+  bool HasPendingBidderRequests() const {
+    return !pending_bidder_request_queue_.empty();
+  }
+
   size_t GetPendingBidderRequestsForTesting() const {
     return pending_bidder_request_queue_.size();
   }
@@ -512,6 +531,8 @@ class CONTENT_EXPORT AuctionProcessManager {
   // are needed.
   std::vector<scoped_refptr<WorkletProcess>> idle_processes_;
 
+  base::ObserverList<Observer> observers_;
+
   base::WeakPtrFactory<AuctionProcessManager> weak_ptr_factory_{this};
 };
 
@@ -9,24 +9,33 @@
 
 #include "content/services/auction_worklet/auction_v8_helper.h"
 
+#include <algorithm>
 #include <limits>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string_view>
 #include <utility>
+#include <variant>
 
 #include "base/check.h"
 #include "base/containers/contains.h"
+#include "base/containers/lru_cache.h"
 #include "base/functional/callback.h"
 #include "base/location.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/no_destructor.h"
 #include "base/not_fatal_until.h"
 #include "base/notreached.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/strings/strcat.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
@@ -35,12 +44,15 @@
 #include "base/thread_annotations.h"
 #include "base/threading/platform_thread.h"
 #include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
 #include "base/timer/timer.h"
 #include "base/trace_event/trace_event.h"
+#include "base/types/expected.h"
 #include "build/build_config.h"
 #include "content/services/auction_worklet/auction_v8_devtools_agent.h"
 #include "content/services/auction_worklet/debug_command_queue.h"
 #include "content/services/auction_worklet/public/cpp/auction_worklet_features.h"
+#include "crypto/sha2.h"
 #include "gin/array_buffer.h"
 #include "gin/converter.h"
 #include "gin/gin_features.h"
@@ -135,6 +147,257 @@ class TrivialSerializerDelegate : public v8::ValueSerializer::Delegate {
   }
 };
 
+// Process-wide cache of compilation results for auction scripts and WASM
+// modules. Shared by all AuctionV8Helpers in the process, so a bidder or
+// seller script only needs a full compile the first time any worklet thread
+// sees it; later auctions consume the V8 code cache (or share the compiled
+// WASM module) instead. Entries are keyed by URL and a SHA-256 hash of the
+// source, so a changed script at the same URL is a miss, and scripts also by
+// whether they are compiled eagerly. Failed compiles are cached as their error
+// message, so the same source isn't compiled again just to fail the same way.
+// The least recently used entries are evicted once the code caches, WASM wire
+// bytes and error messages exceed kFledgeCompilationCacheMaxBytes.
+// Thread-safe.
+//
+// With kFledgeDeduplicateConcurrentCompilation, a thread that misses the cache
+// is recorded as compiling the script or module until it calls Put*(), and
+// other threads looking it up in the meantime block until then, or until
+// kFledgeDeduplicateConcurrentCompilationMaxWait passes and they compile it
+// themselves. Callers must therefore call Put*() after every miss.
+class CompilationCache {
+ public:
+  struct Key {
+    enum class Type { kScript, kWasm };
+
+    friend auto operator<=>(const Key&, const Key&) = default;
+
+    std::string url;
+    std::string source_hash;
+    Type type;
+  };
+
+  struct ScriptEntry {
+    // Produced by an eager compile, so it covers all functions of the script
+    // however the scripts consuming it would have been compiled.
+    scoped_refptr<base::RefCountedBytes> code_cache;
+    // How long the compile that produced `code_cache` took.
+    base::TimeDelta compile_time;
+  };
+
+  struct WasmEntry {
+    v8::CompiledWasmModule module;
+    base::TimeDelta compile_time;
+  };
+
+  // A cached compile: its entry, or the error message it failed with.
+  template <typename T>
+  using Result = base::expected<T, std::string>;
+
+  static CompilationCache& GetInstance() {
+    static base::NoDestructor<CompilationCache> instance;
+    return *instance;
+  }
+
+  CompilationCache() = default;
+
+  CompilationCache(const CompilationCache&) = delete;
+  CompilationCache& operator=(const CompilationCache&) = delete;
+
+  static bool IsEnabled() {
+    return base::FeatureList::IsEnabled(features::kFledgeCompilationCache);
+  }
+
+  // Hashes the source, so callers should make the key once per compile.
+  static Key MakeScriptKey(const GURL& url, const std::string& src) {
+    return Key{url.spec(), crypto::SHA256HashString(src), Key::Type::kScript};
+  }
+
+  static Key MakeWasmKey(const GURL& url, const std::string& payload) {
+    return Key{url.spec(), crypto::SHA256HashString(payload),
+               Key::Type::kWasm};
+  }
+
+  std::optional<Result<ScriptEntry>> GetScript(const Key& key) {
+    return Get<ScriptEntry>(key);
+  }
+
+  // Stores `entry`, if there is one, and ends the caller's compile of `key`.
+  void PutScript(const Key& key, std::optional<ScriptEntry> entry) {
+    std::optional<Entry> cache_entry;
+    size_t size = 0;
+    if (entry) {
+      size = entry->code_cache->size();
+      cache_entry = std::move(*entry);
+    }
+    Put(key, std::move(cache_entry), size);
+  }
+
+  // Called when V8 rejects a cached entry (e.g. after a V8 flag change).
+  void EraseScript(const Key& key) {
+    base::AutoLock autolock(lock_);
+    auto it = entries_.Peek(key);
+    if (it != entries_.end()) {
+      total_bytes_ -= it->second.size;
+      entries_.Erase(it);
+    }
+  }
+
+  std::optional<Result<WasmEntry>> GetWasm(const Key& key) {
+    return Get<WasmEntry>(key);
+  }
+
+  // Stores `entry`, if there is one, and ends the caller's compile of `key`.
+  // The module's wire bytes stand in for its size; its native code isn't
+  // exposed, and is shared rather than copied by every user anyway.
+  void PutWasm(const Key& key, std::optional<WasmEntry> entry) {
+    std::optional<Entry> cache_entry;
+    size_t size = 0;
+    if (entry) {
+      size = entry->module.GetWireBytesRef().size();
+      cache_entry = std::move(*entry);
+    }
+    Put(key, std::move(cache_entry), size);
+  }
+
+  // Stores that compiling `key` failed with `error`, and ends the caller's
+  // compile of `key`.
+  void PutError(const Key& key, std::string error) {
+    const size_t size = error.size();
+    Put(key, CompileError{std::move(error)}, size);
+  }
+
+  void Clear() {
+    base::AutoLock autolock(lock_);
+    entries_.Clear();
+    total_bytes_ = 0;
+    // Waiters wake up and compile on their own.
+    compiles_.clear();
+    compile_finished_.Broadcast();
+  }
+
+  // Records `key` as being compiled by some thread, until the next Put() of it.
+  void MarkCompilingForTesting(const Key& key) {
+    base::AutoLock autolock(lock_);
+    compiles_.insert(key);
+  }
+
+  // `callback` is run, with `lock_` held, whenever a thread starts waiting for
+  // another one's compile.
+  void SetWaitCallbackForTesting(base::RepeatingClosure callback) {
+    base::AutoLock autolock(lock_);
+    wait_callback_for_testing_ = std::move(callback);
+  }
+
+ private:
+  struct CompileError {
+    std::string message;
+  };
+
+  using Entry = std::variant<ScriptEntry, WasmEntry, CompileError>;
+
+  struct SizedEntry {
+    Entry entry;
+    size_t size;
+  };
+
+  static bool ShouldDeduplicate() {
+    return base::FeatureList::IsEnabled(
+        features::kFledgeDeduplicateConcurrentCompilation);
+  }
+
+  static void RecordWaitTime(base::TimeDelta wait_time) {
+    if (wait_time.is_positive()) {
+      base::UmaHistogramTimes("Ads.InterestGroup.Auction.CompilationWaitTime",
+                              wait_time);
+    }
+  }
+
+  template <typename T>
+  std::optional<Result<T>> Get(const Key& key) {
+    std::optional<Result<T>> result;
+    base::TimeDelta wait_time;
+    {
+      base::AutoLock autolock(lock_);
+      bool timed_out = false;
+      wait_time = WaitForCompileLocked(key, &timed_out);
+      auto it = entries_.Get(key);
+      if (it != entries_.end()) {
+        if (const auto* error =
+                std::get_if<CompileError>(&it->second.entry)) {
+          result = base::unexpected(error->message);
+        } else {
+          result = std::get<T>(it->second.entry);
+        }
+      } else if (ShouldDeduplicate() && !timed_out) {
+        // After a timeout, the key stays recorded for the thread still
+        // compiling it. Whichever of the two calls Put() first ends the
+        // record, which at worst lets a later thread compile it once more.
+        compiles_.insert(key);
+      }
+    }
+    RecordWaitTime(wait_time);
+    return result;
+  }
+
+  void Put(const Key& key, std::optional<Entry> entry, size_t size) {
+    const size_t max_bytes = base::saturated_cast<size_t>(
+        features::kFledgeCompilationCacheMaxBytes.Get());
+    base::AutoLock autolock(lock_);
+    if (entry && size <= max_bytes) {
+      auto it = entries_.Peek(key);
+      if (it != entries_.end()) {
+        total_bytes_ -= it->second.size;
+      }
+      entries_.Put(key, SizedEntry{std::move(*entry), size});
+      total_bytes_ += size;
+      while (total_bytes_ > max_bytes) {
+        total_bytes_ -= entries_.rbegin()->second.size;
+        entries_.Erase(entries_.rbegin());
+      }
+    }
+    if (compiles_.erase(key)) {
+      compile_finished_.Broadcast();
+    }
+  }
+
+  // Blocks until no other thread is compiling `key`, for at most
+  // kFledgeDeduplicateConcurrentCompilationMaxWait, and returns how long that
+  // took. Sets `timed_out` if the other thread is still compiling. V8 threads
+  // allow base sync primitives, see CreateTaskRunner().
+  base::TimeDelta WaitForCompileLocked(const Key& key, bool* timed_out)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    *timed_out = false;
+    if (!compiles_.contains(key)) {
+      return base::TimeDelta();
+    }
+    if (wait_callback_for_testing_) {
+      wait_callback_for_testing_.Run();
+    }
+    const base::TimeDelta max_wait =
+        features::kFledgeDeduplicateConcurrentCompilationMaxWait.Get();
+    base::ElapsedTimer wait_timer;
+    while (compiles_.contains(key)) {
+      const base::TimeDelta remaining = max_wait - wait_timer.Elapsed();
+      if (!remaining.is_positive()) {
+        *timed_out = true;
+        break;
+      }
+      compile_finished_.TimedWait(remaining);
+    }
+    return wait_timer.Elapsed();
+  }
+
+  base::Lock lock_;
+  base::ConditionVariable compile_finished_{&lock_};
+  // Evicted by size in Put(), rather than by count.
+  base::LRUCache<Key, SizedEntry> entries_ GUARDED_BY(lock_){
+      base::LRUCache<Key, SizedEntry>::NO_AUTO_EVICT};
+  size_t total_bytes_ GUARDED_BY(lock_) = 0;
+  // Scripts and modules being compiled by some thread, when deduplicating.
+  std::set<Key> compiles_ GUARDED_BY(lock_);
+  base::RepeatingClosure wait_callback_for_testing_ GUARDED_BY(lock_);
+};
+
 }  // namespace
 
 AuctionV8Helper::TimeLimit::~TimeLimit() = default;
@@ -388,11 +651,14 @@ void AuctionV8Helper::SetDestroyedCallback(base::OnceClosure callback) {
 v8::Local<v8::Context> AuctionV8Helper::CreateContext(
     v8::Handle<v8::ObjectTemplate> global_template) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  base::ElapsedTimer timer;
   v8::Local<v8::Context> context =
       v8::Context::New(isolate(), /*extensions=*/nullptr, global_template);
   auto result =
       context->Global()->Delete(context, CreateStringFromLiteral("Date"));
   DCHECK(!result.IsNothing());
+  base::UmaHistogramMicrosecondsTimes(
+      "Ads.InterestGroup.Auction.V8ContextCreationTime", timer.Elapsed());
   return context;
 }
 
@@ -541,25 +807,56 @@ v8::MaybeLocal<v8::UnboundScript> AuctionV8Helper::Compile(
   if (src_string.IsEmpty() || origin_string.IsEmpty())
     return v8::MaybeLocal<v8::UnboundScript>();
 
+  const bool eager_compile =
+      base::FeatureList::IsEnabled(features::kFledgeEagerJSCompilation) &&
+      eagerly_compile_js_;
+
+  // Scripts compiled for debugging, or with caller-provided cached data,
+  // bypass the process-wide compilation cache.
+  std::optional<CompilationCache::Key> cache_key;
+  std::optional<CompilationCache::ScriptEntry> cache_entry;
+  if (!debug_id && !cached_data && CompilationCache::IsEnabled()) {
+    cache_key = CompilationCache::MakeScriptKey(src_url, src);
+    auto cached_result = CompilationCache::GetInstance().GetScript(*cache_key);
+    if (cached_result && !cached_result->has_value()) {
+      error_out = std::move(cached_result->error());
+      return v8::MaybeLocal<v8::UnboundScript>();
+    }
+    if (cached_result) {
+      cache_entry = std::move(cached_result->value());
+    }
+  }
+
   TRACE_EVENT_BEGIN1(kTraceEventCategoryGroup, "v8.compile", "fileName",
                      src_url.spec());
 
-  // Compile script.
+  // Compile script. `script_source` takes ownership of whatever cached data it
+  // is given; data from the compilation cache is not copied, which is safe
+  // since `cache_entry` keeps it alive until after compilation.
+  v8::ScriptCompiler::CachedData* source_cached_data = cached_data;
+  if (cache_entry) {
+    source_cached_data = new v8::ScriptCompiler::CachedData(
+        cache_entry->code_cache->front(),
+        static_cast<int>(cache_entry->code_cache->size()),
+        v8::ScriptCompiler::CachedData::BufferNotOwned);
+  }
   v8::TryCatch try_catch(isolate());
   v8::ScriptCompiler::Source script_source(
       src_string.ToLocalChecked(),
-      v8::ScriptOrigin(origin_string.ToLocalChecked()), cached_data);
+      v8::ScriptOrigin(origin_string.ToLocalChecked()), source_cached_data);
   v8::ScriptCompiler::CompileOptions compile_options =
       v8::ScriptCompiler::kNoCompileOptions;
-  if (cached_data) {
+  if (source_cached_data) {
     compile_options = v8::ScriptCompiler::kConsumeCodeCache;
-  } else if (base::FeatureList::IsEnabled(
-                 features::kFledgeEagerJSCompilation) &&
-             eagerly_compile_js_) {
+  } else if (eager_compile || cache_key) {
+    // Compiles populating the compilation cache are always eager, so that
+    // later compiles find every function in the code cache.
     compile_options = v8::ScriptCompiler::kEagerCompile;
   }
+  base::ElapsedTimer compile_timer;
   auto result = v8::ScriptCompiler::CompileUnboundScript(
       v8_isolate, &script_source, compile_options);
+  base::TimeDelta compile_time = compile_timer.Elapsed();
   if (try_catch.HasCaught()) {
     error_out = FormatExceptionMessage(v8_isolate->GetCurrentContext(),
                                        try_catch.Message());
@@ -568,6 +865,41 @@ v8::MaybeLocal<v8::UnboundScript> AuctionV8Helper::Compile(
   DCHECK(!cached_data || (script_source.GetCachedData() &&
                           !script_source.GetCachedData()->rejected));
 
+  v8::Local<v8::UnboundScript> unbound_script;
+  std::optional<CompilationCache::ScriptEntry> new_cache_entry;
+  if (cache_key && result.ToLocal(&unbound_script)) {
+    if (cache_entry && !script_source.GetCachedData()->rejected) {
+      // Compared against the compile that populated the entry.
+      base::UmaHistogramTimes(
+          "Ads.InterestGroup.Auction.ScriptCompileTimeSaved",
+          std::max(cache_entry->compile_time - compile_time,
+                   base::TimeDelta()));
+    } else if (cache_entry) {
+      // V8 recompiled from source, so the cached data is stale; drop it rather
+      // than refreshing it, since this compile's time isn't representative.
+      CompilationCache::GetInstance().EraseScript(*cache_key);
+    } else {
+      std::unique_ptr<v8::ScriptCompiler::CachedData> code_cache(
+          v8::ScriptCompiler::CreateCodeCache(unbound_script));
+      if (code_cache) {
+        new_cache_entry = CompilationCache::ScriptEntry{
+            base::MakeRefCounted<base::RefCountedBytes>(base::span(
+                code_cache->data, static_cast<size_t>(code_cache->length))),
+            compile_time};
+      }
+    }
+  }
+  if (cache_key && !cache_entry) {
+    // Needed after every miss to let other threads waiting on this compile
+    // proceed.
+    if (result.IsEmpty() && error_out) {
+      CompilationCache::GetInstance().PutError(*cache_key, *error_out);
+    } else {
+      CompilationCache::GetInstance().PutScript(*cache_key,
+                                                std::move(new_cache_entry));
+    }
+  }
+
   TRACE_EVENT_END1(kTraceEventCategoryGroup, "v8.compile", "data",
                    [&](perfetto::TracedValue trace_context) {
                      auto dict = std::move(trace_context).WriteDictionary();
@@ -590,11 +922,40 @@ v8::MaybeLocal<v8::WasmModuleObject> AuctionV8Helper::CompileWasm(
   DebugContextScope maybe_debug(inspector(), v8_isolate->GetCurrentContext(),
                                 debug_id, src_url.spec());
 
+  std::optional<CompilationCache::Key> cache_key;
+  if (!debug_id && CompilationCache::IsEnabled()) {
+    cache_key = CompilationCache::MakeWasmKey(src_url, payload);
+    std::optional<CompilationCache::Result<CompilationCache::WasmEntry>>
+        cached_result = CompilationCache::GetInstance().GetWasm(*cache_key);
+    if (cached_result && !cached_result->has_value()) {
+      error_out = std::move(cached_result->error());
+      return v8::MaybeLocal<v8::WasmModuleObject>();
+    }
+    if (cached_result) {
+      const CompilationCache::WasmEntry& cache_entry = cached_result->value();
+      base::ElapsedTimer clone_timer;
+      v8::MaybeLocal<v8::WasmModuleObject> cached_module =
+          v8::WasmModuleObject::FromCompiledModule(isolate(),
+                                                   cache_entry.module);
+      if (!cached_module.IsEmpty()) {
+        base::UmaHistogramTimes(
+            "Ads.InterestGroup.Auction.WasmCompileTimeSaved",
+            std::max(cache_entry.compile_time - clone_timer.Elapsed(),
+                     base::TimeDelta()));
+        return cached_module;
+      }
+      // Compile below without touching the cache, since this wasn't a miss.
+      cache_key.reset();
+    }
+  }
+
   v8::TryCatch try_catch(isolate());
+  base::ElapsedTimer compile_timer;
   v8::MaybeLocal<v8::WasmModuleObject> result = v8::WasmModuleObject::Compile(
       isolate(),
       v8::MemorySpan<const uint8_t>(
           reinterpret_cast<const uint8_t*>(payload.data()), payload.size()));
+  base::TimeDelta compile_time = compile_timer.Elapsed();
   if (try_catch.HasCaught()) {
     // WasmModuleObject::Compile doesn't know the URL, so FormatExceptionMessage
     // would produce unhelpful message w/o that important bit of context.
@@ -605,9 +966,49 @@ v8::MaybeLocal<v8::WasmModuleObject> AuctionV8Helper::CompileWasm(
                           : FormatValue(isolate(), try_catch.Message()->Get()),
                       "."});
   }
+  if (cache_key) {
+    // Needed after every miss to let other threads waiting on this compile
+    // proceed.
+    v8::Local<v8::WasmModuleObject> wasm_module;
+    if (result.ToLocal(&wasm_module)) {
+      CompilationCache::GetInstance().PutWasm(
+          *cache_key, CompilationCache::WasmEntry{
+                          wasm_module->GetCompiledModule(), compile_time});
+    } else if (error_out) {
+      CompilationCache::GetInstance().PutError(*cache_key, *error_out);
+    } else {
+      CompilationCache::GetInstance().PutWasm(*cache_key, std::nullopt);
+    }
+  }
   return result;
 }
 
+// static
+void AuctionV8Helper::ClearCompilationCacheForTesting() {
+  CompilationCache::GetInstance().Clear();
+}
+
+// static
+void AuctionV8Helper::MarkWasmCompilingForTesting(const GURL& src_url,
+                                                  const std::string& payload) {
+  CompilationCache::GetInstance().MarkCompilingForTesting(
+      CompilationCache::MakeWasmKey(src_url, payload));
+}
+
+// static
+void AuctionV8Helper::FinishWasmCompileForTesting(const GURL& src_url,
+                                                  const std::string& payload) {
+  CompilationCache::GetInstance().PutWasm(
+      CompilationCache::MakeWasmKey(src_url, payload), std::nullopt);
+}
+
+// static
+void AuctionV8Helper::SetCompilationWaitCallbackForTesting(
+    base::RepeatingClosure callback) {
+  CompilationCache::GetInstance().SetWaitCallbackForTesting(
+      std::move(callback));
+}
+
 v8::MaybeLocal<v8::WasmModuleObject> AuctionV8Helper::CloneWasmModule(
     v8::Local<v8::WasmModuleObject> in) {
   return v8::WasmModuleObject::FromCompiledModule(isolate(),
@@ -906,6 +1307,7 @@ AuctionV8Helper::~AuctionV8Helper() {
 
 void AuctionV8Helper::CreateIsolate() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  base::ElapsedTimer timer;
 
   // Now the initialization is completed, create an isolate.
   isolate_holder_ = std::make_unique<gin::IsolateHolder>(
@@ -914,6 +1316,8 @@ void AuctionV8Helper::CreateIsolate() {
       gin::IsolateHolder::IsolateType::kUtility);
   FullIsolateScope v8_scope(this);
   scratch_context_.Reset(isolate(), CreateContext());
+  base::UmaHistogramTimes("Ads.InterestGroup.Auction.V8IsolateCreationTime",
+                          timer.Elapsed());
 }
 
 // static
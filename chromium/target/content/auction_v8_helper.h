@@ -277,7 +277,9 @@ class CONTENT_EXPORT AuctionV8Helper
   // Compiles the provided script. Despite not being bound to a context, there
   // still must be an active context for this method to be invoked. If
   // cached_data is non-null, use the `cached_data` instead of compiling from
-  // scratch. In case of an error sets `error_out`.
+  // scratch. Otherwise, if kFledgeCompilationCache is enabled and `debug_id` is
+  // null, consumes (or populates) the process-wide code cache for `src_url` and
+  // `src`. In case of an error sets `error_out`.
   v8::MaybeLocal<v8::UnboundScript> Compile(
       const std::string& src,
       const GURL& src_url,
@@ -287,8 +289,9 @@ class CONTENT_EXPORT AuctionV8Helper
 
   // Compiles the provided WASM module from bytecode. A context must be active
   // for this method to be invoked, and the object would be created for it (but
-  // may be cloned efficiently for other contexts via CloneWasmModule). In case
-  // of an error sets `error_out`.
+  // may be cloned efficiently for other contexts via CloneWasmModule). Like
+  // Compile(), shares compiled modules process-wide when
+  // kFledgeCompilationCache is enabled. In case of an error sets `error_out`.
   //
   // Note that since the returned object is a JS Object, so to properly isolate
   // different executions it should not be used directly but rather fresh copies
@@ -393,6 +396,25 @@ class CONTENT_EXPORT AuctionV8Helper
   // Calls Resume on all registered context group IDs.
   void ResumeAllForTesting();
 
+  // Drops all entries in the process-wide compilation cache used by Compile()
+  // and CompileWasm().
+  static void ClearCompilationCacheForTesting();
+
+  // Makes compiles of the WASM module `payload` from `src_url` wait as if
+  // another thread were compiling it, with
+  // kFledgeDeduplicateConcurrentCompilation, until
+  // FinishWasmCompileForTesting() is called for it or the wait times out.
+  static void MarkWasmCompilingForTesting(const GURL& src_url,
+                                          const std::string& payload);
+  static void FinishWasmCompileForTesting(const GURL& src_url,
+                                          const std::string& payload);
+
+  // `callback` is run on the compiling thread whenever a compile starts
+  // waiting for another thread's compile of the same script or module. It must
+  // not call into AuctionV8Helper.
+  static void SetCompilationWaitCallbackForTesting(
+      base::RepeatingClosure callback);
+
   // Establishes a debugger connection, initializing debugging objects if
   // needed, and associating the connection with the given `debug_id`.
   //
@@ -11,14 +11,20 @@
 #include <string>
 #include <vector>
 
+#include "base/barrier_closure.h"
 #include "base/functional/callback.h"
+#include "base/run_loop.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
 #include "base/task/sequenced_task_runner.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/test/bind.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
 #include "base/time/time.h"
+#include "content/services/auction_worklet/public/cpp/auction_worklet_features.h"
 #include "content/services/auction_worklet/public/mojom/bidder_worklet.mojom.h"
 #include "content/services/auction_worklet/public/mojom/trusted_signals_cache.mojom.h"
 #include "content/services/auction_worklet/worklet_devtools_debug_test_util.h"
@@ -369,6 +375,237 @@ TEST_F(AuctionV8HelperTest, UseCachedData) {
   }
 }
 
+// Check that with kFledgeCompilationCache, compiling the same script (or WASM
+// module) again consumes the process-wide cache, while changed sources or
+// debugging bypass it.
+TEST_F(AuctionV8HelperTest, CompilationCache) {
+  base::test::ScopedFeatureList feature_list(features::kFledgeCompilationCache);
+  AuctionV8Helper::ClearCompilationCacheForTesting();
+  base::HistogramTester histogram_tester;
+  const GURL kUrl("https://foo.test/");
+
+  v8::Context::Scope ctx(helper_->scratch_context());
+  auto compile = [&](const std::string& src) {
+    std::optional<std::string> error_msg;
+    v8::Local<v8::UnboundScript> script;
+    EXPECT_TRUE(helper_
+                    ->Compile(src, kUrl, /*debug_id=*/nullptr,
+                              /*cached_data=*/nullptr, error_msg)
+                    .ToLocal(&script));
+    EXPECT_FALSE(error_msg.has_value());
+  };
+
+  compile("function foo() { return 1;}");
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.ScriptCompileTimeSaved", 0);
+  compile("function foo() { return 1;}");
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.ScriptCompileTimeSaved", 1);
+  // Same URL, different contents.
+  compile("function foo() { return 2;}");
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.ScriptCompileTimeSaved", 1);
+
+  // Scripts compiled for debugging don't use the cache.
+  auto debug_id = base::MakeRefCounted<AuctionV8Helper::DebugId>(helper_.get());
+  std::optional<std::string> error_msg;
+  v8::Local<v8::UnboundScript> script;
+  ASSERT_TRUE(helper_
+                  ->Compile("function foo() { return 1;}", kUrl,
+                            debug_id.get(), /*cached_data=*/nullptr, error_msg)
+                  .ToLocal(&script));
+  debug_id->AbortDebuggerPauses();
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.ScriptCompileTimeSaved", 1);
+
+  const std::string wasm_bytes(kMinimalWasmModuleBytes,
+                               std::size(kMinimalWasmModuleBytes));
+  for (int i = 0; i < 2; ++i) {
+    v8::Local<v8::WasmModuleObject> wasm_module;
+    ASSERT_TRUE(helper_
+                    ->CompileWasm(wasm_bytes, kUrl, /*debug_id=*/nullptr,
+                                  error_msg)
+                    .ToLocal(&wasm_module));
+    EXPECT_FALSE(error_msg.has_value());
+  }
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.WasmCompileTimeSaved", 1);
+
+  // A failed compile is cached as its error.
+  std::optional<std::string> first_error;
+  EXPECT_TRUE(helper_
+                  ->Compile("function foo() {", kUrl, /*debug_id=*/nullptr,
+                            /*cached_data=*/nullptr, first_error)
+                  .IsEmpty());
+  ASSERT_TRUE(first_error.has_value());
+  std::optional<std::string> second_error;
+  EXPECT_TRUE(helper_
+                  ->Compile("function foo() {", kUrl, /*debug_id=*/nullptr,
+                            /*cached_data=*/nullptr, second_error)
+                  .IsEmpty());
+  EXPECT_EQ(first_error, second_error);
+
+  AuctionV8Helper::ClearCompilationCacheForTesting();
+}
+
+// Check that the compilation cache only keeps entries that fit in
+// kFledgeCompilationCacheMaxBytes, and that scripts compiled eagerly and lazily
+// share entries.
+TEST_F(AuctionV8HelperTest, CompilationCacheKeysAndBound) {
+  const GURL kUrl("https://foo.test/");
+  const std::string kSrc = "function foo() { return 1;}";
+  const char kTimeSavedHistogram[] =
+      "Ads.InterestGroup.Auction.ScriptCompileTimeSaved";
+
+  v8::Context::Scope ctx(helper_->scratch_context());
+  auto compile = [&]() {
+    std::optional<std::string> error_msg;
+    v8::Local<v8::UnboundScript> script;
+    EXPECT_TRUE(helper_
+                    ->Compile(kSrc, kUrl, /*debug_id=*/nullptr,
+                              /*cached_data=*/nullptr, error_msg)
+                    .ToLocal(&script));
+    EXPECT_FALSE(error_msg.has_value());
+  };
+
+  {
+    base::test::ScopedFeatureList feature_list;
+    feature_list.InitAndEnableFeatureWithParameters(
+        features::kFledgeCompilationCache,
+        {{"CompilationCacheMaxBytes", "1"}});
+    AuctionV8Helper::ClearCompilationCacheForTesting();
+    base::HistogramTester histogram_tester;
+    compile();
+    compile();
+    histogram_tester.ExpectTotalCount(kTimeSavedHistogram, 0);
+  }
+
+  {
+    base::test::ScopedFeatureList feature_list;
+    feature_list.InitWithFeatures({features::kFledgeCompilationCache,
+                                   features::kFledgeEagerJSCompilation},
+                                  {});
+    AuctionV8Helper::ClearCompilationCacheForTesting();
+    base::HistogramTester histogram_tester;
+    compile();
+    histogram_tester.ExpectTotalCount(kTimeSavedHistogram, 0);
+    // Whether compiles are eager isn't part of the key, since the entry was
+    // compiled eagerly either way.
+    helper_->DisableEagerJsCompilation();
+    compile();
+    histogram_tester.ExpectTotalCount(kTimeSavedHistogram, 1);
+    compile();
+    histogram_tester.ExpectTotalCount(kTimeSavedHistogram, 2);
+  }
+
+  AuctionV8Helper::ClearCompilationCacheForTesting();
+}
+
+// Check that with kFledgeDeduplicateConcurrentCompilation, V8 threads that
+// compile the same WASM module at the same time only compile it once. Both
+// threads are made to wait for a pretend compile, so that, once it ends, one of
+// them compiles the module while the other waits for and reuses its result.
+TEST_F(AuctionV8HelperTest, DeduplicateConcurrentCompilation) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitWithFeatures(
+      {features::kFledgeCompilationCache,
+       features::kFledgeDeduplicateConcurrentCompilation},
+      {});
+  AuctionV8Helper::ClearCompilationCacheForTesting();
+  base::HistogramTester histogram_tester;
+  const GURL kUrl("https://foo.test/");
+  const std::string wasm_bytes(kMinimalWasmModuleBytes,
+                               std::size(kMinimalWasmModuleBytes));
+
+  std::vector<scoped_refptr<AuctionV8Helper>> helpers;
+  for (int i = 0; i < 2; ++i) {
+    helpers.push_back(
+        AuctionV8Helper::Create(AuctionV8Helper::CreateTaskRunner()));
+  }
+  task_environment_.RunUntilIdle();
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.V8IsolateCreationTime", 2);
+
+  base::WaitableEvent all_waiting;
+  AuctionV8Helper::SetCompilationWaitCallbackForTesting(
+      base::BarrierClosure(helpers.size(),
+                           base::BindOnce(&base::WaitableEvent::Signal,
+                                          base::Unretained(&all_waiting))));
+  AuctionV8Helper::MarkWasmCompilingForTesting(kUrl, wasm_bytes);
+
+  base::RunLoop run_loop;
+  base::RepeatingClosure compiled =
+      base::BarrierClosure(helpers.size(), run_loop.QuitClosure());
+  for (const auto& helper : helpers) {
+    helper->v8_runner()->PostTask(
+        FROM_HERE, base::BindLambdaForTesting([&, helper]() {
+          AuctionV8Helper::FullIsolateScope isolate_scope(helper.get());
+          v8::Context::Scope ctx(helper->scratch_context());
+          std::optional<std::string> error_msg;
+          EXPECT_FALSE(helper
+                           ->CompileWasm(wasm_bytes, kUrl,
+                                         /*debug_id=*/nullptr, error_msg)
+                           .IsEmpty());
+          EXPECT_FALSE(error_msg.has_value());
+          compiled.Run();
+        }));
+  }
+  all_waiting.Wait();
+  AuctionV8Helper::FinishWasmCompileForTesting(kUrl, wasm_bytes);
+  run_loop.Run();
+
+  // Both threads waited for the pretend compile, and only one of them compiled
+  // the module afterwards.
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.CompilationWaitTime", 2);
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.WasmCompileTimeSaved", 1);
+
+  AuctionV8Helper::SetCompilationWaitCallbackForTesting(
+      base::RepeatingClosure());
+  helpers.clear();
+  task_environment_.RunUntilIdle();
+  AuctionV8Helper::ClearCompilationCacheForTesting();
+}
+
+// Check that a compile waiting for another thread's compile of the same module
+// compiles it itself after kFledgeDeduplicateConcurrentCompilationMaxWait, and
+// that its result is cached for later compiles.
+TEST_F(AuctionV8HelperTest, DeduplicateConcurrentCompilationTimesOut) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitWithFeaturesAndParameters(
+      {{features::kFledgeCompilationCache, {}},
+       {features::kFledgeDeduplicateConcurrentCompilation,
+        {{"MaxWait", "10ms"}}}},
+      {});
+  AuctionV8Helper::ClearCompilationCacheForTesting();
+  base::HistogramTester histogram_tester;
+  const GURL kUrl("https://foo.test/");
+  const std::string wasm_bytes(kMinimalWasmModuleBytes,
+                               std::size(kMinimalWasmModuleBytes));
+
+  // The pretend compile never finishes.
+  AuctionV8Helper::MarkWasmCompilingForTesting(kUrl, wasm_bytes);
+
+  v8::Context::Scope ctx(helper_->scratch_context());
+  for (int i = 0; i < 2; ++i) {
+    std::optional<std::string> error_msg;
+    EXPECT_FALSE(helper_
+                     ->CompileWasm(wasm_bytes, kUrl, /*debug_id=*/nullptr,
+                                   error_msg)
+                     .IsEmpty());
+    EXPECT_FALSE(error_msg.has_value());
+  }
+
+  // Only the first compile waited, and the second one reused its result.
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.CompilationWaitTime", 1);
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.WasmCompileTimeSaved", 1);
+
+  AuctionV8Helper::ClearCompilationCacheForTesting();
+}
+
 // Check that timing out scripts works.
 TEST_F(AuctionV8HelperTest, Timeout) {
   struct Timeouts {
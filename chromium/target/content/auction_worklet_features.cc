@@ -21,6 +21,24 @@ BASE_FEATURE(kFledgeAuctionDownloaderStaleWhileRevalidate,
              "FledgeAuctionDownloaderStaleWhileRevalidate",
              base::FEATURE_ENABLED_BY_DEFAULT);
 
+BASE_FEATURE(kFledgeCompilationCache,
+             "FledgeCompilationCache",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+BASE_FEATURE_PARAM(int,
+                   kFledgeCompilationCacheMaxBytes,
+                   &kFledgeCompilationCache,
+                   "CompilationCacheMaxBytes",
+                   16 * 1024 * 1024);
+
+BASE_FEATURE(kFledgeDeduplicateConcurrentCompilation,
+             "FledgeDeduplicateConcurrentCompilation",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+BASE_FEATURE_PARAM(base::TimeDelta,
+                   kFledgeDeduplicateConcurrentCompilationMaxWait,
+                   &kFledgeDeduplicateConcurrentCompilation,
+                   "MaxWait",
+                   base::Seconds(1));
+
 BASE_FEATURE(kFledgeEagerJSCompilation,
              "FledgeEagerJSCompilation",
              base::FEATURE_DISABLED_BY_DEFAULT);
@@ -71,6 +89,20 @@ BASE_FEATURE_PARAM(int,
                    "BidderThreadSelectorMaxImbalance",
                    4);
 
+BASE_FEATURE(kFledgeBidderWorkStealing,
+             "FledgeBidderWorkStealing",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+BASE_FEATURE_PARAM(int,
+                   kFledgeBidderWorkStealingMaxRunningTasksPerThread,
+                   &kFledgeBidderWorkStealing,
+                   "MaxRunningTasksPerThread",
+                   1);
+BASE_FEATURE_PARAM(bool,
+                   kFledgeBidderWorkStealingDispatchAhead,
+                   &kFledgeBidderWorkStealing,
+                   "DispatchAhead",
+                   true);
+
 BASE_FEATURE(kFledgePrepareSellerContextsInAdvance,
              "FledgePrepareSellerContextsInAdvance",
              base::FEATURE_DISABLED_BY_DEFAULT);
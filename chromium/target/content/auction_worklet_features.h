@@ -20,6 +20,24 @@ CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeAlwaysReuseSellerContext);
 CONTENT_EXPORT BASE_DECLARE_FEATURE(
     kFledgeAuctionDownloaderStaleWhileRevalidate);
 
+// Share V8 code caches (from eager compiles) and compiled WASM modules between
+// all worklets in a process, keyed by script URL and content hash.
+// kFledgeCompilationCacheMaxBytes bounds the total size of the code caches and
+// WASM modules kept.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeCompilationCache);
+CONTENT_EXPORT BASE_DECLARE_FEATURE_PARAM(int, kFledgeCompilationCacheMaxBytes);
+
+// With kFledgeCompilationCache, a V8 thread that needs a script or WASM module
+// that another thread of the process is already compiling waits for that
+// compile and shares its result, instead of compiling it again. Worklet
+// threads tend to start on the same scripts at once, so without this they all
+// miss the cache on the first auction. A thread waits at most
+// kFledgeDeduplicateConcurrentCompilationMaxWait before compiling on its own.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeDeduplicateConcurrentCompilation);
+CONTENT_EXPORT BASE_DECLARE_FEATURE_PARAM(
+    base::TimeDelta,
+    kFledgeDeduplicateConcurrentCompilationMaxWait);
+
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeEagerJSCompilation);
 
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeNoWasmLazyCompilation);
@@ -54,6 +72,19 @@ CONTENT_EXPORT BASE_DECLARE_FEATURE_PARAM(
     int,
     kFledgeBidderThreadSelectorMaxImbalance);
 
+// Hold generateBid tasks in per-thread queues until a V8 thread has capacity,
+// letting idle threads steal tasks queued behind a slow bidder. Origin affinity
+// is kept as a preference rather than a pin. With `DispatchAhead`, a thread
+// that is running its maximum number of tasks is also handed its next queued
+// task, so it doesn't sit idle while the completion is reported.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeBidderWorkStealing);
+CONTENT_EXPORT BASE_DECLARE_FEATURE_PARAM(
+    int,
+    kFledgeBidderWorkStealingMaxRunningTasksPerThread);
+CONTENT_EXPORT BASE_DECLARE_FEATURE_PARAM(
+    bool,
+    kFledgeBidderWorkStealingDispatchAhead);
+
 // Prepare seller contexts, including running top level scripts, before
 // we're ready to score a worklet's first ad.
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgePrepareSellerContextsInAdvance);
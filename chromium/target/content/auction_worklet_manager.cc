@@ -6,8 +6,10 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
@@ -27,9 +29,11 @@
 #include "base/memory/raw_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_refptr.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/not_fatal_until.h"
 #include "base/strings/strcat.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/task/sequenced_task_runner.h"
 #include "base/trace_event/trace_event.h"
 #include "content/browser/interest_group/auction_metrics_recorder.h"
 #include "content/browser/interest_group/auction_process_manager.h"
@@ -106,6 +110,11 @@ class AuctionWorkletManager::WorkletOwner
   void RegisterHandle(HandleKey handle);
   void UnregisterHandle(HandleKey handle);
 
+  // Called after a handle is unregistered. If `this` is a successfully loaded
+  // bidder worklet with no remaining handles, offers it to the
+  // AuctionWorkletManager's pool of warm bidder worklets.
+  void MaybeKeepWarm();
+
   uint64_t GetNextSeqNum() { return next_handle_seq_num_++; }
 
   auction_worklet::mojom::BidderWorklet* bidder_worklet() {
@@ -365,6 +374,15 @@ void AuctionWorkletManager::WorkletOwner::UnregisterHandle(HandleKey handle) {
   DCHECK_EQ(handles_waiting_for_process_.count(handle), 0u);
 }
 
+void AuctionWorkletManager::WorkletOwner::MaybeKeepWarm() {
+  if (!worklet_manager_ || worklet_info_.type != WorkletType::kBidder ||
+      !can_hand_out_worklet_ || notify_error_type_.has_value() ||
+      !handles_waiting_for_process_.empty() || !handles_with_process_.empty()) {
+    return;
+  }
+  worklet_manager_->KeepBidderWorkletWarm(this);
+}
+
 std::vector<std::string>
 AuctionWorkletManager::WorkletOwner::ComputeDevtoolsAuctionIds() {
   std::vector<std::string> result;
@@ -869,6 +887,18 @@ bool AuctionWorkletManager::WorkletKey::WorkletKey::operator<(
                   other.send_creative_scanning_metadata);
 }
 
+AuctionWorkletManager::WarmWorklet::WarmWorklet(
+    scoped_refptr<WorkletOwner> worklet,
+    base::TimeTicks expiry)
+    : worklet(std::move(worklet)), expiry(expiry) {}
+
+AuctionWorkletManager::WarmWorklet::WarmWorklet(WarmWorklet&&) = default;
+
+AuctionWorkletManager::WarmWorklet&
+AuctionWorkletManager::WarmWorklet::operator=(WarmWorklet&&) = default;
+
+AuctionWorkletManager::WarmWorklet::~WarmWorklet() = default;
+
 AuctionWorkletManager::WorkletHandle::~WorkletHandle() {
   // We register with subresource_url_authorizations() only if
   // AuthorizeSubresourceUrls() was called, so deregister if that's the case.
@@ -882,6 +912,7 @@ AuctionWorkletManager::WorkletHandle::~WorkletHandle() {
         ->OnWorkletHandleDestruction(this);
   }
   worklet_owner_->UnregisterHandle(HandleKey(seq_num_, this));
+  worklet_owner_->MaybeKeepWarm();
 }
 
 auction_worklet::mojom::BidderWorklet*
@@ -1014,9 +1045,16 @@ AuctionWorkletManager::AuctionWorkletManager(
         static_cast<StoragePartitionImpl*>(
             delegate_->GetFrame()->GetProcess()->GetStoragePartition()));
   }
+  process_manager_observation_.Observe(auction_process_manager_);
 }
 
-AuctionWorkletManager::~AuctionWorkletManager() = default;
+AuctionWorkletManager::~AuctionWorkletManager() {
+  // Release warm worklets while the rest of `this` is still valid, since their
+  // destruction calls back into OnWorkletNoLongerUsable().
+  std::list<WarmWorklet> warm_bidder_worklets =
+      std::move(warm_bidder_worklets_);
+  warm_bidder_worklets_.clear();
+}
 
 // static
 AuctionWorkletManager::WorkletKey AuctionWorkletManager::BidderWorkletKey(
@@ -1112,11 +1150,26 @@ void AuctionWorkletManager::RequestWorkletByKey(
   DCHECK(!process_assigned_callback ||
          worklet_info.type == WorkletType::kSeller);
 
+  // Worklets shared with a concurrent auction are neither hits nor misses of
+  // the warm pool, so they aren't recorded.
+  const bool record_warm_pool_outcome =
+      worklet_info.type == WorkletType::kBidder &&
+      base::FeatureList::IsEnabled(features::kFledgeKeepBidderWorkletsWarm);
   auto worklet_it = worklets_.find(worklet_info);
   scoped_refptr<WorkletOwner> worklet;
   if (worklet_it != worklets_.end()) {
     worklet = worklet_it->second;
+    // The worklet is about to be used again, so it's no longer idle. `worklet`
+    // holds a reference, so the one owned by the pool can be dropped.
+    if (TakeWarmBidderWorklet(worklet.get()) && record_warm_pool_outcome) {
+      base::UmaHistogramBoolean(
+          "Ads.InterestGroup.Auction.BidderWorkletReusedFromWarmPool", true);
+    }
   } else {
+    if (record_warm_pool_outcome) {
+      base::UmaHistogramBoolean(
+          "Ads.InterestGroup.Auction.BidderWorkletReusedFromWarmPool", false);
+    }
     // Can't just insert in the map and put a reference in `worklet_it`, since
     // need to keep a live reference.
     worklet = base::MakeRefCounted<WorkletOwner>(this, worklet_info,
@@ -1150,6 +1203,107 @@ void AuctionWorkletManager::OnWorkletNoLongerUsable(WorkletOwner* worklet) {
   DCHECK_EQ(worklet, worklets_[worklet->worklet_info()]);
 
   worklets_.erase(worklet->worklet_info());
+
+  // A warm worklet whose pipe was closed can't be reused. Its methods are
+  // still on the stack, so release the pool's reference asynchronously.
+  if (scoped_refptr<WorkletOwner> warm_worklet =
+          TakeWarmBidderWorklet(worklet)) {
+    base::SequencedTaskRunner::GetCurrentDefault()->ReleaseSoon(
+        FROM_HERE, std::move(warm_worklet));
+  }
+}
+
+void AuctionWorkletManager::OnBidderProcessRequestQueued() {
+  if (warm_bidder_worklets_.empty()) {
+    return;
+  }
+  // Idle worklets keep their processes, which count against the bidder process
+  // limit, so make way for the queued request. The AuctionProcessManager is in
+  // the middle of queueing it, so release them asynchronously. Unretained is
+  // safe because `warm_bidder_worklet_timer_` is owned by `this`.
+  warm_bidder_worklet_timer_.Start(
+      FROM_HERE, base::TimeDelta(),
+      base::BindOnce(&AuctionWorkletManager::ReleaseAllWarmBidderWorklets,
+                     base::Unretained(this)));
+}
+
+void AuctionWorkletManager::KeepBidderWorkletWarm(WorkletOwner* worklet) {
+  if (!base::FeatureList::IsEnabled(features::kFledgeKeepBidderWorkletsWarm)) {
+    return;
+  }
+  // Releasing the worklet may free a process slot another auction is waiting
+  // for.
+  if (auction_process_manager_->HasPendingBidderRequests()) {
+    return;
+  }
+  size_t max_warm_worklets = static_cast<size_t>(
+      std::max(0, features::kFledgeWarmBidderWorkletPoolSize.Get()));
+  if (max_warm_worklets == 0) {
+    return;
+  }
+
+  scoped_refptr<WorkletOwner> worklet_ref = TakeWarmBidderWorklet(worklet);
+  if (!worklet_ref) {
+    worklet_ref = worklet;
+  }
+  warm_bidder_worklets_.emplace_back(
+      std::move(worklet_ref),
+      base::TimeTicks::Now() +
+          features::kFledgeWarmBidderWorkletTimeout.Get());
+
+  while (warm_bidder_worklets_.size() > max_warm_worklets) {
+    // Take the reference out of the list before releasing it, since releasing
+    // the last reference re-enters OnWorkletNoLongerUsable().
+    scoped_refptr<WorkletOwner> evicted =
+        std::move(warm_bidder_worklets_.front().worklet);
+    warm_bidder_worklets_.pop_front();
+  }
+
+  warm_bidder_worklet_timer_.Start(
+      FROM_HERE,
+      warm_bidder_worklets_.front().expiry - base::TimeTicks::Now(),
+      base::BindOnce(&AuctionWorkletManager::ReleaseExpiredWarmBidderWorklets,
+                     base::Unretained(this)));
+}
+
+scoped_refptr<AuctionWorkletManager::WorkletOwner>
+AuctionWorkletManager::TakeWarmBidderWorklet(WorkletOwner* worklet) {
+  auto it = std::ranges::find_if(
+      warm_bidder_worklets_, [worklet](const WarmWorklet& warm_worklet) {
+        return warm_worklet.worklet.get() == worklet;
+      });
+  if (it == warm_bidder_worklets_.end()) {
+    return nullptr;
+  }
+  scoped_refptr<WorkletOwner> result = std::move(it->worklet);
+  warm_bidder_worklets_.erase(it);
+  return result;
+}
+
+void AuctionWorkletManager::ReleaseAllWarmBidderWorklets() {
+  // Move the references out of the list before releasing them, since releasing
+  // the last reference re-enters OnWorkletNoLongerUsable().
+  std::list<WarmWorklet> warm_bidder_worklets =
+      std::move(warm_bidder_worklets_);
+  warm_bidder_worklets_.clear();
+}
+
+void AuctionWorkletManager::ReleaseExpiredWarmBidderWorklets() {
+  base::TimeTicks now = base::TimeTicks::Now();
+  while (!warm_bidder_worklets_.empty() &&
+         warm_bidder_worklets_.front().expiry <= now) {
+    scoped_refptr<WorkletOwner> expired =
+        std::move(warm_bidder_worklets_.front().worklet);
+    warm_bidder_worklets_.pop_front();
+  }
+
+  if (!warm_bidder_worklets_.empty()) {
+    warm_bidder_worklet_timer_.Start(
+        FROM_HERE, warm_bidder_worklets_.front().expiry - now,
+        base::BindOnce(
+            &AuctionWorkletManager::ReleaseExpiredWarmBidderWorklets,
+            base::Unretained(this)));
+  }
 }
 
 mojo::PendingRemote<auction_worklet::mojom::AuctionSharedStorageHost>
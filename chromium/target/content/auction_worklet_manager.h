@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <list>
 #include <map>
 #include <optional>
 #include <string>
@@ -16,6 +17,9 @@
 #include "base/memory/raw_ptr.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/observer_list_types.h"
+#include "base/scoped_observation.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "base/types/expected.h"
 #include "content/browser/interest_group/auction_process_manager.h"
 #include "content/browser/interest_group/bidding_and_auction_server_key_fetcher.h"
@@ -61,7 +65,8 @@ class SubresourceUrlBuilder;
 // invoking callbacks that are sharing a worklet in FIFO order. The
 // AuctionProcessManager handles prioritization for process creation. Once a
 // process is created for a worklet, the worklet is created immediately.
-class CONTENT_EXPORT AuctionWorkletManager {
+class CONTENT_EXPORT AuctionWorkletManager
+    : public AuctionProcessManager::Observer {
  public:
   using WorkletType = AuctionProcessManager::WorkletType;
 
@@ -264,7 +269,7 @@ class CONTENT_EXPORT AuctionWorkletManager {
                         Delegate* delegate);
   AuctionWorkletManager(const AuctionWorkletManager&) = delete;
   AuctionWorkletManager& operator=(const AuctionWorkletManager&) = delete;
-  ~AuctionWorkletManager();
+  ~AuctionWorkletManager() override;
 
   // Computes the key for bidder worklet with given params.
   // RequestBidderWorklet(...) is RequestWorkletByKey(BidderWorkletKey(...))
@@ -369,9 +374,44 @@ class CONTENT_EXPORT AuctionWorkletManager {
   void MaybeStartAnticipatoryProcess(const url::Origin& origin,
                                      WorkletType worklet_type);
 
+  size_t GetWarmBidderWorkletCountForTesting() const {
+    return warm_bidder_worklets_.size();
+  }
+
  private:
+  // A bidder worklet no auction currently holds a handle to, kept alive so a
+  // later auction in the same frame can reuse it.
+  struct WarmWorklet {
+    WarmWorklet(scoped_refptr<WorkletOwner> worklet, base::TimeTicks expiry);
+    WarmWorklet(WarmWorklet&&);
+    WarmWorklet& operator=(WarmWorklet&&);
+    ~WarmWorklet();
+
+    scoped_refptr<WorkletOwner> worklet;
+    base::TimeTicks expiry;
+  };
+
   void OnWorkletNoLongerUsable(WorkletOwner* worklet);
 
+  // AuctionProcessManager::Observer implementation:
+  void OnBidderProcessRequestQueued() override;
+
+  // Called by a loaded bidder WorkletOwner when its last handle is destroyed.
+  // If kFledgeKeepBidderWorkletsWarm is enabled, takes a reference to it,
+  // evicting the least recently released worklet if the pool is full.
+  void KeepBidderWorkletWarm(WorkletOwner* worklet);
+
+  // Removes `worklet` from `warm_bidder_worklets_`, if present, returning the
+  // reference the pool held, so the caller controls when it's released.
+  scoped_refptr<WorkletOwner> TakeWarmBidderWorklet(WorkletOwner* worklet);
+
+  // Releases all warm worklets, regardless of their expiry.
+  void ReleaseAllWarmBidderWorklets();
+
+  // Releases all warm worklets whose expiry has passed, and restarts
+  // `warm_bidder_worklet_timer_` for the next one to expire, if any.
+  void ReleaseExpiredWarmBidderWorklets();
+
   mojo::PendingRemote<auction_worklet::mojom::AuctionSharedStorageHost>
   MaybeBindAuctionSharedStorageHost(RenderFrameHostImpl* auction_runner_rfh,
                                     const url::Origin& worklet_origin);
@@ -394,6 +434,18 @@ class CONTENT_EXPORT AuctionWorkletManager {
   std::unique_ptr<AuctionSharedStorageHost> auction_shared_storage_host_;
 
   std::map<WorkletKey, raw_ptr<WorkletOwner, CtnExperimental>> worklets_;
+
+  // Idle bidder worklets, ordered from least to most recently released. Each
+  // entry is also in `worklets_`, so requests with a matching WorkletKey pick
+  // it up. Only populated when kFledgeKeepBidderWorkletsWarm is enabled.
+  std::list<WarmWorklet> warm_bidder_worklets_;
+  base::OneShotTimer warm_bidder_worklet_timer_;
+
+  // Used to release `warm_bidder_worklets_` when bidder process requests have
+  // to wait for a process.
+  base::ScopedObservation<AuctionProcessManager,
+                          AuctionProcessManager::Observer>
+      process_manager_observation_{this};
 };
 
 }  // namespace content
@@ -21,6 +21,7 @@
 #include "base/run_loop.h"
 #include "base/strings/stringprintf.h"
 #include "base/test/bind.h"
+#include "base/test/metrics/histogram_tester.h"
 #include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
 #include "base/test/test_future.h"
@@ -1517,6 +1518,191 @@ TEST_F(AuctionWorkletManagerTest, ReuseBidderWorklet) {
               UnorderedElementsAre(kAuction4));
 }
 
+// Test that with kFledgeKeepBidderWorkletsWarm enabled, bidder worklets outlive
+// their last handle, so later auctions can reuse them, until they're evicted
+// or time out.
+TEST_F(AuctionWorkletManagerTest, KeepBidderWorkletsWarm) {
+  base::HistogramTester histogram_tester;
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeatureWithParameters(
+      features::kFledgeKeepBidderWorkletsWarm,
+      {{"WarmBidderWorkletPoolSize", "1"},
+       {"WarmBidderWorkletTimeout", "10s"}});
+  const GURL kOtherBiddingLogicUrl = GURL("https://origin2.test/script");
+
+  std::unique_ptr<AuctionWorkletManager::WorkletHandle> handle1;
+  base::test::TestFuture<void> worklet_available1;
+  auction_worklet_manager_->RequestBidderWorklet(
+      kAuction1, kDecisionLogicUrl, kWasmUrl, kTrustedSignalsUrl,
+      /*needs_cors_for_additional_bid=*/false,
+      /*experiment_group_id=*/std::nullopt,
+      /*trusted_bidding_signals_slot_size_param=*/"",
+      /*trusted_bidding_signals_coordinator=*/std::nullopt,
+      worklet_available1.GetCallback(), NeverInvokedFatalErrorCallback(),
+      handle1,
+      auction_metrics_recorder_manager_->CreateAuctionMetricsRecorder());
+  ASSERT_TRUE(worklet_available1.Wait());
+  std::unique_ptr<MockBidderWorklet> bidder_worklet1 =
+      auction_process_manager_->WaitForBidderWorklet();
+  auction_worklet::mojom::BidderWorklet* mojo_worklet1 =
+      handle1->GetBidderWorklet();
+
+  // Releasing the only handle keeps the worklet and its process alive.
+  handle1.reset();
+  EXPECT_EQ(1u, auction_worklet_manager_->GetWarmBidderWorkletCountForTesting());
+  EXPECT_EQ(1u, auction_process_manager_->GetBidderProcessCountForTesting());
+
+  // A later auction with the same parameters reuses the warm worklet.
+  std::unique_ptr<AuctionWorkletManager::WorkletHandle> handle2;
+  base::test::TestFuture<void> worklet_available2;
+  auction_worklet_manager_->RequestBidderWorklet(
+      kAuction2, kDecisionLogicUrl, kWasmUrl, kTrustedSignalsUrl,
+      /*needs_cors_for_additional_bid=*/false,
+      /*experiment_group_id=*/std::nullopt,
+      /*trusted_bidding_signals_slot_size_param=*/"",
+      /*trusted_bidding_signals_coordinator=*/std::nullopt,
+      worklet_available2.GetCallback(), NeverInvokedFatalErrorCallback(),
+      handle2,
+      auction_metrics_recorder_manager_->CreateAuctionMetricsRecorder());
+  ASSERT_TRUE(worklet_available2.Wait());
+  EXPECT_EQ(mojo_worklet1, handle2->GetBidderWorklet());
+  EXPECT_FALSE(auction_process_manager_->HasBidderWorkletRequest());
+  EXPECT_EQ(0u, auction_worklet_manager_->GetWarmBidderWorkletCountForTesting());
+  histogram_tester.ExpectBucketCount(
+      "Ads.InterestGroup.Auction.BidderWorkletReusedFromWarmPool", false, 1);
+  histogram_tester.ExpectBucketCount(
+      "Ads.InterestGroup.Auction.BidderWorkletReusedFromWarmPool", true, 1);
+
+  // Sharing the worklet with a concurrent auction isn't a warm pool hit.
+  std::unique_ptr<AuctionWorkletManager::WorkletHandle> shared_handle;
+  base::test::TestFuture<void> shared_worklet_available;
+  auction_worklet_manager_->RequestBidderWorklet(
+      kAuction3, kDecisionLogicUrl, kWasmUrl, kTrustedSignalsUrl,
+      /*needs_cors_for_additional_bid=*/false,
+      /*experiment_group_id=*/std::nullopt,
+      /*trusted_bidding_signals_slot_size_param=*/"",
+      /*trusted_bidding_signals_coordinator=*/std::nullopt,
+      shared_worklet_available.GetCallback(), NeverInvokedFatalErrorCallback(),
+      shared_handle,
+      auction_metrics_recorder_manager_->CreateAuctionMetricsRecorder());
+  ASSERT_TRUE(shared_worklet_available.Wait());
+  shared_handle.reset();
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.Auction.BidderWorkletReusedFromWarmPool", 2);
+  handle2.reset();
+  EXPECT_EQ(1u, auction_worklet_manager_->GetWarmBidderWorkletCountForTesting());
+
+  // Releasing a different worklet evicts the first one, since the pool only
+  // holds one worklet.
+  std::unique_ptr<AuctionWorkletManager::WorkletHandle> handle3;
+  base::test::TestFuture<void> worklet_available3;
+  auction_worklet_manager_->RequestBidderWorklet(
+      kAuction3, kOtherBiddingLogicUrl, /*wasm_url=*/std::nullopt,
+      /*trusted_bidding_signals_url=*/std::nullopt,
+      /*needs_cors_for_additional_bid=*/false,
+      /*experiment_group_id=*/std::nullopt,
+      /*trusted_bidding_signals_slot_size_param=*/"",
+      /*trusted_bidding_signals_coordinator=*/std::nullopt,
+      worklet_available3.GetCallback(), NeverInvokedFatalErrorCallback(),
+      handle3,
+      auction_metrics_recorder_manager_->CreateAuctionMetricsRecorder());
+  ASSERT_TRUE(worklet_available3.Wait());
+  std::unique_ptr<MockBidderWorklet> bidder_worklet2 =
+      auction_process_manager_->WaitForBidderWorklet();
+  EXPECT_EQ(kOtherBiddingLogicUrl, bidder_worklet2->script_source_url());
+  EXPECT_EQ(2u, auction_process_manager_->GetBidderProcessCountForTesting());
+  handle3.reset();
+  EXPECT_EQ(1u, auction_worklet_manager_->GetWarmBidderWorkletCountForTesting());
+  EXPECT_EQ(1u, auction_process_manager_->GetBidderProcessCountForTesting());
+
+  // Once the timeout passes, the remaining warm worklet is released, too.
+  task_environment()->FastForwardBy(base::Seconds(10));
+  EXPECT_EQ(0u, auction_worklet_manager_->GetWarmBidderWorkletCountForTesting());
+  EXPECT_EQ(0u, auction_process_manager_->GetBidderProcessCountForTesting());
+}
+
+// Test that warm bidder worklets are released when another bidder worklet has
+// to wait for a process, so they don't hold on to process slots other auctions
+// need.
+TEST_F(AuctionWorkletManagerTest, WarmBidderWorkletsReleasedAtProcessLimit) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeatureWithParameters(
+      features::kFledgeKeepBidderWorkletsWarm,
+      {{"WarmBidderWorkletPoolSize", "1"},
+       {"WarmBidderWorkletTimeout", "10s"}});
+
+  // For proper destruction ordering, `handles` should be after
+  // `bidder_worklets`.
+  std::list<std::unique_ptr<MockBidderWorklet>> bidder_worklets;
+  std::list<std::unique_ptr<AuctionWorkletManager::WorkletHandle>> handles;
+  for (size_t i = 0; i < AuctionProcessManager::kMaxBidderProcesses; ++i) {
+    GURL decision_logic_url =
+        GURL(base::StringPrintf("https://origin%zu.test", i));
+    std::unique_ptr<AuctionWorkletManager::WorkletHandle> handle;
+    base::test::TestFuture<void> worklet_available;
+    auction_worklet_manager_->RequestBidderWorklet(
+        kAuction1, decision_logic_url, /*wasm_url=*/std::nullopt,
+        /*trusted_bidding_signals_url=*/std::nullopt,
+        /*needs_cors_for_additional_bid=*/false,
+        /*experiment_group_id=*/std::nullopt,
+        /*trusted_bidding_signals_slot_size_param=*/"",
+        /*trusted_bidding_signals_coordinator=*/std::nullopt,
+        worklet_available.GetCallback(), NeverInvokedFatalErrorCallback(),
+        handle,
+        auction_metrics_recorder_manager_->CreateAuctionMetricsRecorder());
+    ASSERT_TRUE(worklet_available.Wait());
+    bidder_worklets.emplace_back(
+        auction_process_manager_->WaitForBidderWorklet());
+    handles.emplace_back(std::move(handle));
+  }
+
+  // The first worklet is kept warm, along with its process.
+  handles.pop_front();
+  EXPECT_EQ(1u, auction_worklet_manager_->GetWarmBidderWorkletCountForTesting());
+  EXPECT_EQ(AuctionProcessManager::kMaxBidderProcesses,
+            auction_process_manager_->GetBidderProcessCountForTesting());
+
+  // A request for another origin has to wait for a process, so the warm
+  // worklet is released to make room for it.
+  std::unique_ptr<AuctionWorkletManager::WorkletHandle> handle;
+  base::test::TestFuture<void> worklet_available;
+  auction_worklet_manager_->RequestBidderWorklet(
+      kAuction2, kDecisionLogicUrl, kWasmUrl, kTrustedSignalsUrl,
+      /*needs_cors_for_additional_bid=*/false,
+      /*experiment_group_id=*/std::nullopt,
+      /*trusted_bidding_signals_slot_size_param=*/"",
+      /*trusted_bidding_signals_coordinator=*/std::nullopt,
+      worklet_available.GetCallback(), NeverInvokedFatalErrorCallback(),
+      handle,
+      auction_metrics_recorder_manager_->CreateAuctionMetricsRecorder());
+  EXPECT_EQ(1u, auction_process_manager_->GetPendingBidderRequestsForTesting());
+  ASSERT_TRUE(worklet_available.Wait());
+  EXPECT_EQ(0u, auction_worklet_manager_->GetWarmBidderWorkletCountForTesting());
+  std::unique_ptr<MockBidderWorklet> bidder_worklet =
+      auction_process_manager_->WaitForBidderWorklet();
+  EXPECT_EQ(kDecisionLogicUrl, bidder_worklet->script_source_url());
+
+  // While requests are waiting for a process, released worklets aren't kept
+  // warm.
+  std::unique_ptr<AuctionWorkletManager::WorkletHandle> waiting_handle;
+  base::test::TestFuture<void> waiting_worklet_available;
+  auction_worklet_manager_->RequestBidderWorklet(
+      kAuction3, GURL("https://other-origin.test/script"),
+      /*wasm_url=*/std::nullopt,
+      /*trusted_bidding_signals_url=*/std::nullopt,
+      /*needs_cors_for_additional_bid=*/false,
+      /*experiment_group_id=*/std::nullopt,
+      /*trusted_bidding_signals_slot_size_param=*/"",
+      /*trusted_bidding_signals_coordinator=*/std::nullopt,
+      waiting_worklet_available.GetCallback(),
+      NeverInvokedFatalErrorCallback(), waiting_handle,
+      auction_metrics_recorder_manager_->CreateAuctionMetricsRecorder());
+  EXPECT_EQ(1u, auction_process_manager_->GetPendingBidderRequestsForTesting());
+  handles.pop_front();
+  EXPECT_EQ(0u, auction_worklet_manager_->GetWarmBidderWorkletCountForTesting());
+  ASSERT_TRUE(waiting_worklet_available.Wait());
+}
+
 // Test that requests with the same parameters reuse seller worklets.
 TEST_F(AuctionWorkletManagerTest, ReuseSellerWorklet) {
   // Load a seller worklet.
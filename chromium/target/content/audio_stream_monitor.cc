@@ -4,8 +4,17 @@
 
 #include "content/browser/media/audio_stream_monitor.h"
 
+#include <atomic>
+#include <memory>
+
+#include "base/containers/flat_set.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback_helpers.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/timer/timer.h"
 #include "content/browser/renderer_host/render_frame_host_impl.h"
 #include "content/browser/web_contents/web_contents_impl.h"
 #include "content/public/browser/browser_task_traits.h"
@@ -14,6 +23,10 @@
 
 namespace content {
 
+BASE_FEATURE(kAudioStreamMonitorFrameAggregation,
+             "AudioStreamMonitorFrameAggregation",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 namespace {
 
 AudioStreamMonitor* GetMonitorForRenderFrame(
@@ -25,8 +38,171 @@ AudioStreamMonitor* GetMonitorForRenderFrame(
   return web_contents ? web_contents->audio_stream_monitor() : nullptr;
 }
 
+// Counts the tasks the static AudioStreamMonitor methods post to the UI
+// thread. While any AudioStreamMonitor exists, reports the count for each
+// minute in which there was at least one; the last, partial minute is reported
+// when the last monitor goes away.
+class UIThreadWakeupCounter {
+ public:
+  static UIThreadWakeupCounter& GetInstance() {
+    static base::NoDestructor<UIThreadWakeupCounter> instance;
+    return *instance;
+  }
+
+  // Safe to call from any thread.
+  void OnWakeup() { wakeups_.fetch_add(1, std::memory_order_relaxed); }
+
+  void AddMonitor() {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    if (monitor_count_++ > 0) {
+      return;
+    }
+    report_timer_ = std::make_unique<base::RepeatingTimer>();
+    report_timer_->Start(FROM_HERE, base::Minutes(1),
+                         base::BindRepeating(&UIThreadWakeupCounter::Report,
+                                             base::Unretained(this)));
+  }
+
+  void RemoveMonitor() {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    DCHECK_GT(monitor_count_, 0);
+    if (--monitor_count_ > 0) {
+      return;
+    }
+    report_timer_.reset();
+    Report();
+  }
+
+ private:
+  void Report() {
+    const int wakeups = wakeups_.exchange(0, std::memory_order_relaxed);
+    if (wakeups > 0) {
+      base::UmaHistogramCounts10000(
+          "Media.AudioStreamMonitor.UIThreadWakeupsPerMinute", wakeups);
+    }
+  }
+
+  std::atomic<int> wakeups_{0};
+  // The number of AudioStreamMonitors, which only live on the UI thread.
+  int monitor_count_ = 0;
+  std::unique_ptr<base::RepeatingTimer> report_timer_;
+};
+
 }  // namespace
 
+// Tracks which streams of each frame are audible, on whatever threads the
+// static methods are called from, and posts a task to the UI thread only when a
+// frame goes from having no audible streams to having some, or back. At most
+// one such task is pending per frame; it reports the frame's state at the time
+// it runs, so rapid toggles are coalesced.
+class AudioStreamMonitor::FrameAudibilityAggregator {
+ public:
+  static FrameAudibilityAggregator& GetInstance() {
+    static base::NoDestructor<FrameAudibilityAggregator> instance;
+    return *instance;
+  }
+
+  void UpdateStreamAudibleState(GlobalRenderFrameHostId render_frame_host_id,
+                                int stream_id,
+                                bool is_audible) {
+    {
+      base::AutoLock auto_lock(lock_);
+      auto it = frames_.find(render_frame_host_id);
+      if (it == frames_.end()) {
+        // Silent streams of frames without audible streams need no tracking.
+        if (!is_audible) {
+          return;
+        }
+        it = frames_.emplace(render_frame_host_id, FrameState()).first;
+      }
+      FrameState& state = it->second;
+      if (is_audible) {
+        state.audible_streams.insert(stream_id);
+      } else {
+        state.audible_streams.erase(stream_id);
+      }
+      if (state.notification_pending ||
+          state.IsAudible() == state.notified_audible) {
+        MaybeEraseLocked(it);
+        return;
+      }
+      state.notification_pending = true;
+    }
+
+    UIThreadWakeupCounter::GetInstance().OnWakeup();
+    GetUIThreadTaskRunner({})->PostTask(
+        FROM_HERE,
+        base::BindOnce(&FrameAudibilityAggregator::NotifyOnUIThread,
+                       base::Unretained(this), render_frame_host_id));
+  }
+
+  // Forgets the frames of a renderer process that is gone, or a frame that
+  // was deleted, so that their streams don't leak when their stops are never
+  // reported.
+  void RemoveFramesOfProcess(int render_process_id) {
+    base::AutoLock auto_lock(lock_);
+    base::EraseIf(frames_, [render_process_id](const auto& entry) {
+      return entry.first.child_id == render_process_id;
+    });
+  }
+  void RemoveFrame(GlobalRenderFrameHostId render_frame_host_id) {
+    base::AutoLock auto_lock(lock_);
+    frames_.erase(render_frame_host_id);
+  }
+
+ private:
+  struct FrameState {
+    bool IsAudible() const { return !audible_streams.empty(); }
+
+    base::flat_set<int> audible_streams;
+    // The audibility last sent to the UI thread.
+    bool notified_audible = false;
+    bool notification_pending = false;
+  };
+
+  using FrameMap = base::flat_map<GlobalRenderFrameHostId, FrameState>;
+
+  void NotifyOnUIThread(GlobalRenderFrameHostId render_frame_host_id) {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    bool is_audible;
+    {
+      base::AutoLock auto_lock(lock_);
+      auto it = frames_.find(render_frame_host_id);
+      if (it == frames_.end()) {
+        // The frame or its process went away after this was posted.
+        return;
+      }
+      FrameState& state = it->second;
+      state.notification_pending = false;
+      is_audible = state.IsAudible();
+      if (is_audible == state.notified_audible) {
+        // Toggled back before this task ran.
+        MaybeEraseLocked(it);
+        return;
+      }
+      state.notified_audible = is_audible;
+      MaybeEraseLocked(it);
+    }
+
+    if (AudioStreamMonitor* monitor =
+            GetMonitorForRenderFrame(render_frame_host_id)) {
+      monitor->UpdateFrameAudibleStateOnUIThread(render_frame_host_id,
+                                                 is_audible);
+    }
+  }
+
+  void MaybeEraseLocked(FrameMap::iterator it) EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    const FrameState& state = it->second;
+    if (!state.IsAudible() && !state.notified_audible &&
+        !state.notification_pending) {
+      frames_.erase(it);
+    }
+  }
+
+  base::Lock lock_;
+  FrameMap frames_ GUARDED_BY(lock_);
+};
+
 AudioStreamMonitor::AudibleClientRegistration::AudibleClientRegistration(
     GlobalRenderFrameHostId render_frame_host_id,
     AudioStreamMonitor* audio_stream_monitor)
@@ -52,10 +228,12 @@ bool AudioStreamMonitor::StreamID::operator==(const StreamID& other) const {
 AudioStreamMonitor::AudioStreamMonitor(WebContents* contents)
     : WebContentsObserver(contents), web_contents_(contents) {
   DCHECK(web_contents_);
+  UIThreadWakeupCounter::GetInstance().AddMonitor();
 }
 
 AudioStreamMonitor::~AudioStreamMonitor() {
   DCHECK(audible_clients_.empty());
+  UIThreadWakeupCounter::GetInstance().RemoveMonitor();
 }
 
 bool AudioStreamMonitor::WasRecentlyAudible() const {
@@ -83,6 +261,15 @@ void AudioStreamMonitor::RenderProcessGone(int render_process_id) {
       streams_, [render_process_id](const std::pair<StreamID, bool>& entry) {
         return entry.first.render_frame_host_id.child_id == render_process_id;
       });
+  base::EraseIf(frames_with_audible_streams_,
+                [render_process_id](
+                    const std::pair<GlobalRenderFrameHostId, bool>& entry) {
+                  return entry.first.child_id == render_process_id;
+                });
+  if (base::FeatureList::IsEnabled(kAudioStreamMonitorFrameAggregation)) {
+    FrameAudibilityAggregator::GetInstance().RemoveFramesOfProcess(
+        render_process_id);
+  }
   UpdateStreams();
 }
 
@@ -123,6 +310,11 @@ void AudioStreamMonitor::RemoveAudibleClient(
 void AudioStreamMonitor::StartMonitoringStream(
     GlobalRenderFrameHostId render_frame_host_id,
     int stream_id) {
+  if (base::FeatureList::IsEnabled(kAudioStreamMonitorFrameAggregation)) {
+    // Streams start out silent, which doesn't change their frame's state.
+    return;
+  }
+  UIThreadWakeupCounter::GetInstance().OnWakeup();
   GetUIThreadTaskRunner({})->PostTask(
       FROM_HERE,
       base::BindOnce(
@@ -139,6 +331,12 @@ void AudioStreamMonitor::StartMonitoringStream(
 void AudioStreamMonitor::StopMonitoringStream(
     GlobalRenderFrameHostId render_frame_host_id,
     int stream_id) {
+  if (base::FeatureList::IsEnabled(kAudioStreamMonitorFrameAggregation)) {
+    FrameAudibilityAggregator::GetInstance().UpdateStreamAudibleState(
+        render_frame_host_id, stream_id, /*is_audible=*/false);
+    return;
+  }
+  UIThreadWakeupCounter::GetInstance().OnWakeup();
   GetUIThreadTaskRunner({})->PostTask(
       FROM_HERE,
       base::BindOnce(
@@ -156,6 +354,12 @@ void AudioStreamMonitor::UpdateStreamAudibleState(
     GlobalRenderFrameHostId render_frame_host_id,
     int stream_id,
     bool is_audible) {
+  if (base::FeatureList::IsEnabled(kAudioStreamMonitorFrameAggregation)) {
+    FrameAudibilityAggregator::GetInstance().UpdateStreamAudibleState(
+        render_frame_host_id, stream_id, is_audible);
+    return;
+  }
+  UIThreadWakeupCounter::GetInstance().OnWakeup();
   GetUIThreadTaskRunner({})->PostTask(
       FROM_HERE,
       base::BindOnce(
@@ -198,6 +402,27 @@ void AudioStreamMonitor::UpdateStreamAudibleStateOnUIThread(const StreamID& sid,
   UpdateStreams();
 }
 
+void AudioStreamMonitor::UpdateFrameAudibleStateOnUIThread(
+    GlobalRenderFrameHostId render_frame_host_id,
+    bool is_audible) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  if (is_audible) {
+    frames_with_audible_streams_[render_frame_host_id] = true;
+    UpdateStreams();
+    return;
+  }
+
+  auto it = frames_with_audible_streams_.find(render_frame_host_id);
+  if (it == frames_with_audible_streams_.end()) {
+    return;
+  }
+  // As in StopMonitoringStreamOnUIThread(), keep the frame as silent while
+  // updating so that its RenderFrameHost state is updated too.
+  it->second = false;
+  UpdateStreams();
+  frames_with_audible_streams_.erase(render_frame_host_id);
+}
+
 void AudioStreamMonitor::UpdateStreams() {
   bool was_audible = is_audible_;
   is_audible_ = false;
@@ -205,7 +430,8 @@ void AudioStreamMonitor::UpdateStreams() {
   // Determine whether a RenderFrameHost is audible based on
   // stream and non-stream client states.
   base::flat_map<GlobalRenderFrameHostId, bool> audible_frames;
-  audible_frames.reserve(streams_.size() + audible_clients_.size());
+  audible_frames.reserve(streams_.size() + frames_with_audible_streams_.size() +
+                         audible_clients_.size());
 
   for (auto& kv : streams_) {
     const bool is_stream_audible = kv.second;
@@ -213,6 +439,12 @@ void AudioStreamMonitor::UpdateStreams() {
     audible_frames[kv.first.render_frame_host_id] |= is_stream_audible;
   }
 
+  for (const auto& kv : frames_with_audible_streams_) {
+    const bool is_frame_audible = kv.second;
+    is_audible_ |= is_frame_audible;
+    audible_frames[kv.first] |= is_frame_audible;
+  }
+
   for (auto& kv : audible_clients_) {
     const bool is_client_audible = kv.second > 0;
     is_audible_ |= is_client_audible;
@@ -284,6 +516,11 @@ void AudioStreamMonitor::RenderFrameDeleted(
                               const std::pair<StreamID, bool>& entry) {
     return entry.first.render_frame_host_id == render_frame_host->GetGlobalId();
   });
+  frames_with_audible_streams_.erase(render_frame_host->GetGlobalId());
+  if (base::FeatureList::IsEnabled(kAudioStreamMonitorFrameAggregation)) {
+    FrameAudibilityAggregator::GetInstance().RemoveFrame(
+        render_frame_host->GetGlobalId());
+  }
   UpdateStreams();
 }
 
@@ -6,6 +6,7 @@
 #define CONTENT_BROWSER_MEDIA_AUDIO_STREAM_MONITOR_H_
 
 #include "base/containers/flat_map.h"
+#include "base/feature_list.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/raw_ptr_exclusion.h"
 #include "base/threading/thread_checker.h"
@@ -20,6 +21,11 @@ namespace content {
 
 class WebContents;
 
+// When enabled, per-stream audible state reported through the static
+// AudioStreamMonitor methods is aggregated per frame on the calling thread, and
+// only changes in a frame's audibility are posted to the UI thread.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kAudioStreamMonitorFrameAggregation);
+
 // Keeps track of the audible state of audio output streams and uses it to
 // maintain a "was recently audible" binary state for the audio indicators in
 // the tab UI.  The logic is to: 1) Turn on immediately when sound is audible;
@@ -57,14 +63,18 @@ class CONTENT_EXPORT AudioStreamMonitor : public WebContentsObserver {
   void RenderProcessGone(int render_process_id);
 
   // Starts or stops monitoring respectively for the stream owned by the
-  // specified renderer.  Safe to call from any thread.
+  // specified renderer.  Safe to call from any thread.  With
+  // kAudioStreamMonitorFrameAggregation, only stopping an audible stream
+  // reaches the UI thread.
   static void StartMonitoringStream(
       GlobalRenderFrameHostId render_frame_host_id,
       int stream_id);
   static void StopMonitoringStream(GlobalRenderFrameHostId render_frame_host_id,
                                    int stream_id);
   // Updates the audible state for the given stream. Safe to call from any
-  // thread.
+  // thread. With kAudioStreamMonitorFrameAggregation, the UI thread is only
+  // notified when this changes whether the stream's frame is audible, and
+  // changes made while a notification is pending are coalesced into it.
   static void UpdateStreamAudibleState(
       GlobalRenderFrameHostId render_frame_host_id,
       int stream_id,
@@ -103,6 +113,10 @@ class CONTENT_EXPORT AudioStreamMonitor : public WebContentsObserver {
   friend class AudioStreamMonitorTest;
   friend class AudibleClientRegistration;
 
+  // Process-wide aggregation of stream audibility per frame, used by the
+  // static methods with kAudioStreamMonitorFrameAggregation.
+  class FrameAudibilityAggregator;
+
   enum {
     // Minimum amount of time to hold a tab indicator on after it becomes
     // silent.
@@ -125,6 +139,12 @@ class CONTENT_EXPORT AudioStreamMonitor : public WebContentsObserver {
   // Updates the audible state for the given stream.
   void UpdateStreamAudibleStateOnUIThread(const StreamID& sid, bool is_audible);
 
+  // Updates whether any stream of the given frame is audible. Used instead of
+  // the per-stream methods above with kAudioStreamMonitorFrameAggregation.
+  void UpdateFrameAudibleStateOnUIThread(
+      GlobalRenderFrameHostId render_frame_host_id,
+      bool is_audible);
+
   // Compares last known indicator state with what it should be, and triggers UI
   // updates through |web_contents_| if needed.  When the indicator is turned
   // on, |off_timer_| is started to re-invoke this method in the future.
@@ -146,6 +166,11 @@ class CONTENT_EXPORT AudioStreamMonitor : public WebContentsObserver {
   // streams will have an entry in this map.
   base::flat_map<StreamID, bool> streams_;
 
+  // Frames with audible streams, as reported by the per-frame aggregation of
+  // kAudioStreamMonitorFrameAggregation. Like `streams_`, a frame is briefly
+  // present with a value of false while it becomes silent.
+  base::flat_map<GlobalRenderFrameHostId, bool> frames_with_audible_streams_;
+
   // Map of non-stream audible clients, e.g. players not using AudioServices.
   // size_t is the number of audible clients associated with the
   // GlobalRenderFrameHostId. If size_t count reaches 0 there are no
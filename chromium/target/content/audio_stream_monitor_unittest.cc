@@ -11,6 +11,9 @@
 #include "base/functional/bind.h"
 #include "base/functional/callback_helpers.h"
 #include "base/memory/raw_ptr.h"
+#include "base/run_loop.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/time/time.h"
 #include "content/browser/web_contents/web_contents_impl.h"
 #include "content/public/browser/invalidate_type.h"
@@ -485,4 +488,105 @@ TEST_F(AudioStreamMonitorTest, AudibleClientAndStream) {
   ExpectNotCurrentlyAudible();
 }
 
+// Tests that with kAudioStreamMonitorFrameAggregation, stream updates only
+// reach the UI thread when the frame's audibility changes, and are coalesced
+// while a notification is pending.
+TEST_F(AudioStreamMonitorTest, FrameAggregation) {
+  base::test::ScopedFeatureList feature_list(
+      kAudioStreamMonitorFrameAggregation);
+  const GlobalRenderFrameHostId host_id =
+      web_contents()->GetPrimaryMainFrame()->GetGlobalId();
+  base::RunLoop().RunUntilIdle();
+  // Delayed tasks, like the wakeup report, stay pending throughout.
+  const size_t pending_tasks =
+      task_environment()->GetPendingMainThreadTaskCount();
+
+  // Silent streams don't post anything.
+  AudioStreamMonitor::StartMonitoringStream(host_id, kStreamId);
+  AudioStreamMonitor::StartMonitoringStream(host_id, kAnotherStreamId);
+  AudioStreamMonitor::UpdateStreamAudibleState(host_id, kStreamId, false);
+  EXPECT_EQ(pending_tasks, task_environment()->GetPendingMainThreadTaskCount());
+
+  // Toggling while the first notification is pending is coalesced into it.
+  AudioStreamMonitor::UpdateStreamAudibleState(host_id, kStreamId, true);
+  AudioStreamMonitor::UpdateStreamAudibleState(host_id, kStreamId, false);
+  AudioStreamMonitor::UpdateStreamAudibleState(host_id, kStreamId, true);
+  AudioStreamMonitor::UpdateStreamAudibleState(host_id, kAnotherStreamId, true);
+  EXPECT_EQ(pending_tasks + 1,
+            task_environment()->GetPendingMainThreadTaskCount());
+
+  ExpectRecentlyAudibleChangeNotification(true);
+  ExpectCurrentlyAudibleChangeNotification(true);
+  base::RunLoop().RunUntilIdle();
+  ExpectIsCurrentlyAudible();
+
+  // The frame stays audible while any of its streams is.
+  AudioStreamMonitor::StopMonitoringStream(host_id, kAnotherStreamId);
+  EXPECT_EQ(pending_tasks, task_environment()->GetPendingMainThreadTaskCount());
+  ExpectIsCurrentlyAudible();
+
+  ExpectCurrentlyAudibleChangeNotification(false);
+  AudioStreamMonitor::StopMonitoringStream(host_id, kStreamId);
+  base::RunLoop().RunUntilIdle();
+  ExpectNotCurrentlyAudible();
+}
+
+// Tests that with kAudioStreamMonitorFrameAggregation, the streams of a gone
+// renderer process are forgotten, so its frame isn't considered still audible
+// when the process id's streams are never stopped.
+TEST_F(AudioStreamMonitorTest, FrameAggregationForgetsGoneProcess) {
+  base::test::ScopedFeatureList feature_list(
+      kAudioStreamMonitorFrameAggregation);
+  const GlobalRenderFrameHostId host_id =
+      web_contents()->GetPrimaryMainFrame()->GetGlobalId();
+  base::RunLoop().RunUntilIdle();
+  const size_t pending_tasks =
+      task_environment()->GetPendingMainThreadTaskCount();
+
+  AudioStreamMonitor::StartMonitoringStream(host_id, kStreamId);
+  AudioStreamMonitor::UpdateStreamAudibleState(host_id, kStreamId, true);
+  ExpectRecentlyAudibleChangeNotification(true);
+  ExpectCurrentlyAudibleChangeNotification(true);
+  base::RunLoop().RunUntilIdle();
+  ExpectIsCurrentlyAudible();
+
+  ExpectCurrentlyAudibleChangeNotification(false);
+  monitor_->RenderProcessGone(host_id.child_id);
+  ExpectNotCurrentlyAudible();
+
+  // The frame starts from scratch, so an audible stream is reported again.
+  AudioStreamMonitor::UpdateStreamAudibleState(host_id, kStreamId, true);
+  EXPECT_EQ(pending_tasks + 1,
+            task_environment()->GetPendingMainThreadTaskCount());
+  AudioStreamMonitor::StopMonitoringStream(host_id, kStreamId);
+  base::RunLoop().RunUntilIdle();
+  ExpectNotCurrentlyAudible();
+}
+
+// Tests that the UI thread wakeups are reported once a minute, and that the
+// last, partial minute is reported when the last monitor goes away.
+TEST_F(AudioStreamMonitorTest, ReportsUIThreadWakeups) {
+  constexpr char kWakeupsHistogram[] =
+      "Media.AudioStreamMonitor.UIThreadWakeupsPerMinute";
+  const GlobalRenderFrameHostId host_id =
+      web_contents()->GetPrimaryMainFrame()->GetGlobalId();
+  base::HistogramTester histogram_tester;
+
+  AudioStreamMonitor::StartMonitoringStream(host_id, kStreamId);
+  AudioStreamMonitor::StopMonitoringStream(host_id, kStreamId);
+  FastForwardBy(base::Minutes(1));
+  histogram_tester.ExpectUniqueSample(kWakeupsHistogram, 2, 1);
+
+  // Minutes without wakeups aren't reported.
+  FastForwardBy(base::Minutes(1));
+  histogram_tester.ExpectTotalCount(kWakeupsHistogram, 1);
+
+  AudioStreamMonitor::StartMonitoringStream(host_id, kStreamId);
+  base::RunLoop().RunUntilIdle();
+  monitor_ = nullptr;
+  DeleteContents();
+  histogram_tester.ExpectBucketCount(kWakeupsHistogram, 1, 1);
+  histogram_tester.ExpectTotalCount(kWakeupsHistogram, 2);
+}
+
 }  // namespace content
@@ -8,6 +8,9 @@
 
 #include "base/metrics/field_trial_params.h"
 #include "base/metrics/histogram_functions.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/timer/timer.h"
+#include "content/public/renderer/render_frame_observer_tracker.h"
 #include "content/renderer/render_frame_impl.h"
 #include "third_party/blink/public/web/web_ax_context.h"
 #include "third_party/blink/public/web/web_ax_object.h"
@@ -30,9 +33,107 @@ using ErrorSet = std::set<ui::AXSerializationErrorFlag>;
 
 namespace content {
 
+BASE_FEATURE(kAXTreeSnapshotterReuseContext,
+             "AXTreeSnapshotterReuseContext",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+BASE_FEATURE_PARAM(base::TimeDelta,
+                   kAXTreeSnapshotterReuseContextIdleTimeout,
+                   &kAXTreeSnapshotterReuseContext,
+                   "idle_timeout",
+                   base::Seconds(10));
+
 constexpr char kAXTreeSnapshotterErrorHistogramName[] =
     "Accessibility.AXTreeSnapshotter.Snapshot.Error";
 
+namespace {
+
+// Holds on to the WebAXContext of the last snapshot of a frame until it is
+// either taken by the next snapshotter, the idle timeout expires, or the frame
+// navigates or goes away. Deletes itself when the frame is destroyed.
+class RetainedAXContext
+    : public RenderFrameObserver,
+      public RenderFrameObserverTracker<RetainedAXContext> {
+ public:
+  explicit RetainedAXContext(RenderFrame* render_frame)
+      : RenderFrameObserver(render_frame),
+        RenderFrameObserverTracker<RetainedAXContext>(render_frame) {}
+
+  // Returns the context retained for `render_frame`, or nullptr if there is
+  // none that was created for `ax_mode` and the current document.
+  static std::unique_ptr<WebAXContext> Take(RenderFrame* render_frame,
+                                            ui::AXMode ax_mode) {
+    RetainedAXContext* retained = Get(render_frame);
+    return retained ? retained->TakeContext(ax_mode) : nullptr;
+  }
+
+  static void Retain(RenderFrame* render_frame,
+                     ui::AXMode ax_mode,
+                     std::unique_ptr<WebAXContext> context) {
+    RetainedAXContext* retained = Get(render_frame);
+    if (!retained) {
+      retained = new RetainedAXContext(render_frame);
+    }
+    retained->SetContext(ax_mode, std::move(context));
+  }
+
+  // RenderFrameObserver:
+  void DidCommitProvisionalLoad(ui::PageTransition transition) override {
+    ReleaseContext();
+  }
+  void OnDestruct() override { delete this; }
+
+ private:
+  std::unique_ptr<WebAXContext> TakeContext(ui::AXMode ax_mode) {
+    release_timer_.Stop();
+    if (!context_) {
+      return nullptr;
+    }
+    RecordRetainedDuration();
+    if (ax_mode_ != ax_mode || !context_->HasActiveDocument()) {
+      context_.reset();
+      return nullptr;
+    }
+    return std::move(context_);
+  }
+
+  void SetContext(ui::AXMode ax_mode, std::unique_ptr<WebAXContext> context) {
+    if (context_) {
+      RecordRetainedDuration();
+    }
+    ax_mode_ = ax_mode;
+    context_ = std::move(context);
+    retained_time_ = base::TimeTicks::Now();
+    release_timer_.Start(FROM_HERE,
+                         kAXTreeSnapshotterReuseContextIdleTimeout.Get(),
+                         base::BindOnce(&RetainedAXContext::ReleaseContext,
+                                        base::Unretained(this)));
+  }
+
+  void ReleaseContext() {
+    release_timer_.Stop();
+    if (context_) {
+      RecordRetainedDuration();
+      context_.reset();
+    }
+  }
+
+  // Records how long `context_` was held before it was taken or dropped, which
+  // is capped by the idle timeout and shows how much of it is actually used.
+  void RecordRetainedDuration() {
+    base::UmaHistogramMediumTimes(
+        "Accessibility.AXTreeSnapshotter.RetainedContext.Duration",
+        base::TimeTicks::Now() - retained_time_);
+  }
+
+  ui::AXMode ax_mode_;
+  std::unique_ptr<WebAXContext> context_;
+  base::TimeTicks retained_time_;
+  base::OneShotTimer release_timer_;
+};
+
+}  // namespace
+
 // These values are persisted to logs. Entries should not be renumbered and
 // numeric values should never be reused.
 //
@@ -55,13 +156,26 @@ AXTreeSnapshotterImpl::AXTreeSnapshotterImpl(RenderFrameImpl* render_frame,
   // Do not generate inline textboxes, which are expensive to create and just
   // present extra noise to snapshot consumers.
   ax_mode.set_mode(ui::AXMode::kInlineTextBoxes, false);
+  ax_mode_ = ax_mode;
 
   CHECK(render_frame->GetWebFrame());
-  blink::WebDocument document_ = render_frame->GetWebFrame()->GetDocument();
-  context_ = std::make_unique<WebAXContext>(document_, ax_mode);
+  if (base::FeatureList::IsEnabled(kAXTreeSnapshotterReuseContext)) {
+    context_ = RetainedAXContext::Take(render_frame, ax_mode_);
+    base::UmaHistogramBoolean(
+        "Accessibility.AXTreeSnapshotter.Snapshot.ContextReused", !!context_);
+  }
+  if (!context_) {
+    blink::WebDocument document_ = render_frame->GetWebFrame()->GetDocument();
+    context_ = std::make_unique<WebAXContext>(document_, ax_mode_);
+  }
 }
 
-AXTreeSnapshotterImpl::~AXTreeSnapshotterImpl() = default;
+AXTreeSnapshotterImpl::~AXTreeSnapshotterImpl() {
+  if (context_ && render_frame() &&
+      base::FeatureList::IsEnabled(kAXTreeSnapshotterReuseContext)) {
+    RetainedAXContext::Retain(render_frame(), ax_mode_, std::move(context_));
+  }
+}
 
 void AXTreeSnapshotterImpl::Snapshot(size_t max_node_count,
                                      base::TimeDelta timeout,
@@ -112,10 +226,13 @@ bool AXTreeSnapshotterImpl::SerializeTreeWithLimits(
     base::TimeDelta timeout,
     ui::AXTreeUpdate* response) {
   ErrorSet out_error;
+  base::ElapsedTimer timer;
   if (!context_->SerializeEntireTree(max_node_count, timeout, response,
                                      &out_error)) {
     return false;
   }
+  base::UmaHistogramTimes("Accessibility.AXTreeSnapshotter.Snapshot.Time",
+                          timer.Elapsed());
 
   ErrorSet::iterator max_nodes_iter =
       out_error.find(ui::AXSerializationErrorFlag::kMaxNodesReached);
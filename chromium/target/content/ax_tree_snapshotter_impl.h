@@ -7,9 +7,13 @@
 
 #include <memory>
 
+#include "base/feature_list.h"
+#include "base/metrics/field_trial_params.h"
 #include "base/time/time.h"
+#include "content/common/content_export.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
+#include "ui/accessibility/ax_mode.h"
 #include "ui/accessibility/ax_tree_update_forward.h"
 
 namespace blink {
@@ -20,6 +24,19 @@ namespace content {
 
 class RenderFrameImpl;
 
+// When enabled, the accessibility context of a snapshot is kept alive for a
+// short time after the snapshot completes, so that further snapshots of the
+// same document reuse its accessibility object cache rather than rebuilding
+// the whole tree.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kAXTreeSnapshotterReuseContext);
+
+// How long a context is kept after the last snapshot. Keeping accessibility
+// enabled makes Blink maintain the object cache on every DOM change, so this
+// should only cover bursts of snapshot requests.
+CONTENT_EXPORT BASE_DECLARE_FEATURE_PARAM(
+    base::TimeDelta,
+    kAXTreeSnapshotterReuseContextIdleTimeout);
+
 class AXTreeSnapshotterImpl : public AXTreeSnapshotter,
                               public content::RenderFrameObserver {
  public:
@@ -39,6 +56,8 @@ class AXTreeSnapshotterImpl : public AXTreeSnapshotter,
                                base::TimeDelta timeout,
                                ui::AXTreeUpdate* response);
 
+  // The mode `context_` was created with.
+  ui::AXMode ax_mode_;
   std::unique_ptr<blink::WebAXContext> context_;
 
   AXTreeSnapshotterImpl(const AXTreeSnapshotterImpl&) = delete;
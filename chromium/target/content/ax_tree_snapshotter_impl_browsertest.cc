@@ -0,0 +1,99 @@
+// Copyright 2025 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/renderer/accessibility/ax_tree_snapshotter_impl.h"
+
+#include "base/run_loop.h"
+#include "base/task/single_thread_task_runner.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/time/time.h"
+#include "content/public/test/render_view_test.h"
+#include "content/renderer/render_frame_impl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/accessibility/ax_mode.h"
+#include "ui/accessibility/ax_tree_update.h"
+
+namespace content {
+
+namespace {
+
+constexpr char kContextReusedHistogram[] =
+    "Accessibility.AXTreeSnapshotter.Snapshot.ContextReused";
+constexpr char kRetainedDurationHistogram[] =
+    "Accessibility.AXTreeSnapshotter.RetainedContext.Duration";
+
+class AXTreeSnapshotterImplTest : public RenderViewTest {
+ public:
+  AXTreeSnapshotterImplTest() {
+    feature_list_.InitAndEnableFeatureWithParameters(
+        kAXTreeSnapshotterReuseContext, {{"idle_timeout", "100ms"}});
+  }
+
+  AXTreeSnapshotterImplTest(const AXTreeSnapshotterImplTest&) = delete;
+  AXTreeSnapshotterImplTest& operator=(const AXTreeSnapshotterImplTest&) =
+      delete;
+
+  ~AXTreeSnapshotterImplTest() override = default;
+
+ protected:
+  // Takes a snapshot of the main frame with a new snapshotter, which retains
+  // its context for the next one when it goes away.
+  void TakeSnapshot() {
+    AXTreeSnapshotterImpl snapshotter(
+        static_cast<RenderFrameImpl*>(GetMainRenderFrame()),
+        ui::kAXModeComplete);
+    ui::AXTreeUpdate snapshot;
+    snapshotter.Snapshot(/*max_node_count=*/0, /*timeout=*/{}, &snapshot);
+    EXPECT_FALSE(snapshot.nodes.empty());
+  }
+
+  void RunFor(base::TimeDelta delay) {
+    base::RunLoop run_loop;
+    base::SingleThreadTaskRunner::GetCurrentDefault()->PostDelayedTask(
+        FROM_HERE, run_loop.QuitClosure(), delay);
+    run_loop.Run();
+  }
+
+  base::test::ScopedFeatureList feature_list_;
+  base::HistogramTester histogram_tester_;
+};
+
+TEST_F(AXTreeSnapshotterImplTest, ReusesContextForNextSnapshot) {
+  LoadHTML("<p>Hello</p>");
+
+  TakeSnapshot();
+  histogram_tester_.ExpectUniqueSample(kContextReusedHistogram, false, 1);
+  histogram_tester_.ExpectTotalCount(kRetainedDurationHistogram, 0);
+
+  TakeSnapshot();
+  histogram_tester_.ExpectBucketCount(kContextReusedHistogram, true, 1);
+  histogram_tester_.ExpectTotalCount(kRetainedDurationHistogram, 1);
+}
+
+TEST_F(AXTreeSnapshotterImplTest, ReleasesContextOnNavigation) {
+  LoadHTML("<p>Hello</p>");
+  TakeSnapshot();
+
+  LoadHTML("<p>World</p>");
+  histogram_tester_.ExpectTotalCount(kRetainedDurationHistogram, 1);
+
+  TakeSnapshot();
+  histogram_tester_.ExpectUniqueSample(kContextReusedHistogram, false, 2);
+}
+
+TEST_F(AXTreeSnapshotterImplTest, ReleasesContextAfterIdleTimeout) {
+  LoadHTML("<p>Hello</p>");
+  TakeSnapshot();
+
+  RunFor(base::Milliseconds(200));
+  histogram_tester_.ExpectTotalCount(kRetainedDurationHistogram, 1);
+
+  TakeSnapshot();
+  histogram_tester_.ExpectUniqueSample(kContextReusedHistogram, false, 2);
+}
+
+}  // namespace
+
+}  // namespace content
@@ -15,9 +15,13 @@
 #include "base/check.h"
 #include "base/containers/contains.h"
 #include "base/containers/enum_set.h"
+#include "base/containers/flat_set.h"
 #include "base/functional/bind.h"
+#include "base/memory/memory_pressure_monitor.h"
 #include "base/memory/weak_ptr.h"
 #include "base/metrics/field_trial_params.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/process/process.h"
 #include "base/rand_util.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
@@ -50,6 +54,8 @@
 #include "net/http/http_request_headers.h"
 #include "net/http/http_status_code.h"
 #include "services/metrics/public/cpp/ukm_source_id.h"
+#include "services/resource_coordinator/public/cpp/memory_instrumentation/global_memory_dump.h"
+#include "services/resource_coordinator/public/cpp/memory_instrumentation/memory_instrumentation.h"
 #include "third_party/blink/public/common/features.h"
 #include "third_party/blink/public/common/scheduler/web_scheduler_tracked_feature.h"
 #include "third_party/blink/public/mojom/back_forward_cache_not_restored_reasons.mojom.h"
@@ -79,6 +85,22 @@ const base::FeatureParam<int> kBackForwardCacheSizeCacheSize{
 const base::FeatureParam<int> kBackForwardCacheSizeForegroundCacheSize{
     &kBackForwardCacheSize, "foreground_cache_size", 0};
 
+BASE_FEATURE(kBackForwardCacheMemoryBudget,
+             "BackForwardCacheMemoryBudget",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+// The memory budget of the cache when there is no memory pressure.
+const base::FeatureParam<int> kBackForwardCacheMemoryBudgetMB{
+    &kBackForwardCacheMemoryBudget, "budget_mb", 512};
+// The percentage of the budget available under moderate memory pressure.
+const base::FeatureParam<int>
+    kBackForwardCacheMemoryBudgetModeratePressurePercent{
+        &kBackForwardCacheMemoryBudget, "moderate_pressure_percent", 50};
+// How often the private memory footprints of the processes are sampled while
+// the cache holds entries.
+const base::FeatureParam<base::TimeDelta>
+    kBackForwardCacheMemoryBudgetSamplingInterval{
+        &kBackForwardCacheMemoryBudget, "sampling_interval", base::Seconds(30)};
+
 namespace {
 
 using blink::scheduler::WebSchedulerTrackedFeature;
@@ -597,6 +619,11 @@ BackForwardCacheImpl::BackForwardCacheImpl(BrowserContext* browser_context)
               browser_context) &&
       GetCacheControlNoStoreLevel() >
           CacheControlNoStoreExperimentLevel::kDoNotStore;
+  if (base::FeatureList::IsEnabled(kBackForwardCacheMemoryBudget)) {
+    memory_pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+        FROM_HERE, base::BindRepeating(&BackForwardCacheImpl::OnMemoryPressure,
+                                       base::Unretained(this)));
+  }
 }
 
 BackForwardCacheImpl::~BackForwardCacheImpl() {
@@ -657,6 +684,25 @@ size_t BackForwardCacheImpl::GetCacheSize() {
       features::kBackForwardCache, "cache_size", kDefaultBackForwardCacheSize);
 }
 
+// static
+uint64_t BackForwardCacheImpl::GetMemoryBudget(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  const uint64_t budget =
+      static_cast<uint64_t>(std::max(0, kBackForwardCacheMemoryBudgetMB.Get()))
+      << 20;
+  int percent = 100;
+  switch (memory_pressure_level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      percent = kBackForwardCacheMemoryBudgetModeratePressurePercent.Get();
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      return 0;
+  }
+  return budget * std::clamp(percent, 0, 100) / 100;
+}
+
 // static
 size_t BackForwardCacheImpl::GetForegroundedEntriesCacheSize() {
   if (!IsBackForwardCacheEnabled())
@@ -1227,6 +1273,9 @@ void BackForwardCacheImpl::StoreEntry(
   entry->SetStoredPageDelegate(this);
   entries_.push_front(std::move(entry));
   AddProcessesForEntry(*entries_.front());
+  if (base::FeatureList::IsEnabled(kBackForwardCacheMemoryBudget)) {
+    StartSamplingProcessMemoryFootprints();
+  }
   EnforceCacheSizeLimit();
 }
 
@@ -1246,6 +1295,204 @@ void BackForwardCacheImpl::EnforceCacheSizeLimit() {
   }
   EnforceCacheSizeLimitInternal(
       GetCacheSize(), BackForwardCacheMetrics::NotRestoredReason::kCacheLimit);
+  if (base::FeatureList::IsEnabled(kBackForwardCacheMemoryBudget)) {
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level =
+        base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE;
+    if (auto* monitor = base::MemoryPressureMonitor::Get()) {
+      memory_pressure_level = monitor->GetCurrentPressureLevel();
+    }
+    EnforceMemoryBudget(memory_pressure_level);
+  }
+}
+
+void BackForwardCacheImpl::EnforceMemoryBudget(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  const uint64_t budget = GetMemoryBudget(memory_pressure_level);
+  if (budget == 0) {
+    // Nothing fits, so skip measuring the processes, which under critical
+    // memory pressure is work the browser can do without.
+    for (std::unique_ptr<Entry>& entry : entries_) {
+      if (!entry->render_frame_host()->is_evicted_from_back_forward_cache() &&
+          AllRenderViewHostsReceivedAckFromRenderer(*entry)) {
+        entry->render_frame_host()->EvictFromBackForwardCacheWithReason(
+            BackForwardCacheMetrics::NotRestoredReason::kCacheLimit);
+      }
+    }
+    return;
+  }
+
+  struct Candidate {
+    raw_ptr<Entry> entry;
+    uint64_t footprint;
+    uint64_t eviction_cost;
+  };
+  std::map<const Entry*, uint64_t> footprints = EstimateEntryMemoryFootprints();
+  std::vector<Candidate> candidates;
+  uint64_t total_footprint = 0;
+  uint64_t recency_rank = 0;
+  for (std::unique_ptr<Entry>& entry : entries_) {
+    auto it = footprints.find(entry.get());
+    if (it == footprints.end()) {
+      continue;
+    }
+    total_footprint += it->second;
+    entry->estimated_memory_footprint_ = it->second;
+    // Like `EnforceCacheSizeLimitInternal()`, wait for the acknowledgements
+    // before evicting the entry; this is called again once they are received.
+    if (!AllRenderViewHostsReceivedAckFromRenderer(*entry)) {
+      continue;
+    }
+    // `entries_` is ordered from the most recently used, and an entry is less
+    // likely to be restored the further it is from the current entry. Use the
+    // recency rank as the inverse of the restore likelihood, so that the
+    // entries holding the most memory per expected restore go first.
+    candidates.push_back(
+        {entry.get(), it->second, it->second * ++recency_rank});
+  }
+  base::UmaHistogramMemoryMB("BackForwardCache.MemoryBudget.EstimatedCacheSize",
+                             total_footprint >> 20);
+  if (total_footprint <= budget) {
+    return;
+  }
+
+  std::ranges::sort(candidates, std::ranges::greater(),
+                    &Candidate::eviction_cost);
+  for (const Candidate& candidate : candidates) {
+    if (total_footprint <= budget) {
+      break;
+    }
+    base::UmaHistogramMemoryMB(
+        "BackForwardCache.MemoryBudget.EvictedEntrySize",
+        candidate.footprint >> 20);
+    candidate.entry->render_frame_host()->EvictFromBackForwardCacheWithReason(
+        BackForwardCacheMetrics::NotRestoredReason::kCacheLimit);
+    total_footprint -= candidate.footprint;
+  }
+}
+
+std::map<const BackForwardCacheImpl::Entry*, uint64_t>
+BackForwardCacheImpl::EstimateEntryMemoryFootprints() {
+  std::map<const Entry*, base::flat_set<RenderProcessHost*>> entry_processes;
+  std::map<RenderProcessHost*, size_t> entry_count_per_process;
+  for (std::unique_ptr<Entry>& entry : entries_) {
+    if (entry->render_frame_host()->is_evicted_from_back_forward_cache()) {
+      continue;
+    }
+    base::flat_set<RenderProcessHost*>& processes =
+        entry_processes[entry.get()];
+    for (const auto& rvh : entry->render_view_hosts()) {
+      RenderProcessHost* process = rvh->GetProcess();
+      if (process->GetPriority() == base::Process::Priority::kBestEffort &&
+          processes.insert(process).second) {
+        ++entry_count_per_process[process];
+      }
+    }
+  }
+
+  std::map<const Entry*, uint64_t> footprints;
+  for (const auto& [entry, processes] : entry_processes) {
+    uint64_t footprint = 0;
+    for (RenderProcessHost* process : processes) {
+      // A process that has not been sampled yet is attributed nothing until
+      // the next sample.
+      const base::Process& os_process = process->GetProcess();
+      if (!os_process.IsValid()) {
+        continue;
+      }
+      auto it = sampled_process_footprints_.find(os_process.Pid());
+      if (it != sampled_process_footprints_.end()) {
+        footprint += it->second / entry_count_per_process[process];
+      }
+    }
+    footprints[entry] = footprint;
+  }
+  return footprints;
+}
+
+void BackForwardCacheImpl::StartSamplingProcessMemoryFootprints() {
+  if (memory_sampling_timer_.IsRunning()) {
+    return;
+  }
+  // Sample right away so that the processes of the first entries are not
+  // left unattributed for a whole interval.
+  SampleProcessMemoryFootprints();
+  memory_sampling_timer_.Start(
+      FROM_HERE, kBackForwardCacheMemoryBudgetSamplingInterval.Get(),
+      base::BindRepeating(&BackForwardCacheImpl::OnMemorySamplingTimer,
+                          base::Unretained(this)));
+}
+
+void BackForwardCacheImpl::OnMemorySamplingTimer() {
+  if (entries_.empty()) {
+    // Nothing to attribute the samples to; sampling resumes with the next
+    // stored entry.
+    memory_sampling_timer_.Stop();
+    sampled_process_footprints_.clear();
+    return;
+  }
+  SampleProcessMemoryFootprints();
+}
+
+void BackForwardCacheImpl::SampleProcessMemoryFootprints() {
+  if (process_memory_footprint_for_testing_) {
+    sampled_process_footprints_.clear();
+    for (RenderProcessHost::iterator it = RenderProcessHost::AllHostsIterator();
+         !it.IsAtEnd(); it.Advance()) {
+      RenderProcessHost* process = it.GetCurrentValue();
+      if (process->GetProcess().IsValid()) {
+        sampled_process_footprints_[process->GetProcess().Pid()] =
+            process_memory_footprint_for_testing_.Run(process);
+      }
+    }
+    return;
+  }
+
+  auto* instrumentation =
+      memory_instrumentation::MemoryInstrumentation::GetInstance();
+  if (!instrumentation) {
+    // The memory instrumentation service is not running in unit tests.
+    return;
+  }
+  instrumentation->RequestPrivateMemoryFootprint(
+      base::kNullProcessId,
+      base::BindOnce(&BackForwardCacheImpl::OnProcessMemoryFootprintsSampled,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void BackForwardCacheImpl::OnProcessMemoryFootprintsSampled(
+    bool success,
+    std::unique_ptr<memory_instrumentation::GlobalMemoryDump> dump) {
+  if (!success || !dump) {
+    // Keep the previous samples rather than attributing nothing.
+    return;
+  }
+  sampled_process_footprints_.clear();
+  for (const auto& process_dump : dump->process_dumps()) {
+    sampled_process_footprints_[process_dump.pid()] =
+        static_cast<uint64_t>(process_dump.os_dump().private_footprint_kb)
+        << 10;
+  }
+  // Entries stored since the last sample were checked against stale
+  // footprints, so check the budget again.
+  EnforceCacheSizeLimit();
+}
+
+void BackForwardCacheImpl::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  switch (memory_pressure_level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      return;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      // Trim the cache down to the reduced budget, evicting the entries that
+      // cost the most memory per expected restore first.
+      EnforceMemoryBudget(memory_pressure_level);
+      return;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      // There is no budget under critical pressure, so this empties the cache
+      // without measuring any process.
+      EnforceMemoryBudget(memory_pressure_level);
+      return;
+  }
 }
 
 void BackForwardCacheImpl::Prune(size_t limit) {
@@ -1327,6 +1574,15 @@ std::unique_ptr<BackForwardCacheImpl::Entry> BackForwardCacheImpl::RestoreEntry(
           ->is_evicted_from_back_forward_cache())
     return nullptr;
 
+  if (std::optional<uint64_t> footprint =
+          (*matching_entry)->estimated_memory_footprint_) {
+    // Together with "EvictedEntrySize", this tells how many restores the
+    // memory held by the cache buys. This reuses the estimate of the last
+    // `EnforceMemoryBudget()` to keep measuring processes off the restore path.
+    base::UmaHistogramMemoryMB(
+        "BackForwardCache.MemoryBudget.RestoredEntrySize", *footprint >> 20);
+  }
+
   std::unique_ptr<Entry> entry = std::move(*matching_entry);
   TRACE_EVENT_INSTANT("navigation",
                       "BackForwardCache::RestoreEntry_matched_entry", "entry",
@@ -6,17 +6,24 @@
 #define CONTENT_BROWSER_RENDERER_HOST_BACK_FORWARD_CACHE_IMPL_H_
 
 #include <list>
+#include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <unordered_set>
 
+#include "base/containers/flat_map.h"
 #include "base/feature_list.h"
+#include "base/functional/callback.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/raw_ref.h"
 #include "base/memory/weak_ptr.h"
+#include "base/process/process_handle.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "base/types/expected.h"
 #include "content/browser/renderer_host/back_forward_cache_can_store_document_result.h"
 #include "content/browser/renderer_host/back_forward_cache_metrics.h"
@@ -39,6 +46,10 @@
 #include "third_party/perfetto/include/perfetto/tracing/traced_value_forward.h"
 #include "url/gurl.h"
 
+namespace memory_instrumentation {
+class GlobalMemoryDump;
+}  // namespace memory_instrumentation
+
 namespace content {
 
 class RenderFrameHostImpl;
@@ -69,6 +80,17 @@ CONTENT_EXPORT extern const base::FeatureParam<int>
 CONTENT_EXPORT extern const base::FeatureParam<int>
     kBackForwardCacheSizeForegroundCacheSize;
 
+// In addition to the entry count limits, evicts entries when the estimated
+// memory held by the cached pages exceeds a budget, which shrinks under memory
+// pressure.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kBackForwardCacheMemoryBudget);
+CONTENT_EXPORT extern const base::FeatureParam<int>
+    kBackForwardCacheMemoryBudgetMB;
+CONTENT_EXPORT extern const base::FeatureParam<int>
+    kBackForwardCacheMemoryBudgetModeratePressurePercent;
+CONTENT_EXPORT extern const base::FeatureParam<base::TimeDelta>
+    kBackForwardCacheMemoryBudgetSamplingInterval;
+
 // When a prioritized BFCache entry needs to be evicted, it will be kept
 // in the cache instead. Only the latest prioritized entry outside the limit
 // will be handled in this way.
@@ -205,6 +227,10 @@ class CONTENT_EXPORT BackForwardCacheImpl
     friend class BackForwardCacheImpl;
 
     std::unique_ptr<StoredPage> stored_page_;
+
+    // The memory footprint estimated by the last `EnforceMemoryBudget()`, so
+    // that restoring the entry does not measure its processes again.
+    std::optional<uint64_t> estimated_memory_footprint_;
   };
 
   explicit BackForwardCacheImpl(BrowserContext* browser_context);
@@ -355,6 +381,13 @@ class CONTENT_EXPORT BackForwardCacheImpl
   // Gets the maximum number of entries the BackForwardCache can hold per tab.
   static size_t GetCacheSize();
 
+  // Gets the maximum estimated memory, in bytes, that the entries of the
+  // BackForwardCache can hold per tab under `memory_pressure_level`. This is
+  // zero under critical memory pressure. Only used when
+  // `kBackForwardCacheMemoryBudget` is enabled.
+  static uint64_t GetMemoryBudget(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
   // The back-forward cache is experimented on a limited set of URLs. This
   // method returns true if the |url| matches one of those. URL not matching
   // this won't enter the back-forward cache. This can still return true even
@@ -392,6 +425,19 @@ class CONTENT_EXPORT BackForwardCacheImpl
     task_runner_for_testing_ = task_runner;
   }
 
+  // Overrides the private memory footprint the memory budget attributes to
+  // backgrounded renderer processes. The override is read synchronously by
+  // `SampleProcessMemoryFootprintsForTesting()` and the sampling timer.
+  void SetProcessMemoryFootprintForTesting(
+      base::RepeatingCallback<uint64_t(RenderProcessHost*)> callback) {
+    process_memory_footprint_for_testing_ = std::move(callback);
+  }
+
+  // Refreshes the sampled process footprints without waiting for the timer.
+  void SampleProcessMemoryFootprintsForTesting() {
+    SampleProcessMemoryFootprints();
+  }
+
   const std::list<std::unique_ptr<Entry>>& GetEntries();
   std::list<Entry*> GetEntriesForRenderViewHostImpl(
       const RenderViewHostImpl* rvhi) const;
@@ -525,6 +571,35 @@ class CONTENT_EXPORT BackForwardCacheImpl
       size_t limit,
       BackForwardCacheMetrics::NotRestoredReason reason);
 
+  // Evicts entries until the estimated memory of the cache is within
+  // `GetMemoryBudget(memory_pressure_level)`. Entries holding the most memory
+  // relative to their likelihood of being restored are evicted first.
+  void EnforceMemoryBudget(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  // Returns the estimated private memory footprint of each non-evicted entry,
+  // based on the last process footprints sampled by
+  // `SampleProcessMemoryFootprints()`. The footprint of a renderer process is
+  // split evenly between the entries using it. Foregrounded processes also
+  // host visible content, so they are not attributed to the cache.
+  std::map<const Entry*, uint64_t> EstimateEntryMemoryFootprints();
+
+  // Starts sampling process footprints periodically while the cache holds
+  // entries. Measuring a process is too slow to do on the UI thread each time
+  // an entry is stored, so the memory budget works off these samples.
+  void StartSamplingProcessMemoryFootprints();
+  void OnMemorySamplingTimer();
+
+  // Asynchronously requests the private memory footprint of every process
+  // from the memory instrumentation service, which measures them off the UI
+  // thread.
+  void SampleProcessMemoryFootprints();
+  void OnProcessMemoryFootprintsSampled(
+      bool success,
+      std::unique_ptr<memory_instrumentation::GlobalMemoryDump> dump);
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
   // Updates |process_to_entry_map_| with processes from |entry|. These must
   // be called after adding or removing an entry in |entries_|.
   void AddProcessesForEntry(Entry& entry);
@@ -556,6 +631,9 @@ class CONTENT_EXPORT BackForwardCacheImpl
   // RenderViewHost in the Entry and so will be valid.
   std::multiset<RenderProcessHost*> observed_processes_;
 
+  // Only set when `kBackForwardCacheMemoryBudget` is enabled.
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
   // Whether the BackForwardCache has been enabled for pages loaded with
   // "Cache-Control: no-store" header.
   bool should_allow_storing_pages_with_cache_control_no_store_;
@@ -568,6 +646,17 @@ class CONTENT_EXPORT BackForwardCacheImpl
   // browser tests and for timing control.
   scoped_refptr<base::SingleThreadTaskRunner> task_runner_for_testing_;
 
+  base::RepeatingCallback<uint64_t(RenderProcessHost*)>
+      process_memory_footprint_for_testing_;
+
+  // Only runs while `kBackForwardCacheMemoryBudget` is enabled and the cache
+  // holds entries.
+  base::RepeatingTimer memory_sampling_timer_;
+
+  // The private memory footprint in bytes of each process, as of the last
+  // sample.
+  base::flat_map<base::ProcessId, uint64_t> sampled_process_footprints_;
+
   // To enter the back-forward cache, the main document URL's must match one of
   // the field trial parameter "allowed_websites". This is represented here by a
   // set of host and path prefix. When |allowed_urls_| is empty, it means there
@@ -234,4 +234,30 @@ TEST_F(BackForwardCacheDefaultSizeTest, DefaultCacheSize) {
   EXPECT_FALSE(BackForwardCacheImpl::UsingForegroundBackgroundCacheSizeLimit());
 }
 
+// Covers the memory budget configured by `kBackForwardCacheMemoryBudget`.
+class BackForwardCacheMemoryBudgetTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    feature_list_.InitAndEnableFeatureWithParameters(
+        kBackForwardCacheMemoryBudget,
+        {{"budget_mb", "100"}, {"moderate_pressure_percent", "40"}});
+  }
+
+ private:
+  base::test::ScopedFeatureList feature_list_;
+};
+
+TEST_F(BackForwardCacheMemoryBudgetTest, BudgetShrinksUnderMemoryPressure) {
+  constexpr uint64_t kMB = 1024 * 1024;
+  EXPECT_EQ(BackForwardCacheImpl::GetMemoryBudget(
+                base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE),
+            100 * kMB);
+  EXPECT_EQ(BackForwardCacheImpl::GetMemoryBudget(
+                base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE),
+            40 * kMB);
+  EXPECT_EQ(BackForwardCacheImpl::GetMemoryBudget(
+                base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL),
+            0u);
+}
+
 }  // namespace content
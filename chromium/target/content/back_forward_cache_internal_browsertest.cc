@@ -8,6 +8,7 @@
 #include "base/metrics/metrics_hashes.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/test/bind.h"
+#include "base/test/metrics/histogram_tester.h"
 #include "base/test/test_mock_time_task_runner.h"
 #include "base/types/expected.h"
 #include "build/build_config.h"
@@ -4126,6 +4127,85 @@ IN_PROC_BROWSER_TEST_F(
   }
 }
 
+class BackForwardCacheMemoryBudgetBrowserTest
+    : public BackForwardCacheBrowserTest {
+ protected:
+  void SetUpCommandLine(base::CommandLine* command_line) override {
+    // Keep the entry count limit out of the way of the memory budget.
+    EnableFeatureAndSetParams(features::kBackForwardCache, "cache_size", "8");
+    EnableFeatureAndSetParams(kBackForwardCacheMemoryBudget, "budget_mb",
+                              base::NumberToString(kBudgetMB));
+    BackForwardCacheBrowserTest::SetUpCommandLine(command_line);
+  }
+
+  void SetUpOnMainThread() override {
+    BackForwardCacheBrowserTest::SetUpOnMainThread();
+    web_contents()
+        ->GetController()
+        .GetBackForwardCache()
+        .SetProcessMemoryFootprintForTesting(base::BindLambdaForTesting(
+            [this](RenderProcessHost* process) -> uint64_t {
+              auto it = footprints_mb_.find(process);
+              return it == footprints_mb_.end() ? 0 : it->second << 20;
+            }));
+  }
+
+  // Navigates to a new site and reports `footprint_mb` for its process.
+  void NavigateToSiteWithFootprint(size_t site, uint64_t footprint_mb) {
+    // Note: do NOT use .com domains here because a4.com is on the HSTS preload
+    // list, which will cause our test requests to timeout.
+    GURL url(embedded_test_server()->GetURL(
+        base::StringPrintf("a%zu.test", site), "/title1.html"));
+    ASSERT_TRUE(NavigateToURL(shell(), url));
+    footprints_mb_[current_frame_host()->GetProcess()] = footprint_mb;
+    // Stand in for the periodic sample, which would otherwise pick up the new
+    // footprint only after the next navigation stores this page.
+    web_contents()
+        ->GetController()
+        .GetBackForwardCache()
+        .SampleProcessMemoryFootprintsForTesting();
+  }
+
+  static constexpr int kBudgetMB = 8;
+
+ private:
+  std::map<RenderProcessHost*, uint64_t> footprints_mb_;
+};
+
+// Test that filling the cache past the memory budget evicts the entry holding
+// the most memory relative to its recency, rather than the oldest one.
+IN_PROC_BROWSER_TEST_F(BackForwardCacheMemoryBudgetBrowserTest,
+                       EvictsEntriesOverBudget) {
+  ASSERT_TRUE(embedded_test_server()->Start());
+  base::HistogramTester histogram_tester;
+
+  std::vector<RenderFrameHostImplWrapper> rfhs;
+  const uint64_t kFootprintsMB[] = {1, 6, 3, 1};
+  for (size_t i = 0; i < std::size(kFootprintsMB); ++i) {
+    SCOPED_TRACE(i);
+    NavigateToSiteWithFootprint(i, kFootprintsMB[i]);
+    rfhs.emplace_back(current_frame_host());
+  }
+
+  // With a3 active, the cache holds 1 + 6 + 3 = 10 MB. Scaled by recency, a1
+  // costs 6 * 2, more than a2 (3 * 1) and a0 (1 * 3), so only a1 is evicted,
+  // which brings the cache back within the 8 MB budget.
+  ASSERT_TRUE(rfhs[1].WaitUntilRenderFrameDeleted());
+  EXPECT_TRUE(rfhs[0]->IsInBackForwardCache());
+  EXPECT_TRUE(rfhs[2]->IsInBackForwardCache());
+  histogram_tester.ExpectUniqueSample(
+      "BackForwardCache.MemoryBudget.EvictedEntrySize", 6, 1);
+
+  ASSERT_TRUE(HistoryGoBack(web_contents()));
+  ExpectRestored(FROM_HERE);
+  histogram_tester.ExpectUniqueSample(
+      "BackForwardCache.MemoryBudget.RestoredEntrySize", 3, 1);
+
+  ASSERT_TRUE(HistoryGoBack(web_contents()));
+  ExpectNotRestored({NotRestoredReason::kCacheLimit}, {}, {}, {}, {},
+                    FROM_HERE);
+}
+
 namespace {
 
 const char kPrioritizedPageURL[] = "search.result";
@@ -9,6 +9,7 @@
 #include "base/functional/bind.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/task/single_thread_task_runner.h"
@@ -242,9 +243,18 @@ void BatchingMediaLog::SendQueuedMediaEvents() {
 
   last_ipc_send_time_ = tick_clock_->NowTicks();
 
+  if (dropped_event_count_) {
+    UMA_HISTOGRAM_COUNTS_10000("Media.MediaLog.DroppedEventsPerSend",
+                               dropped_event_count_);
+    dropped_event_count_ = 0;
+  }
+
   if (queued_media_events_.empty())
     return;
 
+  UMA_HISTOGRAM_COUNTS_1000("Media.MediaLog.QueuedEventsPerSend",
+                            queued_media_events_.size());
+
   for (const auto& handler : event_handlers_)
     handler->SendQueuedMediaEvents(queued_media_events_);
 
@@ -266,6 +276,7 @@ void BatchingMediaLog::MaybeQueueEvent_Locked(
     return;
   }
 
+  ++dropped_event_count_;
   if (logged_rate_limit_warning_)
     return;
 
@@ -89,6 +89,9 @@ class CONTENT_EXPORT BatchingMediaLog : public media::MediaLog {
   // True if we've logged a warning message about exceeding rate limits.
   bool logged_rate_limit_warning_ GUARDED_BY(lock_);
 
+  // Number of events dropped for exceeding rate limits since the last send.
+  size_t dropped_event_count_ GUARDED_BY(lock_) = 0;
+
   // Limits the number of events we send over IPC to one.
   std::optional<media::MediaLogRecord> last_duration_changed_event_
       GUARDED_BY(lock_);
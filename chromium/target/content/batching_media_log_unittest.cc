@@ -5,6 +5,7 @@
 #include "content/renderer/media/batching_media_log.h"
 
 #include "base/memory/raw_ptr.h"
+#include "base/test/metrics/histogram_tester.h"
 #include "base/test/simple_test_tick_clock.h"
 #include "base/test/task_environment.h"
 #include "base/test/test_mock_time_task_runner.h"
@@ -122,6 +123,7 @@ TEST_F(BatchingMediaLogTest, ThrottleSendingEvents) {
 }
 
 TEST_F(BatchingMediaLogTest, LimitEvents) {
+  base::HistogramTester histogram_tester;
   // Add 2x the log limit in suspend messages.
   for (size_t i = 0; i < media::MediaLog::kLogLimit * 2; ++i) {
     AddEvent<media::MediaLogEvent::kSuspended>();
@@ -129,6 +131,13 @@ TEST_F(BatchingMediaLogTest, LimitEvents) {
 
   Advance(base::Milliseconds(1100));
   EXPECT_EQ(media::MediaLog::kLogLimit + 1, GetMediaLogRecords().size());
+
+  // The queue also held the creation event, so one more suspend message than
+  // the log limit was dropped.
+  histogram_tester.ExpectUniqueSample("Media.MediaLog.QueuedEventsPerSend",
+                                      media::MediaLog::kLogLimit + 1, 1);
+  histogram_tester.ExpectUniqueSample("Media.MediaLog.DroppedEventsPerSend",
+                                      media::MediaLog::kLogLimit + 1, 1);
 }
 
 TEST_F(BatchingMediaLogTest, EventSentWithoutDelayAfterIpcInterval) {
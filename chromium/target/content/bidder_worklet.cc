@@ -2586,6 +2586,15 @@ void BidderWorklet::OnGenerateBidClientDestroyed(
     // it already started, it will just run and invoke the GenerateBidClient's
     // OnGenerateBidComplete() method, which will safely do nothing since the
     // pipe is now closed.
+    //
+    // With kFledgeBidderWorkStealing, the task may instead still be waiting
+    // for a thread, in which case it can just be dropped.
+    if (task->task_id == base::CancelableTaskTracker::kBadTaskId &&
+        task->queued_task_id &&
+        thread_selector_.CancelQueuedTask(*task->queued_task_id)) {
+      CleanUpBidTaskOnUserThread(task);
+      return;
+    }
     DCHECK_NE(task->task_id, base::CancelableTaskTracker::kBadTaskId);
     cancelable_task_tracker_.TryCancel(task->task_id);
   }
@@ -2742,15 +2751,7 @@ void BidderWorklet::GenerateBidIfReady(GenerateBidTaskList::iterator task) {
       });
   TRACE_EVENT_NESTABLE_ASYNC_BEGIN0("fledge", "post_v8_task", task->trace_id);
 
-  // Normally the PostTask below will eventually get `task` cleaned up once it
-  // posts back to DeliverBidCallbackOnUserThread with its results, but that
-  // won't happen if it gets cancelled. To deal with that, a ScopedClosureRunner
-  // is passed to ask for `task` to get cleaned up in case the
-  // V8State::GenerateBid closure gets destroyed without running.
-  base::OnceClosure cleanup_generate_bid_task =
-      base::BindPostTaskToCurrentDefault(
-          base::BindOnce(&BidderWorklet::CleanUpBidTaskOnUserThread,
-                         weak_ptr_factory_.GetWeakPtr(), task));
+  task->generate_bid_start_time = base::TimeTicks::Now();
 
   // The thread selector only needs to worry about grouping tasks by origin
   // when they're in group-by-origin mode.
@@ -2759,7 +2760,35 @@ void BidderWorklet::GenerateBidIfReady(GenerateBidTaskList::iterator task) {
       blink::mojom::InterestGroup::ExecutionMode::kGroupedByOriginMode) {
     maybe_joining_origin = task->interest_group_join_origin;
   }
-  size_t thread_index = thread_selector_.GetThread(maybe_joining_origin);
+
+  if (base::FeatureList::IsEnabled(features::kFledgeBidderWorkStealing)) {
+    // Unretained is safe because `thread_selector_` is owned by `this`, and the
+    // task can't be deleted while queued without first being removed from
+    // `thread_selector_`.
+    task->queued_task_id = thread_selector_.EnqueueTask(
+        std::move(maybe_joining_origin),
+        base::BindOnce(&BidderWorklet::PostGenerateBidTask,
+                       base::Unretained(this), task));
+    return;
+  }
+
+  PostGenerateBidTask(task, thread_selector_.GetThread(maybe_joining_origin));
+}
+
+void BidderWorklet::PostGenerateBidTask(GenerateBidTaskList::iterator task,
+                                        size_t thread_index) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(user_sequence_checker_);
+  DCHECK(IsReadyToGenerateBid(*task));
+
+  // Normally the PostTask below will eventually get `task` cleaned up once it
+  // posts back to DeliverBidCallbackOnUserThread with its results, but that
+  // won't happen if it gets cancelled. To deal with that, a ScopedClosureRunner
+  // is passed to ask for `task` to get cleaned up in case the
+  // V8State::GenerateBid closure gets destroyed without running.
+  base::OnceClosure cleanup_generate_bid_task =
+      base::BindPostTaskToCurrentDefault(
+          base::BindOnce(&BidderWorklet::CleanUpCancelledBidTaskOnUserThread,
+                         weak_ptr_factory_.GetWeakPtr(), task, thread_index));
 
   // Other than the `generate_bid_client` and `task_id` fields, no fields of
   // `task` are needed after this point, so can consume them instead of copying
@@ -2770,7 +2799,6 @@ void BidderWorklet::GenerateBidIfReady(GenerateBidTaskList::iterator task) {
   // deleted by the caller (unless the BidderWorklet  itself is deleted).
   // Therefore, it's safe to post a callback with the `task`  iterator the v8
   // thread.
-  task->generate_bid_start_time = base::TimeTicks::Now();
   task->task_id = cancelable_task_tracker_.PostTask(
       v8_runners_[thread_index].get(), FROM_HERE,
       base::BindOnce(
@@ -2965,6 +2993,14 @@ void BidderWorklet::CleanUpBidTaskOnUserThread(
   generate_bid_tasks_.erase(task);
 }
 
+void BidderWorklet::CleanUpCancelledBidTaskOnUserThread(
+    GenerateBidTaskList::iterator task,
+    size_t thread_index) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(user_sequence_checker_);
+  thread_selector_.TaskCompletedOnThread(thread_index);
+  CleanUpBidTaskOnUserThread(task);
+}
+
 void BidderWorklet::DeliverReportWinOnUserThread(
     ReportWinTaskList::iterator task,
     size_t thread_index_used_for_task,
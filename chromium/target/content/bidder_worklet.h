@@ -253,6 +253,10 @@ class CONTENT_EXPORT BidderWorklet : public mojom::BidderWorklet,
     base::CancelableTaskTracker::TaskId task_id =
         base::CancelableTaskTracker::kBadTaskId;
 
+    // Set when the task was passed to `thread_selector_`'s EnqueueTask(). The
+    // task is still queued there as long as `task_id` is kBadTaskId.
+    std::optional<BidderWorkletThreadSelector::TaskId> queued_task_id;
+
     mojom::BidderWorkletNonSharedParamsPtr bidder_worklet_non_shared_params;
     mojom::KAnonymityBidMode kanon_mode;
     url::Origin interest_group_join_origin;
@@ -829,6 +833,11 @@ class CONTENT_EXPORT BidderWorklet : public mojom::BidderWorklet,
   // the task callback with the resulting bid, if any.
   void GenerateBidIfReady(GenerateBidTaskList::iterator task);
 
+  // Posts the V8 work for `task`, which must be ready, to thread
+  // `thread_index`.
+  void PostGenerateBidTask(GenerateBidTaskList::iterator task,
+                           size_t thread_index);
+
   void OnDirectFromSellerPerBuyerSignalsDownloadedReportWin(
       ReportWinTaskList::iterator task,
       DirectFromSellerSignalsRequester::Result result);
@@ -870,6 +879,11 @@ class CONTENT_EXPORT BidderWorklet : public mojom::BidderWorklet,
   // parameter getting destroyed).
   void CleanUpBidTaskOnUserThread(GenerateBidTaskList::iterator task);
 
+  // Same as above, but also releases the task's slot on `thread_index` in
+  // `thread_selector_`.
+  void CleanUpCancelledBidTaskOnUserThread(GenerateBidTaskList::iterator task,
+                                           size_t thread_index);
+
   // Invokes the `callback` of `task` with the provided values, and removes
   // `task` from `report_win_tasks_`.
   void DeliverReportWinOnUserThread(
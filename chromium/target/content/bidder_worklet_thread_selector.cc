@@ -9,6 +9,7 @@
 
 #include "base/feature_list.h"
 #include "base/hash/hash.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/rand_util.h"
 #include "content/services/auction_worklet/public/cpp/auction_worklet_features.h"
 
@@ -17,10 +18,27 @@ namespace auction_worklet {
 BidderWorkletThreadSelector::BidderWorkletThreadSelector(size_t num_threads)
     : num_threads_(num_threads),
       join_origin_hash_salt_(base::NumberToString(base::RandUint64())),
-      tasks_sent_to_each_thread_(num_threads, 0) {}
+      tasks_sent_to_each_thread_(num_threads, 0),
+      queued_tasks_(num_threads) {}
 
 BidderWorkletThreadSelector::~BidderWorkletThreadSelector() = default;
 
+BidderWorkletThreadSelector::QueuedTask::QueuedTask(
+    TaskId id,
+    std::optional<url::Origin> joining_origin,
+    DispatchCallback dispatch)
+    : id(id),
+      joining_origin(std::move(joining_origin)),
+      dispatch(std::move(dispatch)),
+      enqueue_time(base::TimeTicks::Now()) {}
+
+BidderWorkletThreadSelector::QueuedTask::QueuedTask(QueuedTask&&) = default;
+
+BidderWorkletThreadSelector::QueuedTask&
+BidderWorkletThreadSelector::QueuedTask::operator=(QueuedTask&&) = default;
+
+BidderWorkletThreadSelector::QueuedTask::~QueuedTask() = default;
+
 size_t BidderWorkletThreadSelector::GetThread(
     std::optional<url::Origin> joining_origin) {
   if (num_threads_ == 1) {
@@ -28,23 +46,80 @@ size_t BidderWorkletThreadSelector::GetThread(
     // if we only have 1 thread.
     return 0;
   }
-  if (!base::FeatureList::IsEnabled(
-          features::kFledgeBidderUseBalancingThreadSelector)) {
-    return GetThreadWithLegacyLogic(joining_origin);
+  size_t chosen_thread =
+      base::FeatureList::IsEnabled(
+          features::kFledgeBidderUseBalancingThreadSelector)
+          ? SelectBalancedThread(joining_origin)
+          : GetThreadWithLegacyLogic(joining_origin);
+  // Count the task even with the legacy logic, since TaskCompletedOnThread()
+  // is called for it regardless, and queued tasks are dispatched based on
+  // these counts.
+  ++tasks_sent_to_each_thread_[chosen_thread];
+  return chosen_thread;
+}
+
+BidderWorkletThreadSelector::TaskId BidderWorkletThreadSelector::EnqueueTask(
+    std::optional<url::Origin> joining_origin,
+    DispatchCallback dispatch) {
+  TaskId task_id = next_task_id_++;
+  if (num_threads_ == 1) {
+    // Nothing to balance or steal; let the thread's task runner queue it.
+    std::move(dispatch).Run(0);
+    return task_id;
   }
+  size_t chosen_thread = SelectBalancedThread(joining_origin);
+  queued_tasks_[chosen_thread].emplace_back(task_id, std::move(joining_origin),
+                                            std::move(dispatch));
+  DispatchQueuedTasks();
+  return task_id;
+}
+
+bool BidderWorkletThreadSelector::CancelQueuedTask(TaskId task_id) {
+  for (auto& queue : queued_tasks_) {
+    auto it = std::find_if(
+        queue.begin(), queue.end(),
+        [task_id](const QueuedTask& task) { return task.id == task_id; });
+    if (it != queue.end()) {
+      queue.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+void BidderWorkletThreadSelector::TaskCompletedOnThread(size_t thread) {
+  CHECK_LT(thread, num_threads_);
+  if (num_threads_ == 1) {
+    // Tasks aren't tracked with only 1 thread.
+    return;
+  }
+  CHECK_GT(tasks_sent_to_each_thread_[thread], 0u);
+  --tasks_sent_to_each_thread_[thread];
+  DispatchQueuedTasks();
+}
+
+size_t BidderWorkletThreadSelector::GetLoad(size_t thread) const {
+  return tasks_sent_to_each_thread_[thread] + queued_tasks_[thread].size();
+}
+
+size_t BidderWorkletThreadSelector::SelectBalancedThread(
+    const std::optional<url::Origin>& joining_origin) {
   // Default to the least used thread.
-  auto least_used_thread_it = std::min_element(
-      tasks_sent_to_each_thread_.begin(), tasks_sent_to_each_thread_.end());
-  size_t chosen_thread =
-      std::distance(tasks_sent_to_each_thread_.begin(), least_used_thread_it);
+  size_t chosen_thread = 0;
+  for (size_t thread = 1; thread < num_threads_; ++thread) {
+    if (GetLoad(thread) < GetLoad(chosen_thread)) {
+      chosen_thread = thread;
+    }
+  }
+  size_t least_load = GetLoad(chosen_thread);
 
   // If it exists, choose a thread that has already seen this `joining_origin`
   // unless it would cause a large imbalance.
   if (joining_origin) {
     auto it = joining_origin_to_thread_.find(joining_origin.value());
     if (it != joining_origin_to_thread_.end() &&
-        (tasks_sent_to_each_thread_[it->second] <
-         *least_used_thread_it +
+        (GetLoad(it->second) <
+         least_load +
              features::kFledgeBidderThreadSelectorMaxImbalance.Get())) {
       chosen_thread = it->second;
     }
@@ -54,14 +129,78 @@ size_t BidderWorkletThreadSelector::GetThread(
     joining_origin_to_thread_[joining_origin.value()] = chosen_thread;
   }
   CHECK_LT(chosen_thread, num_threads_);
-
-  ++tasks_sent_to_each_thread_[chosen_thread];
   return chosen_thread;
 }
 
-void BidderWorkletThreadSelector::TaskCompletedOnThread(size_t thread) {
-  CHECK_LT(thread, num_threads_);
-  --tasks_sent_to_each_thread_[thread];
+void BidderWorkletThreadSelector::DispatchQueuedTasks() {
+  const size_t max_running_tasks = static_cast<size_t>(std::max(
+      features::kFledgeBidderWorkStealingMaxRunningTasksPerThread.Get(), 1));
+
+  // Let threads with spare capacity run their own queued tasks first, to keep
+  // context-cache affinity...
+  for (size_t thread = 0; thread < num_threads_; ++thread) {
+    while (tasks_sent_to_each_thread_[thread] < max_running_tasks &&
+           !queued_tasks_[thread].empty()) {
+      DispatchQueuedTask(thread, /*from_thread=*/thread);
+    }
+  }
+
+  // ...then have any that are still idle steal from the longest queue.
+  for (size_t thread = 0; thread < num_threads_; ++thread) {
+    while (tasks_sent_to_each_thread_[thread] < max_running_tasks) {
+      auto longest_queue_it = std::max_element(
+          queued_tasks_.begin(), queued_tasks_.end(),
+          [](const auto& a, const auto& b) { return a.size() < b.size(); });
+      if (longest_queue_it->empty()) {
+        return;
+      }
+      DispatchQueuedTask(thread, std::distance(queued_tasks_.begin(),
+                                               longest_queue_it));
+    }
+  }
+
+  // Finally, hand each full thread its next queued task ahead of time. It then
+  // waits in the V8 thread's task runner and starts as soon as the running task
+  // finishes, instead of after TaskCompletedOnThread() has made a round trip
+  // through the user thread. Only one task per thread is handed out this way,
+  // so the rest of the queue can still be stolen.
+  if (!features::kFledgeBidderWorkStealingDispatchAhead.Get()) {
+    return;
+  }
+  for (size_t thread = 0; thread < num_threads_; ++thread) {
+    if (tasks_sent_to_each_thread_[thread] == max_running_tasks &&
+        !queued_tasks_[thread].empty()) {
+      DispatchQueuedTask(thread, /*from_thread=*/thread);
+    }
+  }
+}
+
+void BidderWorkletThreadSelector::DispatchQueuedTask(size_t thread,
+                                                     size_t from_thread) {
+  auto& queue = queued_tasks_[from_thread];
+  CHECK(!queue.empty());
+  bool stolen = thread != from_thread;
+  // A thread's own tasks run in order. Stolen tasks are taken from the back,
+  // since those are the ones that would otherwise wait longest.
+  QueuedTask task = stolen ? std::move(queue.back()) : std::move(queue.front());
+  if (stolen) {
+    queue.pop_back();
+    // The stolen task will create a context for its origin on `thread`, so
+    // prefer that thread for the origin from now on.
+    if (task.joining_origin) {
+      joining_origin_to_thread_[*task.joining_origin] = thread;
+    }
+  } else {
+    queue.pop_front();
+  }
+
+  base::UmaHistogramBoolean("Ads.InterestGroup.Auction.BidderTaskStolen",
+                            stolen);
+  base::UmaHistogramTimes("Ads.InterestGroup.Auction.BidderTaskQueueTime",
+                          base::TimeTicks::Now() - task.enqueue_time);
+
+  ++tasks_sent_to_each_thread_[thread];
+  std::move(task.dispatch).Run(thread);
 }
 
 size_t BidderWorkletThreadSelector::GetThreadWithLegacyLogic(
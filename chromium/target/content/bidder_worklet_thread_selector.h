@@ -6,8 +6,15 @@
 #define CONTENT_SERVICES_AUCTION_WORKLET_BIDDER_WORKLET_THREAD_SELECTOR_H_
 
 #include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
 
+#include "base/containers/circular_deque.h"
 #include "base/containers/flat_map.h"
+#include "base/functional/callback.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 #include "url/origin.h"
 
@@ -18,8 +25,19 @@ namespace auction_worklet {
 // the same joining origin on the same thread (to help with context reuse), and
 // if `kFledgeBidderUseBalancingThreadSelector` is enabled, it prevents any
 // given thread from being assigned many more tasks than another.
+//
+// If `kFledgeBidderWorkStealing` is enabled, tasks passed to EnqueueTask() are
+// instead held in per-thread queues and only handed to a thread once it has
+// capacity, so a thread stuck on a slow bidder can have its queued tasks taken
+// over by idle threads.
 class CONTENT_EXPORT BidderWorkletThreadSelector {
  public:
+  // Identifies a task passed to EnqueueTask().
+  using TaskId = uint64_t;
+
+  // Invoked with the thread a task passed to EnqueueTask() should run on.
+  using DispatchCallback = base::OnceCallback<void(size_t thread)>;
+
   explicit BidderWorkletThreadSelector(size_t num_threads);
 
   ~BidderWorkletThreadSelector();
@@ -33,8 +51,24 @@ class CONTENT_EXPORT BidderWorkletThreadSelector {
   size_t GetThread(
       const std::optional<url::Origin> joining_origin = std::nullopt);
 
+  // Queues a task, preferring the thread previously used by `joining_origin`
+  // (subject to `BidderThreadSelectorMaxImbalance`) and otherwise the thread
+  // with the least work. `dispatch` is run, possibly synchronously, once a
+  // thread has fewer than `MaxRunningTasksPerThread` tasks running. Threads
+  // run their own queued tasks first, and steal the most recently queued task
+  // from the longest queue when they have none. With `DispatchAhead`, a thread
+  // at `MaxRunningTasksPerThread` is also given its next queued task, so it can
+  // start it without waiting for TaskCompletedOnThread(). Once dispatched, the
+  // task counts against its thread until TaskCompletedOnThread() is called.
+  TaskId EnqueueTask(std::optional<url::Origin> joining_origin,
+                     DispatchCallback dispatch);
+
+  // Removes a task passed to EnqueueTask() that has not yet been dispatched.
+  // Returns false if there is no such task.
+  bool CancelQueuedTask(TaskId task_id);
+
   // Let this class know a thread finished a task so that we can use that
-  // information for load balancing.
+  // information for load balancing. May dispatch queued tasks.
   void TaskCompletedOnThread(size_t thread);
 
   const std::string& join_origin_hash_salt_for_testing() const {
@@ -42,6 +76,33 @@ class CONTENT_EXPORT BidderWorkletThreadSelector {
   }
 
  private:
+  struct QueuedTask {
+    QueuedTask(TaskId id,
+               std::optional<url::Origin> joining_origin,
+               DispatchCallback dispatch);
+    QueuedTask(QueuedTask&&);
+    QueuedTask& operator=(QueuedTask&&);
+    ~QueuedTask();
+
+    TaskId id;
+    std::optional<url::Origin> joining_origin;
+    DispatchCallback dispatch;
+    base::TimeTicks enqueue_time;
+  };
+
+  // Tasks running on or queued for `thread`.
+  size_t GetLoad(size_t thread) const;
+
+  // Chooses a thread with the balancing logic, without recording a task for
+  // it.
+  size_t SelectBalancedThread(const std::optional<url::Origin>& joining_origin);
+
+  // Hands queued tasks to threads that are below `MaxRunningTasksPerThread`.
+  void DispatchQueuedTasks();
+
+  // Pops a task from `from_thread`'s queue and dispatches it to `thread`.
+  void DispatchQueuedTask(size_t thread, size_t from_thread);
+
   // Use the previous logic for getting a thread index (hash `joining_origin` to
   // get the thread or use a round robin otherwise).
   size_t GetThreadWithLegacyLogic(
@@ -63,6 +124,12 @@ class CONTENT_EXPORT BidderWorkletThreadSelector {
   base::flat_map<url::Origin, size_t> joining_origin_to_thread_;
 
   std::vector<size_t> tasks_sent_to_each_thread_;
+
+  // Tasks waiting for each thread. Only used with `kFledgeBidderWorkStealing`.
+  // A thread only has queued tasks while it's at `MaxRunningTasksPerThread`.
+  std::vector<base::circular_deque<QueuedTask>> queued_tasks_;
+
+  TaskId next_task_id_ = 0;
 };
 
 }  // namespace auction_worklet
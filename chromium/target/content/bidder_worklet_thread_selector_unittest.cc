@@ -5,8 +5,11 @@
 #include "content/services/auction_worklet/bidder_worklet_thread_selector.h"
 
 #include <cstddef>
+#include <utility>
+#include <vector>
 
 #include "base/hash/hash.h"
+#include "base/test/bind.h"
 #include "base/test/scoped_feature_list.h"
 #include "content/services/auction_worklet/public/cpp/auction_worklet_features.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -162,4 +165,118 @@ TEST_F(BidderWorkletThreadSelectorTest, BalancingThreadSelectorDisabled) {
   EXPECT_EQ(selector.GetThread(), 1u);
 }
 
+class BidderWorkletThreadSelectorWorkStealingTest
+    : public BidderWorkletThreadSelectorTest {
+ public:
+  // Tasks are only dispatched once a thread has capacity, unless a test turns
+  // on `DispatchAhead`.
+  BidderWorkletThreadSelectorWorkStealingTest() {
+    work_stealing_feature_list_.InitAndEnableFeatureWithParameters(
+        features::kFledgeBidderWorkStealing, {{"DispatchAhead", "false"}});
+  }
+
+ protected:
+  // Enqueues a task that records `(task_number, thread)` in `dispatched_` when
+  // dispatched.
+  BidderWorkletThreadSelector::TaskId Enqueue(
+      BidderWorkletThreadSelector& selector,
+      int task_number,
+      std::optional<url::Origin> joining_origin = std::nullopt) {
+    return selector.EnqueueTask(
+        std::move(joining_origin),
+        base::BindLambdaForTesting([this, task_number](size_t thread) {
+          dispatched_.emplace_back(task_number, thread);
+        }));
+  }
+
+  std::vector<std::pair<int, size_t>> dispatched_;
+  base::test::ScopedFeatureList work_stealing_feature_list_;
+};
+
+TEST_F(BidderWorkletThreadSelectorWorkStealingTest, IdleThreadStealsTask) {
+  BidderWorkletThreadSelector selector{/*num_threads=*/2};
+
+  Enqueue(selector, 1, kUrlA);
+  Enqueue(selector, 2, kUrlB);
+  // Both threads are busy, so these wait on kUrlA's thread.
+  Enqueue(selector, 3, kUrlA);
+  Enqueue(selector, 4, kUrlA);
+  EXPECT_EQ(dispatched_, (std::vector<std::pair<int, size_t>>{{1, 0u},
+                                                              {2, 1u}}));
+
+  // Thread 1 has nothing queued, so it steals the most recently queued task.
+  selector.TaskCompletedOnThread(1u);
+  EXPECT_EQ(dispatched_, (std::vector<std::pair<int, size_t>>{
+                             {1, 0u}, {2, 1u}, {4, 1u}}));
+
+  selector.TaskCompletedOnThread(0u);
+  EXPECT_EQ(dispatched_, (std::vector<std::pair<int, size_t>>{
+                             {1, 0u}, {2, 1u}, {4, 1u}, {3, 0u}}));
+}
+
+TEST_F(BidderWorkletThreadSelectorWorkStealingTest, CancelQueuedTask) {
+  BidderWorkletThreadSelector selector{/*num_threads=*/2};
+
+  BidderWorkletThreadSelector::TaskId task1 = Enqueue(selector, 1);
+  Enqueue(selector, 2);
+  BidderWorkletThreadSelector::TaskId task3 = Enqueue(selector, 3);
+  EXPECT_EQ(dispatched_.size(), 2u);
+
+  // Already dispatched tasks can't be cancelled.
+  EXPECT_FALSE(selector.CancelQueuedTask(task1));
+  EXPECT_TRUE(selector.CancelQueuedTask(task3));
+  EXPECT_FALSE(selector.CancelQueuedTask(task3));
+
+  selector.TaskCompletedOnThread(0u);
+  EXPECT_EQ(dispatched_.size(), 2u);
+}
+
+TEST_F(BidderWorkletThreadSelectorWorkStealingTest, DispatchAhead) {
+  base::test::ScopedFeatureList dispatch_ahead_feature_list;
+  dispatch_ahead_feature_list.InitAndEnableFeatureWithParameters(
+      features::kFledgeBidderWorkStealing, {{"DispatchAhead", "true"}});
+  BidderWorkletThreadSelector selector{/*num_threads=*/2};
+
+  Enqueue(selector, 1, kUrlA);
+  Enqueue(selector, 2, kUrlB);
+  // Thread 0 is busy, but is handed its next task ahead of time.
+  Enqueue(selector, 3, kUrlA);
+  EXPECT_EQ(dispatched_, (std::vector<std::pair<int, size_t>>{
+                             {1, 0u}, {2, 1u}, {3, 0u}}));
+
+  // Only one task per thread is dispatched ahead, so this one stays queued and
+  // can be stolen.
+  Enqueue(selector, 4, kUrlA);
+  EXPECT_EQ(dispatched_.size(), 3u);
+  selector.TaskCompletedOnThread(1u);
+  EXPECT_EQ(dispatched_, (std::vector<std::pair<int, size_t>>{
+                             {1, 0u}, {2, 1u}, {3, 0u}, {4, 1u}}));
+}
+
+// Tasks from GetThread() must be tracked even when the legacy thread selection
+// logic is used, since TaskCompletedOnThread() is called for them.
+TEST_F(BidderWorkletThreadSelectorWorkStealingTest,
+       BalancingThreadSelectorDisabled) {
+  base::test::ScopedFeatureList balancing_feature_list;
+  balancing_feature_list.InitAndDisableFeature(
+      features::kFledgeBidderUseBalancingThreadSelector);
+  BidderWorkletThreadSelector selector{/*num_threads=*/2};
+
+  // Tasks that don't go through the queues, like reportWin().
+  selector.TaskCompletedOnThread(selector.GetThread());
+  selector.TaskCompletedOnThread(selector.GetThread());
+
+  Enqueue(selector, 1);
+  Enqueue(selector, 2);
+  EXPECT_EQ(dispatched_, (std::vector<std::pair<int, size_t>>{{1, 0u},
+                                                              {2, 1u}}));
+
+  selector.TaskCompletedOnThread(0u);
+  selector.TaskCompletedOnThread(1u);
+  Enqueue(selector, 3);
+  Enqueue(selector, 4);
+  EXPECT_EQ(dispatched_, (std::vector<std::pair<int, size_t>>{
+                             {1, 0u}, {2, 1u}, {3, 0u}, {4, 1u}}));
+}
+
 }  // namespace auction_worklet
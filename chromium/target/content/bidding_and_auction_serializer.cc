@@ -468,6 +468,148 @@ CompressedInterestGroups CompressInterestGroups(
   return result;
 }
 
+// A single interest group serialized to CBOR, along with the information
+// CompressInterestGroups() collects for each group it includes.
+struct EncodedInterestGroup {
+  std::vector<uint8_t> cbor;
+  std::string name;
+  std::optional<url::Origin> aggregation_coordinator_origin;
+  std::optional<size_t> prev_wins_array_size;
+};
+
+// Serializes each of `groups` to CBOR. Returns an empty vector if any group's
+// size is invalid, matching CompressInterestGroups().
+std::vector<EncodedInterestGroup> EncodeInterestGroups(
+    const std::vector<SingleStorageInterestGroup>& groups,
+    base::Time start_time) {
+  std::vector<EncodedInterestGroup> result;
+  result.reserve(groups.size());
+  for (const SingleStorageInterestGroup& group : groups) {
+    ValueAndSizeAndPrevWinsSize serialized_group =
+        SerializeInterestGroup(start_time, group);
+    if (!serialized_group.size.IsValid()) {
+      DLOG(ERROR) << "Invalid uncompressed size.";
+      return {};
+    }
+    std::optional<std::vector<uint8_t>> maybe_cbor =
+        cbor::Writer::Write(serialized_group.value);
+    DCHECK(maybe_cbor);
+    DCHECK_EQ(static_cast<size_t>(serialized_group.size.ValueOrDie()),
+              maybe_cbor->size());
+
+    EncodedInterestGroup& encoded_group = result.emplace_back();
+    encoded_group.cbor = std::move(maybe_cbor).value();
+    encoded_group.name = group->interest_group.name;
+    encoded_group.aggregation_coordinator_origin =
+        group->interest_group.aggregation_coordinator_origin;
+    if (serialized_group.prev_wins_array_size.IsValid()) {
+      encoded_group.prev_wins_array_size = static_cast<size_t>(
+          serialized_group.prev_wins_array_size.ValueOrDie());
+    }
+  }
+  return result;
+}
+
+// Appends the CBOR tag and length of an array with `num_elements` elements.
+void AppendArrayHeader(uint64_t num_elements, std::vector<uint8_t>& out) {
+  const uint8_t kArrayMajorType = 4 << 5;
+  const size_t length_of_length = LengthOfLength(num_elements);
+  switch (length_of_length) {
+    case 0:
+      out.push_back(kArrayMajorType | static_cast<uint8_t>(num_elements));
+      return;
+    case 1:
+      out.push_back(kArrayMajorType | 24);
+      break;
+    case 2:
+      out.push_back(kArrayMajorType | 25);
+      break;
+    case 4:
+      out.push_back(kArrayMajorType | 26);
+      break;
+    default:
+      out.push_back(kArrayMajorType | 27);
+      break;
+  }
+  for (size_t i = length_of_length; i > 0; --i) {
+    out.push_back(static_cast<uint8_t>(num_elements >> (8 * (i - 1))));
+  }
+}
+
+// Compresses a CBOR array of the first `num_groups` of `encoded_groups`. The
+// result is the same as CompressInterestGroups() would produce for those
+// groups, but doesn't need to serialize them again.
+CompressedInterestGroups CompressEncodedInterestGroups(
+    const url::Origin& owner,
+    const std::vector<EncodedInterestGroup>& encoded_groups,
+    size_t num_groups) {
+  DCHECK_LE(num_groups, encoded_groups.size());
+  CompressedInterestGroups result{{}, {}, 0, 0};
+  if (num_groups == 0) {
+    return result;
+  }
+
+  size_t elements_size = 0;
+  for (size_t i = 0; i < num_groups; ++i) {
+    elements_size += encoded_groups[i].cbor.size();
+  }
+  std::vector<uint8_t> sub_message;
+  sub_message.reserve(1 + LengthOfLength(num_groups) + elements_size);
+  AppendArrayHeader(num_groups, sub_message);
+  for (size_t i = 0; i < num_groups; ++i) {
+    const EncodedInterestGroup& group = encoded_groups[i];
+    sub_message.insert(sub_message.end(), group.cbor.begin(),
+                       group.cbor.end());
+    result.group_names.push_back(group.name);
+    if (group.aggregation_coordinator_origin) {
+      result.group_pagg_coordinators[blink::InterestGroupKey(
+          owner, group.name)] = *group.aggregation_coordinator_origin;
+    }
+    if (group.prev_wins_array_size) {
+      result.prev_wins_array_sizes.push_back(*group.prev_wins_array_size);
+    }
+  }
+
+  std::string compressed_groups;
+  bool success = compression::GzipCompress(sub_message, &compressed_groups);
+  CHECK(success);
+
+  result.uncompressed_size = sub_message.size();
+  result.num_groups = num_groups;
+  result.data = std::move(compressed_groups);
+  return result;
+}
+
+// Returns the compressed groups for the longest prefix of `encoded_groups`
+// whose compressed size is at most `target_compressed_size`, or an empty result
+// if not even one group fits. Binary searches over the number of groups, so
+// takes O(log(n)) compressions, each counted in `num_iterations`. The caller
+// has already determined that all of `encoded_groups` don't fit.
+CompressedInterestGroups FitEncodedInterestGroups(
+    const url::Origin& owner,
+    const std::vector<EncodedInterestGroup>& encoded_groups,
+    uint64_t target_compressed_size,
+    int& num_iterations) {
+  CompressedInterestGroups best{{}, {}, 0, 0};
+  // `best` always holds the compressed form of the first `fits` groups, and
+  // the first `does_not_fit` groups are known to be too large.
+  size_t fits = 0;
+  size_t does_not_fit = encoded_groups.size();
+  while (does_not_fit - fits > 1) {
+    num_iterations++;
+    size_t num_groups = fits + (does_not_fit - fits) / 2;
+    CompressedInterestGroups candidate =
+        CompressEncodedInterestGroups(owner, encoded_groups, num_groups);
+    if (candidate.data.size() <= target_compressed_size) {
+      fits = num_groups;
+      best = std::move(candidate);
+    } else {
+      does_not_fit = num_groups;
+    }
+  }
+  return best;
+}
+
 SerializedBiddersMap SerializeBidderGroupsWithConfig(
     const std::vector<
         std::pair<url::Origin, std::vector<SingleStorageInterestGroup>>>&
@@ -482,12 +624,28 @@ SerializedBiddersMap SerializeBidderGroupsWithConfig(
   // not use all of their space. If they fit without applying limits then we
   // will use this result for the final serialization. This also allows us to
   // estimate the compression ratio for the groups.
+  //
+  // With kEnableBandAExactRequestSizing, each group is only serialized here,
+  // and buyers that don't fit reuse the serialized groups below.
+  const bool exact_request_sizing =
+      base::FeatureList::IsEnabled(features::kEnableBandAExactRequestSizing);
+  std::vector<std::vector<EncodedInterestGroup>> all_bidders_encoded_groups;
   std::vector<CompressedInterestGroups> all_bidders_full_compressed_groups;
   all_bidders_full_compressed_groups.reserve(bidders_and_groups.size());
   for (size_t idx = 0; idx < bidders_and_groups.size(); ++idx) {
     const auto& bidder_groups = bidders_and_groups[idx];
-    all_bidders_full_compressed_groups.emplace_back(CompressInterestGroups(
-        bidder_groups.first, bidder_groups.second, start_time, std::nullopt));
+    if (exact_request_sizing) {
+      const std::vector<EncodedInterestGroup>& encoded_groups =
+          all_bidders_encoded_groups.emplace_back(
+              EncodeInterestGroups(bidder_groups.second, start_time));
+      all_bidders_full_compressed_groups.emplace_back(
+          CompressEncodedInterestGroups(bidder_groups.first, encoded_groups,
+                                        encoded_groups.size()));
+    } else {
+      all_bidders_full_compressed_groups.emplace_back(CompressInterestGroups(
+          bidder_groups.first, bidder_groups.second, start_time,
+          std::nullopt));
+    }
     estimator.UpdatePerBuyerMaxSize(
         bidder_groups.first,
         all_bidders_full_compressed_groups[idx].data.size());
@@ -514,6 +672,12 @@ SerializedBiddersMap SerializeBidderGroupsWithConfig(
 
     if (target_compressed_size) {
       int num_iterations = 0;
+      if (exact_request_sizing &&
+          compressed_groups.data.size() > *target_compressed_size) {
+        compressed_groups = FitEncodedInterestGroups(
+            bidder_groups.first, all_bidders_encoded_groups[idx],
+            *target_compressed_size, num_iterations);
+      }
       while (compressed_groups.data.size() > *target_compressed_size) {
         num_iterations++;
         if (num_iterations > 20) {
@@ -5,10 +5,19 @@
 #include "content/browser/interest_group/bidding_and_auction_serializer.h"
 
 #include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "base/strings/stringprintf.h"
 #include "base/test/metrics/histogram_tester.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
 #include "base/time/time.h"
+#include "components/cbor/reader.h"
+#include "components/cbor/values.h"
+#include "content/browser/interest_group/interest_group_features.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/blink/public/common/interest_group/test_interest_group_builder.h"
@@ -29,6 +38,10 @@ constexpr char kOriginStringD[] = "https://d.test";
 // 256).
 const size_t kBidderOverhead = 1 + 14 + 1 + 1;
 
+// Size of the version/compression byte and message length before the CBOR
+// message in a request.
+const size_t kFramingHeaderSize = 5;
+
 StorageInterestGroup MakeInterestGroup(blink::InterestGroup interest_group) {
   // Create fake previous wins. The time of these wins is ignored, since the
   // InterestGroupManager attaches the current time when logging a win.
@@ -56,7 +69,12 @@ StorageInterestGroup MakeInterestGroup(blink::InterestGroup interest_group) {
   return storage_group;
 }
 
-scoped_refptr<StorageInterestGroups> CreateInterestGroups(url::Origin owner) {
+// Creates the `num_groups` highest priority groups out of the 100 groups
+// created by default, so smaller sets are always a prefix of larger ones once
+// sorted by priority.
+scoped_refptr<StorageInterestGroups> CreateInterestGroups(
+    url::Origin owner,
+    int num_groups = 100) {
   std::vector<blink::InterestGroup::Ad> ads;
   for (int i = 0; i < 100; i++) {
     ads.emplace_back(
@@ -68,7 +86,7 @@ scoped_refptr<StorageInterestGroups> CreateInterestGroups(url::Origin owner) {
         /*ad_render_id=*/base::StringPrintf("%03i", i));
   }
   std::vector<StorageInterestGroup> groups;
-  for (int i = 0; i < 100; i++) {
+  for (int i = 100 - num_groups; i < 100; i++) {
     groups.emplace_back(MakeInterestGroup(
         blink::TestInterestGroupBuilder(owner, base::StringPrintf("%03i", i))
             .SetBiddingUrl(owner.GetURL().Resolve("/bidding_script.js"))
@@ -79,6 +97,40 @@ scoped_refptr<StorageInterestGroups> CreateInterestGroups(url::Origin owner) {
   return base::MakeRefCounted<StorageInterestGroups>(std::move(groups));
 }
 
+// Parses `request`, checking that the CBOR message fits inside it, and returns
+// the size of each bidder's compressed interest groups keyed by bidder origin.
+std::map<std::string, size_t> GetCompressedGroupsSizes(
+    const std::vector<uint8_t>& request) {
+  std::map<std::string, size_t> sizes;
+  if (request.size() < kFramingHeaderSize) {
+    ADD_FAILURE() << "Request too small: " << request.size();
+    return sizes;
+  }
+  const size_t message_size = (size_t{request[1]} << 24) |
+                              (size_t{request[2]} << 16) |
+                              (size_t{request[3]} << 8) | size_t{request[4]};
+  if (kFramingHeaderSize + message_size > request.size()) {
+    ADD_FAILURE() << "Message of size " << message_size
+                  << " does not fit in request of size " << request.size();
+    return sizes;
+  }
+  std::optional<cbor::Value> message = cbor::Reader::Read(
+      base::span(request).subspan(kFramingHeaderSize, message_size));
+  if (!message || !message->is_map()) {
+    ADD_FAILURE() << "Failed to parse message";
+    return sizes;
+  }
+  auto groups_it = message->GetMap().find(cbor::Value("interestGroups"));
+  if (groups_it == message->GetMap().end() || !groups_it->second.is_map()) {
+    ADD_FAILURE() << "Message has no interestGroups";
+    return sizes;
+  }
+  for (const auto& [bidder, groups] : groups_it->second.GetMap()) {
+    sizes[bidder.GetString()] = groups.GetBytestring().size();
+  }
+  return sizes;
+}
+
 class BiddingAndAuctionSerializerTest : public testing::Test {
  public:
   void AddGroupsToSerializer(BiddingAndAuctionSerializer& serializer) {
@@ -87,7 +139,31 @@ class BiddingAndAuctionSerializerTest : public testing::Test {
     }
   }
 
+  // Returns the compressed size of `owner`'s `num_groups` highest priority
+  // groups when serialized without any size limit for the owner.
+  size_t GetUnlimitedCompressedGroupsSize(const url::Origin& owner,
+                                          int num_groups) {
+    BiddingAndAuctionSerializer serializer;
+    serializer.SetPublisher("foo");
+    serializer.SetGenerationId(base::Uuid::ParseCaseInsensitive(
+        "00000000-0000-0000-0000-000000000000"));
+    serializer.SetTimestamp(base::Time::FromMillisecondsSinceUnixEpoch(0));
+    serializer.SetConfig(blink::mojom::AuctionDataConfig::New());
+    serializer.SetDebugReportInLockout(false);
+    serializer.AddGroups(owner, CreateInterestGroups(owner, num_groups));
+
+    BiddingAndAuctionData data = serializer.Build();
+    EXPECT_EQ(static_cast<size_t>(num_groups),
+              data.group_names[owner].size());
+    return GetCompressedGroupsSizes(data.request)[owner.Serialize()];
+  }
+
  protected:
+  // Mock time keeps the previous win times of groups created at different
+  // points of a test identical.
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+
   const GURL kUrlA = GURL(kOriginStringA);
   const url::Origin kOriginA = url::Origin::Create(kUrlA);
   const GURL kUrlB = GURL(kOriginStringB);
@@ -360,6 +436,71 @@ TEST_F(BiddingAndAuctionSerializerTest, SerializeWithFixedSizeGroups) {
       "Ads.InterestGroup.ServerAuction.Request.NumGroups", 95, 1);
 }
 
+// Same as above, but with exact request sizing. Every buyer's groups still need
+// to fit in the fixed size request.
+TEST_F(BiddingAndAuctionSerializerTest,
+       SerializeWithFixedSizeGroupsExactRequestSizing) {
+  base::test::ScopedFeatureList feature_list(
+      features::kEnableBandAExactRequestSizing);
+  base::HistogramTester histogram_tester;
+
+  const size_t kRequestSize = 3000;
+  blink::mojom::AuctionDataConfigPtr config =
+      blink::mojom::AuctionDataConfig::New();
+  config->request_size = kRequestSize;
+
+  config->per_buyer_configs[kOriginA] =
+      blink::mojom::AuctionDataBuyerConfig::New(/*size=*/100);
+  config->per_buyer_configs[kOriginB] =
+      blink::mojom::AuctionDataBuyerConfig::New(/*size=*/100);
+  config->per_buyer_configs[kOriginC] =
+      blink::mojom::AuctionDataBuyerConfig::New(/*size=*/100);
+  config->per_buyer_configs[kOriginD] =
+      blink::mojom::AuctionDataBuyerConfig::New();
+
+  BiddingAndAuctionSerializer serializer;
+  serializer.SetPublisher("foo");
+  serializer.SetGenerationId(
+      base::Uuid::ParseCaseInsensitive("00000000-0000-0000-0000-000000000000"));
+  serializer.SetTimestamp(base::Time::FromMillisecondsSinceUnixEpoch(0));
+  serializer.SetConfig(std::move(config));
+  serializer.SetDebugReportInLockout(false);
+
+  AddGroupsToSerializer(serializer);
+
+  BiddingAndAuctionData data = serializer.Build();
+  EXPECT_EQ(data.request.size(), kRequestSize - kEncryptionOverhead);
+  histogram_tester.ExpectTotalCount(
+      "Ads.InterestGroup.ServerAuction.Request.NumIterations", 4);
+
+  size_t num_groups = 0;
+  for (const auto& [owner, names] : data.group_names) {
+    num_groups += names.size();
+  }
+  histogram_tester.ExpectUniqueSample(
+      "Ads.InterestGroup.ServerAuction.Request.NumGroups", num_groups, 1);
+
+  // The message fits in the request, and each fixed size buyer keeps exactly
+  // as many of its highest priority groups as fit in its size: one more group
+  // would overflow it.
+  std::map<std::string, size_t> compressed_sizes =
+      GetCompressedGroupsSizes(data.request);
+  const size_t kBuyerSize = 100;
+  for (const auto& owner : {kOriginA, kOriginB, kOriginC}) {
+    SCOPED_TRACE(owner.Serialize());
+    const size_t num_owner_groups = data.group_names[owner].size();
+    if (num_owner_groups > 0) {
+      EXPECT_LE(compressed_sizes[owner.Serialize()] + kBidderOverhead,
+                kBuyerSize);
+    }
+    ASSERT_LT(num_owner_groups, 100u);
+    EXPECT_GT(GetUnlimitedCompressedGroupsSize(
+                  owner, static_cast<int>(num_owner_groups) + 1) +
+                  kBidderOverhead,
+              kBuyerSize);
+  }
+}
+
 // Test that the encrypted request still has the full size even when the
 // specified buyers are not on the device.
 TEST_F(BiddingAndAuctionSerializerTest, SerializeWithNoGroupsSetBuyersFixed) {
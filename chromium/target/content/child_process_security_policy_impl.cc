@@ -264,6 +264,41 @@ base::WeakPtr<ResourceContext> GetResourceContext(
   return resource_context ? resource_context->GetWeakPtr() : nullptr;
 }
 
+// Returns the paths whose grants determine a process's permissions for `file`,
+// in the order they must be consulted: `file` itself, then each of its
+// ancestors, with "." and ".." components resolved. This is computed before
+// acquiring the policy lock, so that the locked part of a file permission check
+// only consists of map lookups.
+std::vector<base::FilePath> GetFilePermissionLookupPaths(
+    const base::FilePath& file) {
+  std::vector<base::FilePath> lookup_paths;
+#if BUILDFLAG(IS_ANDROID)
+  if (file.IsContentUri()) {
+    return lookup_paths;
+  }
+#endif
+  if (file.empty() || !file.IsAbsolute()) {
+    return lookup_paths;
+  }
+  base::FilePath current_path = file.StripTrailingSeparators();
+  base::FilePath last_path;
+  int skip = 0;
+  while (current_path != last_path) {
+    base::FilePath base_name = current_path.BaseName();
+    if (base_name.value() == base::FilePath::kParentDirectory) {
+      ++skip;
+    } else if (skip > 0) {
+      if (base_name.value() != base::FilePath::kCurrentDirectory)
+        --skip;
+    } else {
+      lookup_paths.push_back(current_path);
+    }
+    last_path = current_path;
+    current_path = current_path.DirName();
+  }
+  return lookup_paths;
+}
+
 }  // namespace
 
 ChildProcessSecurityPolicyImpl::Handle::Handle()
@@ -559,7 +594,9 @@ class ChildProcessSecurityPolicyImpl::SecurityState {
   }
 
   // Determine whether permission has been granted to commit |url|.
-  bool CanCommitURL(const GURL& url) {
+  // `origin` must be `url::Origin::Create(url)`. Callers compute it before
+  // acquiring the policy lock.
+  bool CanCommitURL(const GURL& url, const url::Origin& origin) {
     DCHECK(!url.SchemeIsBlob() && !url.SchemeIsFileSystem())
         << "inner_url extraction should be done already.";
     // Having permission to a scheme implies permission to all of its URLs.
@@ -570,13 +607,15 @@ class ChildProcessSecurityPolicyImpl::SecurityState {
     }
 
     // Check for permission for specific origin.
-    if (CanCommitOrigin(url::Origin::Create(url)))
+    if (CanCommitOrigin(origin))
       return true;
 
     return false;  // Unmentioned schemes are disallowed.
   }
 
-  bool CanRequestURL(const GURL& url) {
+  // `origin` must be `url::Origin::Create(url)`. Callers compute it before
+  // acquiring the policy lock.
+  bool CanRequestURL(const GURL& url, const url::Origin& origin) {
     DCHECK(!url.SchemeIsBlob() && !url.SchemeIsFileSystem())
         << "inner_url extraction should be done already.";
     // Having permission to a scheme implies permission to all of its URLs.
@@ -584,7 +623,7 @@ class ChildProcessSecurityPolicyImpl::SecurityState {
     if (scheme_judgment != scheme_map_.end())
       return true;
 
-    if (CanRequestOrigin(url::Origin::Create(url)))
+    if (CanRequestOrigin(origin))
       return true;
 
     // file:// URLs may sometimes be more granular, e.g. dragging and dropping a
@@ -605,35 +644,24 @@ class ChildProcessSecurityPolicyImpl::SecurityState {
 #endif
 
     // Otherwise, delegate to CanCommitURL. Unmentioned schemes are disallowed.
-    // TODO(dcheng): It would be nice to avoid constructing the origin twice.
-    return CanCommitURL(url);
+    return CanCommitURL(url, origin);
   }
 
   // Determine if the certain permissions have been granted to a file.
-  bool HasPermissionsForFile(const base::FilePath& file, int permissions) {
+  // `lookup_paths` must be GetFilePermissionLookupPaths(file).
+  bool HasPermissionsForFile(const base::FilePath& file,
+                             const std::vector<base::FilePath>& lookup_paths,
+                             int permissions) {
 #if BUILDFLAG(IS_ANDROID)
     if (file.IsContentUri())
       return HasPermissionsForContentUri(file, permissions);
 #endif
-    if (!permissions || file.empty() || !file.IsAbsolute())
+    if (!permissions)
       return false;
-    base::FilePath current_path = file.StripTrailingSeparators();
-    base::FilePath last_path;
-    int skip = 0;
-    while (current_path != last_path) {
-      base::FilePath base_name = current_path.BaseName();
-      if (base_name.value() == base::FilePath::kParentDirectory) {
-        ++skip;
-      } else if (skip > 0) {
-        if (base_name.value() != base::FilePath::kCurrentDirectory)
-          --skip;
-      } else {
-        FileMap::const_iterator it = file_permissions_.find(current_path);
-        if (it != file_permissions_.end())
-          return (it->second & permissions) == permissions;
-      }
-      last_path = current_path;
-      current_path = current_path.DirName();
+    for (const base::FilePath& path : lookup_paths) {
+      FileMap::const_iterator it = file_permissions_.find(path);
+      if (it != file_permissions_.end())
+        return (it->second & permissions) == permissions;
     }
 
     return false;
@@ -1379,6 +1407,9 @@ bool ChildProcessSecurityPolicyImpl::CanRequestURL(
     return true;
 
   {
+    // Create the origin before acquiring `lock_`, to keep the time it's held
+    // to a minimum.
+    const url::Origin origin = url::Origin::Create(url);
     base::AutoLock lock(lock_);
 
     auto state = security_state_.find(child_id);
@@ -1387,7 +1418,7 @@ bool ChildProcessSecurityPolicyImpl::CanRequestURL(
 
     // Otherwise, we consult the child process's security state to see if it is
     // allowed to request the URL.
-    if (state->second->CanRequestURL(url))
+    if (state->second->CanRequestURL(url, origin))
       return true;
   }
 
@@ -1499,22 +1530,26 @@ bool ChildProcessSecurityPolicyImpl::CanCommitURL(int child_id,
     return false;
   }
 
+  // Most schemes can commit in any process. Note that we check
+  // schemes_okay_to_commit_in_any_process_ here, which is stricter than
+  // IsWebSafeScheme(). This only needs `schemes_lock_`, so it's done before
+  // acquiring `lock_`.
+  //
+  // TODO(creis, nick): https://crbug.com/515309: The line below does not
+  // enforce that http pages cannot commit in an extension process.
+  {
+    base::AutoLock schemes_lock(schemes_lock_);
+    if (base::Contains(schemes_okay_to_commit_in_any_process_, scheme)) {
+      return true;
+    }
+  }
+
   {
+    // Create the origin before acquiring `lock_`, to keep the time it's held
+    // to a minimum.
+    const url::Origin origin = url::Origin::Create(url);
     base::AutoLock lock(lock_);
 
-    // Most schemes can commit in any process. Note that we check
-    // schemes_okay_to_commit_in_any_process_ here, which is stricter than
-    // IsWebSafeScheme().
-    //
-    // TODO(creis, nick): https://crbug.com/515309: The line below does not
-    // enforce that http pages cannot commit in an extension process.
-    {
-      base::AutoLock schemes_lock(schemes_lock_);
-      if (base::Contains(schemes_okay_to_commit_in_any_process_, scheme)) {
-        return true;
-      }
-    }
-
     auto* state = GetSecurityState(child_id);
     if (!state) {
       LogCanCommitUrlFailureReason("no_security_state_found");
@@ -1523,7 +1558,7 @@ bool ChildProcessSecurityPolicyImpl::CanCommitURL(int child_id,
 
     // Otherwise, we consult the child process's security state to see if it is
     // allowed to commit the URL.
-    bool can_commit = state->CanCommitURL(url);
+    bool can_commit = state->CanCommitURL(url, origin);
     if (!can_commit) {
       LogCanCommitUrlFailureReason("cpsp_state_cannot_commit_url");
     }
@@ -1618,8 +1653,11 @@ bool ChildProcessSecurityPolicyImpl::CanDeleteFromFileSystem(
 
 bool ChildProcessSecurityPolicyImpl::HasPermissionsForFile(
     int child_id, const base::FilePath& file, int permissions) {
+  const std::vector<base::FilePath> lookup_paths =
+      GetFilePermissionLookupPaths(file);
   base::AutoLock lock(lock_);
-  return ChildProcessHasPermissionsForFile(child_id, file, permissions);
+  return ChildProcessHasPermissionsForFile(child_id, file, lookup_paths,
+                                           permissions);
 }
 
 bool ChildProcessSecurityPolicyImpl::HasPermissionsForFileSystemFile(
@@ -1762,11 +1800,14 @@ bool ChildProcessSecurityPolicyImpl::CanReadRawCookies(int child_id) {
 }
 
 bool ChildProcessSecurityPolicyImpl::ChildProcessHasPermissionsForFile(
-    int child_id, const base::FilePath& file, int permissions) {
+    int child_id,
+    const base::FilePath& file,
+    const std::vector<base::FilePath>& lookup_paths,
+    int permissions) {
   auto* state = GetSecurityState(child_id);
   if (!state)
     return false;
-  return state->HasPermissionsForFile(file, permissions);
+  return state->HasPermissionsForFile(file, lookup_paths, permissions);
 }
 
 size_t ChildProcessSecurityPolicyImpl::BrowsingInstanceIdCountForTesting(
@@ -797,11 +797,14 @@ class CONTENT_EXPORT ChildProcessSecurityPolicyImpl
   friend struct base::DefaultSingletonTraits<ChildProcessSecurityPolicyImpl>;
 
   // Determines if certain permissions were granted for a file to given child
-  // process. |permissions| is an internally defined bit-set.
-  bool ChildProcessHasPermissionsForFile(int child_id,
-                                         const base::FilePath& file,
-                                         int permissions)
-      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // process. |permissions| is an internally defined bit-set. |lookup_paths|
+  // are the paths whose grants apply to |file|, computed by the caller before
+  // acquiring |lock_|.
+  bool ChildProcessHasPermissionsForFile(
+      int child_id,
+      const base::FilePath& file,
+      const std::vector<base::FilePath>& lookup_paths,
+      int permissions) EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
   // Grant a particular permission set for a file. |permissions| is an
   // internally defined bit-set.
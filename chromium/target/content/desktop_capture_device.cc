@@ -9,25 +9,34 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <utility>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
 #include "base/feature_list.h"
 #include "base/functional/bind.h"
+#include "base/functional/function_ref.h"
 #include "base/location.h"
 #include "base/memory/raw_ptr.h"
 #include "base/message_loop/message_pump_type.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/notreached.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/synchronization/lock.h"
+#include "base/task/post_job.h"
 #include "base/task/single_thread_task_runner.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/time/tick_clock.h"
+#include "base/timer/elapsed_timer.h"
 #include "base/timer/timer.h"
 #include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
@@ -53,12 +62,31 @@
 #include "third_party/webrtc/modules/desktop_capture/desktop_capture_types.h"
 #include "third_party/webrtc/modules/desktop_capture/desktop_capturer.h"
 #include "third_party/webrtc/modules/desktop_capture/desktop_frame.h"
+#include "third_party/webrtc/modules/desktop_capture/desktop_region.h"
 #include "third_party/webrtc/modules/desktop_capture/fake_desktop_capturer.h"
 #include "third_party/webrtc/modules/desktop_capture/mouse_cursor_monitor.h"
 #include "ui/gfx/icc_profile.h"
 
 namespace content {
 
+BASE_FEATURE(kDesktopCaptureIncrementalConversion,
+             "DesktopCaptureIncrementalConversion",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+const base::FeatureParam<double>
+    kDesktopCaptureIncrementalConversionMaxUpdatedArea{
+        &kDesktopCaptureIncrementalConversion, "max_updated_area", 0.5};
+
+BASE_FEATURE(kDesktopCaptureTiledConversion,
+             "DesktopCaptureTiledConversion",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+const base::FeatureParam<int> kDesktopCaptureTiledConversionMaxThreads{
+    &kDesktopCaptureTiledConversion, "max_threads", 4};
+
+const base::FeatureParam<int> kDesktopCaptureTiledConversionMinPixels{
+    &kDesktopCaptureTiledConversion, "min_pixels", 2560 * 1440};
+
 namespace {
 
 // Maximum CPU time percentage of a single core that can be consumed for desktop
@@ -96,11 +124,260 @@ webrtc::DesktopRect ComputeLetterboxRect(
       result.x(), result.y(), result.right(), result.bottom());
 }
 
+// Returns the letterbox rect of |source_size| within |max_size| with all edges
+// at even offsets, as required by the subsampled U and V planes of I420.
+webrtc::DesktopRect ComputeI420LetterboxRect(
+    const webrtc::DesktopSize& max_size,
+    const webrtc::DesktopSize& source_size) {
+  webrtc::DesktopRect rect = ComputeLetterboxRect(max_size, source_size);
+  if ((rect.top() & 1) || (rect.left() & 1)) {
+    rect.Translate(-(rect.left() & 1), -(rect.top() & 1));
+  }
+  if ((rect.bottom() & 1) || (rect.right() & 1)) {
+    rect.Extend(0, 0, rect.right() & 1, rect.bottom() & 1);
+  }
+  return rect;
+}
+
 bool IsFrameUnpackedOrInverted(webrtc::DesktopFrame* frame) {
   return frame->stride() !=
       frame->size().width() * webrtc::DesktopFrame::kBytesPerPixel;
 }
 
+// Pointers to, and strides of, the planes of an I420 image.
+struct I420Planes {
+  // Returns the planes of the image which starts at (|x|, |y|) of this one.
+  // Both coordinates must be even.
+  I420Planes Offset(int x, int y) const {
+    DCHECK_EQ(x & 1, 0);
+    DCHECK_EQ(y & 1, 0);
+    // SAFETY: libyuv interface requires raw pointers. Callers only offset
+    // within the image the planes were created for.
+    return {UNSAFE_BUFFERS(y_plane + x + y * stride_y),
+            UNSAFE_BUFFERS(u_plane + x / 2 + (y / 2) * stride_uv),
+            UNSAFE_BUFFERS(v_plane + x / 2 + (y / 2) * stride_uv), stride_y,
+            stride_uv};
+  }
+
+  uint8_t* y_plane;
+  uint8_t* u_plane;
+  uint8_t* v_plane;
+  int stride_y;
+  int stride_uv;
+};
+
+// Returns the planes of a packed |width| x |height| I420 image at |data|.
+// |data| must be large enough to hold the image.
+I420Planes GetPackedI420Planes(uint8_t* data, int width, int height) {
+  const int plane_size_y = width * height;
+  const int plane_size_uv = (width / 2) * (height / 2);
+  // SAFETY: libyuv interface requires raw pointers. |data| holds a packed
+  // I420 image of the given size.
+  return {data, UNSAFE_BUFFERS(data + plane_size_y),
+          UNSAFE_BUFFERS(data + plane_size_y + plane_size_uv), width,
+          width / 2};
+}
+
+size_t GetPackedI420Size(int width, int height) {
+  return width * height + 2 * (width / 2) * (height / 2);
+}
+
+// Describes where scaling from a source size to an output size is exact:
+// source coordinates that are multiples of a source period map to integer
+// output coordinates, in the Y plane as well as in the subsampled U and V
+// planes. Where ComputeScaleGrid() returns a grid, scaling a grid-aligned part
+// of the source produces the same pixels as scaling the whole source.
+struct ScaleGrid {
+  int source_period_x;
+  int source_period_y;
+  int output_period_x;
+  int output_period_y;
+
+  int ToOutputX(int x) const { return x / source_period_x * output_period_x; }
+  int ToOutputY(int y) const { return y / source_period_y * output_period_y; }
+};
+
+// Returns true if libyuv, which steps through the source in 16.16 fixed
+// point, lands exactly on every grid point when scaling |source_period| to
+// |output_period|. Otherwise the rounding error accumulates differently when
+// a part of the source is scaled on its own.
+bool IsFixedPointScaleStepExact(int source_period, int output_period) {
+  return (static_cast<int64_t>(source_period) << 16) % output_period == 0;
+}
+
+// Both sizes must be even and non-empty. Returns std::nullopt if scaling parts
+// of the source on their own cannot reproduce a scale of the whole source.
+std::optional<ScaleGrid> ComputeScaleGrid(
+    const webrtc::DesktopSize& source_size,
+    const webrtc::DesktopSize& output_size) {
+  const int gcd_x = std::gcd(source_size.width(), output_size.width());
+  const int gcd_y = std::gcd(source_size.height(), output_size.height());
+  // The U and V planes have half the resolution, so one grid cell spans two
+  // of the cells of the Y plane.
+  const ScaleGrid grid = {
+      2 * source_size.width() / gcd_x, 2 * source_size.height() / gcd_y,
+      2 * output_size.width() / gcd_x, 2 * output_size.height() / gcd_y};
+  if (!IsFixedPointScaleStepExact(grid.source_period_x,
+                                  grid.output_period_x) ||
+      !IsFixedPointScaleStepExact(grid.source_period_y,
+                                  grid.output_period_y)) {
+    return std::nullopt;
+  }
+  return grid;
+}
+
+// Returns the parts of |source_size| touched by |region|, expanded to whole
+// cells of |grid|.
+webrtc::DesktopRegion AlignRegionToScaleGrid(
+    const webrtc::DesktopRegion& region,
+    const webrtc::DesktopSize& source_size,
+    const ScaleGrid& grid) {
+  webrtc::DesktopRegion result;
+  for (webrtc::DesktopRegion::Iterator it(region); !it.IsAtEnd();
+       it.Advance()) {
+    webrtc::DesktopRect rect = it.rect();
+    rect.IntersectWith(webrtc::DesktopRect::MakeSize(source_size));
+    if (rect.is_empty()) {
+      continue;
+    }
+    const int right = rect.right() + grid.source_period_x - 1;
+    const int bottom = rect.bottom() + grid.source_period_y - 1;
+    result.AddRect(webrtc::DesktopRect::MakeLTRB(
+        rect.left() / grid.source_period_x * grid.source_period_x,
+        rect.top() / grid.source_period_y * grid.source_period_y,
+        std::min(right / grid.source_period_x * grid.source_period_x,
+                 source_size.width()),
+        std::min(bottom / grid.source_period_y * grid.source_period_y,
+                 source_size.height())));
+  }
+  return result;
+}
+
+// Splits |source_size| into at most |max_bands| full-width bands with edges on
+// |grid|.
+std::vector<webrtc::DesktopRect> SplitIntoBands(
+    const webrtc::DesktopSize& source_size,
+    const ScaleGrid& grid,
+    int max_bands) {
+  const int grid_rows = source_size.height() / grid.source_period_y;
+  const int rows_per_band =
+      std::max(1, (grid_rows + max_bands - 1) / max_bands);
+  std::vector<webrtc::DesktopRect> bands;
+  for (int row = 0; row < grid_rows; row += rows_per_band) {
+    bands.push_back(webrtc::DesktopRect::MakeLTRB(
+        0, row * grid.source_period_y, source_size.width(),
+        std::min(grid_rows, row + rows_per_band) * grid.source_period_y));
+  }
+  return bands;
+}
+
+// Converts |rect| of |frame| into the same part of |dest|. |rect| must have
+// even edges.
+void ConvertRectToI420(const webrtc::DesktopFrame& frame,
+                       const webrtc::DesktopRect& rect,
+                       const I420Planes& dest) {
+  const I420Planes dest_rect = dest.Offset(rect.left(), rect.top());
+  libyuv::ARGBToI420(frame.GetFrameDataAtPos(rect.top_left()), frame.stride(),
+                     dest_rect.y_plane, dest_rect.stride_y, dest_rect.u_plane,
+                     dest_rect.stride_uv, dest_rect.v_plane,
+                     dest_rect.stride_uv, rect.width(), rect.height());
+}
+
+// Scales |rect| of |source|, a |source_size| image, into the matching part of
+// |output|. |rect| must be aligned to |grid|. One grid cell of context around
+// |rect| is scaled along with it, into |scale_buffer|, so that the filter taps
+// at its edges read the same pixels as when scaling all of |source|.
+void ScaleRectWithContext(const I420Planes& source,
+                          const webrtc::DesktopSize& source_size,
+                          const ScaleGrid& grid,
+                          const webrtc::DesktopRect& rect,
+                          const I420Planes& output,
+                          std::vector<uint8_t>& scale_buffer) {
+  webrtc::DesktopRect context = rect;
+  context.Extend(grid.source_period_x, grid.source_period_y,
+                 grid.source_period_x, grid.source_period_y);
+  context.IntersectWith(webrtc::DesktopRect::MakeSize(source_size));
+  const int scaled_width = grid.ToOutputX(context.width());
+  const int scaled_height = grid.ToOutputY(context.height());
+  const size_t scale_buffer_size =
+      GetPackedI420Size(scaled_width, scaled_height);
+  if (scale_buffer.size() < scale_buffer_size) {
+    scale_buffer.resize(scale_buffer_size);
+  }
+  const I420Planes scaled_planes =
+      GetPackedI420Planes(scale_buffer.data(), scaled_width, scaled_height);
+  const I420Planes source_context =
+      source.Offset(context.left(), context.top());
+  libyuv::I420Scale(
+      source_context.y_plane, source_context.stride_y, source_context.u_plane,
+      source_context.stride_uv, source_context.v_plane,
+      source_context.stride_uv, context.width(), context.height(),
+      scaled_planes.y_plane, scaled_planes.stride_y, scaled_planes.u_plane,
+      scaled_planes.stride_uv, scaled_planes.v_plane, scaled_planes.stride_uv,
+      scaled_width, scaled_height, libyuv::kFilterBox);
+
+  const I420Planes scaled =
+      scaled_planes.Offset(grid.ToOutputX(rect.left() - context.left()),
+                           grid.ToOutputY(rect.top() - context.top()));
+  const I420Planes dest =
+      output.Offset(grid.ToOutputX(rect.left()), grid.ToOutputY(rect.top()));
+  libyuv::I420Copy(scaled.y_plane, scaled.stride_y, scaled.u_plane,
+                   scaled.stride_uv, scaled.v_plane, scaled.stride_uv,
+                   dest.y_plane, dest.stride_y, dest.u_plane, dest.stride_uv,
+                   dest.v_plane, dest.stride_uv, grid.ToOutputX(rect.width()),
+                   grid.ToOutputY(rect.height()));
+}
+
+// Runs |task| for every index in [0, |count|) and returns once all have run.
+// With |max_concurrency| > 1 the indices are spread over the calling thread
+// and up to |max_concurrency| - 1 thread pool workers.
+void RunForEachIndex(size_t count,
+                     size_t max_concurrency,
+                     base::FunctionRef<void(size_t)> task) {
+  if (max_concurrency <= 1 || count <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next_index{0};
+  base::JobHandle handle = base::PostJob(
+      FROM_HERE, {base::TaskPriority::USER_BLOCKING},
+      base::BindRepeating(
+          [](std::atomic<size_t>* next_index, size_t count,
+             base::FunctionRef<void(size_t)>* task,
+             base::JobDelegate* delegate) {
+            for (size_t i = next_index->fetch_add(1); i < count;
+                 i = next_index->fetch_add(1)) {
+              (*task)(i);
+              if (delegate->ShouldYield()) {
+                return;
+              }
+            }
+          },
+          base::Unretained(&next_index), count, base::Unretained(&task)),
+      base::BindRepeating(
+          [](std::atomic<size_t>* next_index, size_t count,
+             size_t max_concurrency, size_t worker_count) -> size_t {
+            const size_t next = next_index->load();
+            return next < count ? std::min(count - next, max_concurrency) : 0;
+          },
+          base::Unretained(&next_index), count, max_concurrency));
+  // The calling thread contributes until every index has run, so |task| and
+  // |next_index| outlive all uses by the workers.
+  handle.Join();
+}
+
+int64_t GetRegionArea(const webrtc::DesktopRegion& region) {
+  int64_t area = 0;
+  for (webrtc::DesktopRegion::Iterator it(region); !it.IsAtEnd();
+       it.Advance()) {
+    area += static_cast<int64_t>(it.rect().width()) * it.rect().height();
+  }
+  return area;
+}
+
 void BindWakeLockProvider(
     mojo::PendingReceiver<device::mojom::WakeLockProvider> receiver) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
@@ -229,6 +506,14 @@ class DesktopCaptureDevice::Core : public webrtc::DesktopCapturer::Callback {
   // that |CaptureFrame| has already been called at least once before.
   void ScheduleNextCaptureFrame();
 
+  // Converts |frame| to I420 in |temp_buffer_| and scales it into
+  // |output_rect| of |output_frame_|. If the previous frame was converted with
+  // the same geometry, only the parts of |frame| within |updated_region| are
+  // converted and scaled again.
+  void ConvertAndScaleToOutputFrame(const webrtc::DesktopFrame& frame,
+                                    const webrtc::DesktopRegion& updated_region,
+                                    const webrtc::DesktopRect& output_rect);
+
   void RequestWakeLock();
 
   base::TimeTicks NowTicks() const;
@@ -290,6 +575,16 @@ class DesktopCaptureDevice::Core : public webrtc::DesktopCapturer::Callback {
   // Used for conversion to I420 before scaling.
   std::vector<uint8_t> temp_buffer_;
 
+  // True when |temp_buffer_| holds the I420 conversion of the last captured
+  // frame and |output_frame_| holds it scaled into |converted_output_rect_|.
+  // Only then can the next frame be converted incrementally.
+  bool converted_frame_is_valid_ = false;
+  webrtc::DesktopRect converted_output_rect_;
+
+  // Scratch space for scaling parts of a frame, one per concurrently scaled
+  // part.
+  std::vector<std::vector<uint8_t>> scale_buffers_;
+
   // Determines the size of frames to deliver to the |client_|.
   media::CaptureResolutionChooser resolution_chooser_;
 
@@ -529,6 +824,7 @@ void DesktopCaptureDevice::Core::OnCaptureResult(
   // determine the new output size.
   if (!last_frame_size_.equals(frame->size())) {
     output_frame_.reset();
+    converted_frame_is_valid_ = false;
     resolution_chooser_.SetSourceSize(
         gfx::Size(frame->size().width(), frame->size().height()));
     last_frame_size_ = frame->size();
@@ -564,6 +860,7 @@ void DesktopCaptureDevice::Core::OnCaptureResult(
       output_frame_->SetFrameDataToBlack();
       output_frame_is_black_ = true;
     }
+    converted_frame_is_valid_ = false;
   } else {
     // Scaling frame with odd dimensions to even dimensions will cause
     // blurring. See https://crbug.com/737278.
@@ -600,92 +897,9 @@ void DesktopCaptureDevice::Core::OnCaptureResult(
       }
       DCHECK(output_frame_->size().equals(output_size));
 
-      const int temp_width_y = frame->size().width();
-      const int temp_height_y = frame->size().height();
-      const int temp_plane_size_y = temp_width_y * temp_height_y;
-
-      // In I420, U and V planes have half the resolution.
-      const int temp_width_uv = temp_width_y / 2;
-      const int temp_height_uv = temp_height_y / 2;
-      const int temp_plane_size_uv = temp_width_uv * temp_height_uv;
-
-      const size_t i420_buffer_size =
-          temp_plane_size_y + 2 * temp_plane_size_uv;
-      if (temp_buffer_.size() < i420_buffer_size) {
-        temp_buffer_.resize(i420_buffer_size);
-      }
-
-      // SAFETY: libyuv interface requires raw pointers.
-      // temp_buffer_ is allocated to be enough to store I420 frame.
-      uint8_t* temp_buffer_y = temp_buffer_.data();
-      uint8_t* temp_buffer_u =
-          UNSAFE_BUFFERS(temp_buffer_y + temp_plane_size_y);
-      uint8_t* temp_buffer_v =
-          UNSAFE_BUFFERS(temp_buffer_u + temp_plane_size_uv);
-
-      const int temp_stride_y = temp_width_y;
-      const int temp_stride_u = temp_width_uv;
-      const int temp_stride_v = temp_width_uv;
-
-      libyuv::ARGBToI420(frame->data(), frame->stride(), temp_buffer_y,
-                         temp_stride_y, temp_buffer_u, temp_stride_u,
-                         temp_buffer_v, temp_stride_v, frame->size().width(),
-                         frame->size().height());
-
-      webrtc::DesktopRect output_rect =
-          ComputeLetterboxRect(output_size, frame->size());
-
-      // output_rect for I420 format must start and end at even offsets
-      // because of UV planes subsampling.
-      if ((output_rect.top() & 1) || (output_rect.left() & 1)) {
-        output_rect.Translate(-(output_rect.left() & 1),
-                              -(output_rect.top() & 1));
-      }
-      if ((output_rect.bottom() & 1) || (output_rect.right() & 1)) {
-        output_rect.Extend(0, 0, output_rect.right() & 1,
-                           output_rect.bottom() & 1);
-      }
-
-      CHECK_LE(output_rect.right(), output_size.width());
-      CHECK_LE(output_rect.bottom(), output_size.height());
-
-      const int output_width_y = output_size.width();
-      const int output_height_y = output_size.height();
-      const int output_plane_size_y = output_width_y * output_height_y;
-
-      const int output_width_uv = output_width_y / 2;
-      const int output_height_uv = output_height_y / 2;
-      const int output_plane_size_uv = output_width_uv * output_height_uv;
-
-      // Offsets of the top-left pixel for the output rect inside each plane.
-      const int offset_y =
-          output_rect.left() + output_rect.top() * output_width_y;
-      // UV planes have half the resolution, so coordinates are also halved.
-      const int offset_uv =
-          output_rect.left() / 2 + (output_rect.top() / 2) * output_width_uv;
-
-      uint8_t* output_data_base = output_frame_->data();
-
-      // SAFETY: libyuv interface requires raw pointers.
-      // output_frame_ is big enough to store ARGB frame and I420
-      // is smaller.
-      uint8_t* output_y = UNSAFE_BUFFERS(output_data_base + offset_y);
-      uint8_t* output_u =
-          UNSAFE_BUFFERS(output_data_base + output_plane_size_y + offset_uv);
-      uint8_t* output_v =
-          UNSAFE_BUFFERS(output_data_base + output_plane_size_y +
-                         output_plane_size_uv + offset_uv);
-
-      const int output_stride_y = output_width_y;
-      const int output_stride_u = output_width_uv;
-      const int output_stride_v = output_width_uv;
-
-      libyuv::I420Scale(temp_buffer_y, temp_stride_y, temp_buffer_u,
-                        temp_stride_u, temp_buffer_v, temp_stride_v,
-                        frame->size().width(), frame->size().height(), output_y,
-                        output_stride_y, output_u, output_stride_u, output_v,
-                        output_stride_v, output_rect.width(),
-                        output_rect.height(), libyuv::kFilterBox);
+      ConvertAndScaleToOutputFrame(
+          *frame, frame->updated_region(),
+          ComputeI420LetterboxRect(output_size, frame->size()));
       output_is_i420_ = true;
 
       output_data = output_frame_->data();
@@ -704,11 +918,13 @@ void DesktopCaptureDevice::Core::OnCaptureResult(
           webrtc::DesktopRect::MakeSize(frame->size()));
       output_data = output_frame_->data();
       output_frame_is_black_ = false;
+      converted_frame_is_valid_ = false;
     } else {
       // If the captured frame matches the output size, we can return the pixel
       // data directly.
       output_data = frame->data();
       output_frame_is_black_ = false;
+      converted_frame_is_valid_ = false;
     }
   }
 
@@ -820,6 +1036,133 @@ void DesktopCaptureDevice::Core::ScheduleNextCaptureFrame() {
                         &Core::OnCaptureTimer);
 }
 
+void DesktopCaptureDevice::Core::ConvertAndScaleToOutputFrame(
+    const webrtc::DesktopFrame& frame,
+    const webrtc::DesktopRegion& updated_region,
+    const webrtc::DesktopRect& output_rect) {
+  DCHECK(output_frame_);
+  CHECK_LE(output_rect.right(), output_frame_->size().width());
+  CHECK_LE(output_rect.bottom(), output_frame_->size().height());
+  const base::ElapsedThreadTimer timer;
+  const webrtc::DesktopSize& frame_size = frame.size();
+  const int64_t frame_area =
+      static_cast<int64_t>(frame_size.width()) * frame_size.height();
+  const std::optional<ScaleGrid> grid =
+      output_rect.is_empty()
+          ? std::nullopt
+          : ComputeScaleGrid(frame_size, output_rect.size());
+
+  // The rects of |frame| to convert and scale. Empty if the whole frame is
+  // converted and scaled in one go.
+  std::vector<webrtc::DesktopRect> rects;
+  int64_t converted_area = frame_area;
+
+  // Only capturers which support the 0Hz mode keep |updated_region| accurate,
+  // see |zero_hertz_is_supported_|.
+  bool incremental =
+      grid &&
+      base::FeatureList::IsEnabled(kDesktopCaptureIncrementalConversion) &&
+      zero_hertz_is_supported() && converted_frame_is_valid_ &&
+      converted_output_rect_.equals(output_rect);
+  if (incremental) {
+    const webrtc::DesktopRegion aligned_region =
+        AlignRegionToScaleGrid(updated_region, frame_size, *grid);
+    const int64_t aligned_area = GetRegionArea(aligned_region);
+    incremental =
+        aligned_area <=
+        frame_area * kDesktopCaptureIncrementalConversionMaxUpdatedArea.Get();
+    if (incremental) {
+      converted_area = aligned_area;
+      for (webrtc::DesktopRegion::Iterator it(aligned_region); !it.IsAtEnd();
+           it.Advance()) {
+        rects.push_back(it.rect());
+      }
+    }
+  }
+
+  // Large frames which are converted as a whole are split into bands that are
+  // converted and scaled in parallel.
+  size_t max_concurrency = 1;
+  if (!incremental && grid &&
+      base::FeatureList::IsEnabled(kDesktopCaptureTiledConversion) &&
+      frame_area >= kDesktopCaptureTiledConversionMinPixels.Get() &&
+      base::ThreadPoolInstance::Get()) {
+    max_concurrency = std::max(kDesktopCaptureTiledConversionMaxThreads.Get(),
+                               1);
+    // Two bands per thread let threads which finish early pick up more work.
+    rects = SplitIntoBands(frame_size, *grid,
+                           2 * static_cast<int>(max_concurrency));
+    if (rects.size() < 2) {
+      rects.clear();
+      max_concurrency = 1;
+    }
+  }
+  const bool whole_frame = !incremental && rects.empty();
+  if (whole_frame) {
+    rects.push_back(webrtc::DesktopRect::MakeSize(frame_size));
+  }
+
+  const size_t i420_buffer_size =
+      GetPackedI420Size(frame_size.width(), frame_size.height());
+  if (temp_buffer_.size() < i420_buffer_size) {
+    temp_buffer_.resize(i420_buffer_size);
+  }
+  const I420Planes temp_planes = GetPackedI420Planes(
+      temp_buffer_.data(), frame_size.width(), frame_size.height());
+
+  // Convert every rect before scaling any of them, since scaling a rect also
+  // reads the pixels next to it.
+  RunForEachIndex(rects.size(), max_concurrency, [&](size_t i) {
+    ConvertRectToI420(frame, rects[i], temp_planes);
+  });
+
+  // |output_frame_| is big enough to store an ARGB frame and I420 is smaller.
+  const I420Planes output_planes =
+      GetPackedI420Planes(output_frame_->data(), output_frame_->size().width(),
+                          output_frame_->size().height())
+          .Offset(output_rect.left(), output_rect.top());
+
+  if (whole_frame) {
+    libyuv::I420Scale(
+        temp_planes.y_plane, temp_planes.stride_y, temp_planes.u_plane,
+        temp_planes.stride_uv, temp_planes.v_plane, temp_planes.stride_uv,
+        frame_size.width(), frame_size.height(), output_planes.y_plane,
+        output_planes.stride_y, output_planes.u_plane,
+        output_planes.stride_uv, output_planes.v_plane,
+        output_planes.stride_uv, output_rect.width(), output_rect.height(),
+        libyuv::kFilterBox);
+  } else {
+    // Bands which are scaled in parallel each get their own scratch space.
+    const size_t scale_buffer_count = max_concurrency > 1 ? rects.size() : 1;
+    if (scale_buffers_.size() < scale_buffer_count) {
+      scale_buffers_.resize(scale_buffer_count);
+    }
+    RunForEachIndex(rects.size(), max_concurrency, [&](size_t i) {
+      ScaleRectWithContext(temp_planes, frame_size, *grid, rects[i],
+                           output_planes,
+                           scale_buffers_[std::min(i, scale_buffer_count - 1)]);
+    });
+  }
+  converted_frame_is_valid_ = true;
+  converted_output_rect_ = output_rect;
+
+  UMA_HISTOGRAM_PERCENTAGE(
+      "WebRTC.DesktopCapture.ConvertedAreaPercentage",
+      base::saturated_cast<int>(100 * converted_area /
+                                std::max<int64_t>(frame_area, 1)));
+  if (max_concurrency > 1) {
+    UMA_HISTOGRAM_COUNTS_100("WebRTC.DesktopCapture.ConversionBandCount",
+                             rects.size());
+  } else if (timer.is_supported()) {
+    // The CPU time of the calling thread alone would understate the cost of a
+    // conversion which is spread over several threads.
+    base::UmaHistogramCustomMicrosecondsTimes(
+        incremental ? "WebRTC.DesktopCapture.ConversionCpuTime.Incremental"
+                    : "WebRTC.DesktopCapture.ConversionCpuTime.Full",
+        timer.Elapsed(), base::Microseconds(1), base::Milliseconds(100), 50);
+  }
+}
+
 void DesktopCaptureDevice::Core::RequestWakeLock() {
   mojo::Remote<device::mojom::WakeLockProvider> wake_lock_provider;
   auto receiver = wake_lock_provider.BindNewPipeAndPassReceiver();
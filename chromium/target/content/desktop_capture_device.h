@@ -7,7 +7,9 @@
 
 #include <memory>
 
+#include "base/feature_list.h"
 #include "base/memory/ref_counted.h"
+#include "base/metrics/field_trial_params.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/threading/thread.h"
 #include "base/time/time.h"
@@ -27,6 +29,29 @@ class DesktopCapturer;
 
 namespace content {
 
+// When enabled, the scaled I420 output is kept across captures and only the
+// parts of each frame that the capturer reports as updated are converted and
+// scaled again.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kDesktopCaptureIncrementalConversion);
+
+// Fraction of the frame area above which an updated frame is converted in full
+// rather than region by region.
+CONTENT_EXPORT extern const base::FeatureParam<double>
+    kDesktopCaptureIncrementalConversionMaxUpdatedArea;
+
+// When enabled, large frames which are converted and scaled as a whole are
+// split into horizontal bands that are processed on thread pool workers. The
+// output is identical to that of the single-threaded path.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kDesktopCaptureTiledConversion);
+
+// Maximum number of threads, including the capture thread, to use.
+CONTENT_EXPORT extern const base::FeatureParam<int>
+    kDesktopCaptureTiledConversionMaxThreads;
+
+// Frames with fewer pixels than this are converted on the capture thread.
+CONTENT_EXPORT extern const base::FeatureParam<int>
+    kDesktopCaptureTiledConversionMinPixels;
+
 // DesktopCaptureDevice implements VideoCaptureDevice for screens and windows.
 // It's essentially an adapter between webrtc::DesktopCapturer and
 // VideoCaptureDevice, i.e. it employs the third-party WebRTC code to use native
@@ -27,6 +27,8 @@
 #include "base/synchronization/waitable_event.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/test/metrics/histogram_tester.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/test/task_environment.h"
 #include "base/test/test_mock_time_task_runner.h"
 #include "base/test/test_timeouts.h"
 #include "base/time/tick_clock.h"
@@ -35,6 +37,8 @@
 #include "media/capture/video/mock_video_capture_device_client.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/libyuv/include/libyuv/convert.h"
+#include "third_party/libyuv/include/libyuv/scale.h"
 #include "third_party/webrtc/modules/desktop_capture/desktop_capture_options.h"
 #include "third_party/webrtc/modules/desktop_capture/desktop_capturer.h"
 #include "third_party/webrtc/modules/desktop_capture/desktop_frame.h"
@@ -54,6 +58,7 @@ using ::testing::InvokeWithoutArgs;
 using ::testing::NiceMock;
 using ::testing::SaveArg;
 using ::testing::WithArg;
+using ::testing::WithArgs;
 
 namespace content {
 
@@ -246,6 +251,87 @@ class FakeScreenCapturer : public webrtc::DesktopCapturer {
   base::WeakPtrFactory<FakeScreenCapturer> weak_factory_{this};
 };
 
+// Capturer of a screen in which a small rect is repainted before every frame
+// but the first. Only the repainted rect is reported as updated, like capturers
+// which track damage do.
+class PartiallyUpdatedScreenCapturer : public webrtc::DesktopCapturer {
+ public:
+  explicit PartiallyUpdatedScreenCapturer(const webrtc::DesktopSize& size)
+      : screen_(size) {
+    for (int y = 0; y < size.height(); ++y) {
+      uint8_t* row = screen_.GetFrameDataAtPos(webrtc::DesktopVector(0, y));
+      for (int i = 0; i < screen_.stride(); ++i) {
+        row[i] = static_cast<uint8_t>(i * 7 + y * 13);
+      }
+    }
+  }
+
+  // Returns the content of the most recently captured frame.
+  const webrtc::DesktopFrame& screen() const { return screen_; }
+
+  // DesktopCapturer interface.
+  void Start(Callback* callback) override { callback_ = callback; }
+
+  void CaptureFrame() override {
+    webrtc::DesktopRect updated_rect =
+        webrtc::DesktopRect::MakeSize(screen_.size());
+    if (captured_frames_ > 0) {
+      // Odd sizes and offsets exercise the alignment to the scaling grid.
+      updated_rect = webrtc::DesktopRect::MakeXYWH(
+          (37 * captured_frames_) % (screen_.size().width() - 31),
+          23 + captured_frames_, 31, 17);
+      for (int y = updated_rect.top(); y < updated_rect.bottom(); ++y) {
+        memset(screen_.GetFrameDataAtPos(
+                   webrtc::DesktopVector(updated_rect.left(), y)),
+               50 * captured_frames_,
+               updated_rect.width() * webrtc::DesktopFrame::kBytesPerPixel);
+      }
+    }
+    captured_frames_++;
+
+    std::unique_ptr<webrtc::DesktopFrame> frame =
+        webrtc::BasicDesktopFrame::CopyOf(screen_);
+    frame->set_device_scale_factor(2.0f);
+    frame->mutable_updated_region()->SetRect(updated_rect);
+    callback_->OnCaptureResult(webrtc::DesktopCapturer::Result::SUCCESS,
+                               std::move(frame));
+  }
+
+  bool GetSourceList(SourceList* screens) override { return false; }
+
+  bool SelectSource(SourceId id) override { return false; }
+
+ private:
+  raw_ptr<Callback> callback_ = nullptr;
+  webrtc::BasicDesktopFrame screen_;
+  int captured_frames_ = 0;
+};
+
+// Returns |frame| converted to I420 and scaled to |output_size| as a whole.
+// The aspect ratio of |frame| must match |output_size|.
+std::vector<uint8_t> ConvertToScaledI420(const webrtc::DesktopFrame& frame,
+                                         const gfx::Size& output_size) {
+  const int width = frame.size().width();
+  const int height = frame.size().height();
+  std::vector<uint8_t> i420(width * height * 3 / 2);
+  uint8_t* y = i420.data();
+  uint8_t* u = y + width * height;
+  uint8_t* v = u + width * height / 4;
+  libyuv::ARGBToI420(frame.data(), frame.stride(), y, width, u, width / 2, v,
+                     width / 2, width, height);
+
+  std::vector<uint8_t> scaled(output_size.GetArea() * 3 / 2);
+  uint8_t* scaled_y = scaled.data();
+  uint8_t* scaled_u = scaled_y + output_size.GetArea();
+  uint8_t* scaled_v = scaled_u + output_size.GetArea() / 4;
+  libyuv::I420Scale(y, width, u, width / 2, v, width / 2, width, height,
+                    scaled_y, output_size.width(), scaled_u,
+                    output_size.width() / 2, scaled_v, output_size.width() / 2,
+                    output_size.width(), output_size.height(),
+                    libyuv::kFilterBox);
+  return scaled;
+}
+
 // Helper used to check that only two specific frame sizes are delivered to the
 // OnIncomingCapturedData() callback.
 class FormatChecker {
@@ -831,6 +917,164 @@ TEST_F(DesktopCaptureDeviceTest,
   capture_device_->StopAndDeAllocate();
 }
 
+// Verifies that frames which are converted and scaled only where they were
+// updated are identical to frames which are converted and scaled as a whole.
+TEST_F(DesktopCaptureDeviceTest, IncrementalConversionMatchesFullConversion) {
+  base::test::ScopedFeatureList feature_list(
+      kDesktopCaptureIncrementalConversion);
+  PartiallyUpdatedScreenCapturer* capturer = new PartiallyUpdatedScreenCapturer(
+      webrtc::DesktopSize(kTestFrameWidth2, kTestFrameHeight2));
+  CreateScreenCaptureDevice(std::unique_ptr<webrtc::DesktopCapturer>(capturer));
+
+  const gfx::Size output_size(kTestFrameWidth2 / 2, kTestFrameHeight2 / 2);
+  base::WaitableEvent done_event(
+      base::WaitableEvent::ResetPolicy::AUTOMATIC,
+      base::WaitableEvent::InitialState::NOT_SIGNALED);
+
+  // Runs on the capture thread, while |capturer| still holds the content of
+  // the delivered frame.
+  int checked_frames = 0;
+  std::unique_ptr<media::MockVideoCaptureDeviceClient> client(
+      CreateMockVideoCaptureDeviceClient());
+  EXPECT_CALL(*client, OnError).Times(0);
+  EXPECT_CALL(*client, OnIncomingCapturedData)
+      .WillRepeatedly(WithArgs<0, 2>(
+          Invoke([&](const uint8_t* data,
+                     const media::VideoCaptureFormat& format) {
+            EXPECT_EQ(media::PIXEL_FORMAT_I420, format.pixel_format);
+            ASSERT_EQ(output_size, format.frame_size);
+            const std::vector<uint8_t> expected =
+                ConvertToScaledI420(capturer->screen(), output_size);
+            EXPECT_EQ(0, memcmp(data, expected.data(), expected.size()))
+                << "Frame #" << checked_frames;
+            checked_frames++;
+            done_event.Signal();
+          })));
+
+  media::VideoCaptureParams capture_params;
+  capture_params.requested_format.frame_size = output_size;
+  capture_params.requested_format.frame_rate = kFrameRate;
+  capture_params.requested_format.pixel_format = media::PIXEL_FORMAT_I420;
+
+  capture_device_->AllocateAndStart(capture_params, std::move(client));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(done_event.TimedWait(TestTimeouts::action_max_timeout()));
+  }
+  capture_device_->StopAndDeAllocate();
+
+  EXPECT_GE(checked_frames, 4);
+  // Only the first frame is converted as a whole.
+  histogram_tester_.ExpectBucketCount(
+      "WebRTC.DesktopCapture.ConvertedAreaPercentage", 100, 1);
+}
+
+// Verifies that frames are still identical to frames which are converted and
+// scaled as a whole when the scale factor can't be stepped through exactly in
+// libyuv's 16.16 fixed point, like 2560x1600 to 1152x720. Such frames have to
+// be converted and scaled in full.
+TEST_F(DesktopCaptureDeviceTest,
+       IncrementalConversionWithInexactScaleMatchesFullConversion) {
+  base::test::ScopedFeatureList feature_list(
+      kDesktopCaptureIncrementalConversion);
+  PartiallyUpdatedScreenCapturer* capturer =
+      new PartiallyUpdatedScreenCapturer(webrtc::DesktopSize(640, 400));
+  CreateScreenCaptureDevice(std::unique_ptr<webrtc::DesktopCapturer>(capturer));
+
+  const gfx::Size output_size(288, 180);
+  base::WaitableEvent done_event(
+      base::WaitableEvent::ResetPolicy::AUTOMATIC,
+      base::WaitableEvent::InitialState::NOT_SIGNALED);
+
+  int checked_frames = 0;
+  std::unique_ptr<media::MockVideoCaptureDeviceClient> client(
+      CreateMockVideoCaptureDeviceClient());
+  EXPECT_CALL(*client, OnError).Times(0);
+  EXPECT_CALL(*client, OnIncomingCapturedData)
+      .WillRepeatedly(WithArgs<0, 2>(
+          Invoke([&](const uint8_t* data,
+                     const media::VideoCaptureFormat& format) {
+            ASSERT_EQ(output_size, format.frame_size);
+            const std::vector<uint8_t> expected =
+                ConvertToScaledI420(capturer->screen(), output_size);
+            EXPECT_EQ(0, memcmp(data, expected.data(), expected.size()))
+                << "Frame #" << checked_frames;
+            checked_frames++;
+            done_event.Signal();
+          })));
+
+  media::VideoCaptureParams capture_params;
+  capture_params.requested_format.frame_size = output_size;
+  capture_params.requested_format.frame_rate = kFrameRate;
+  capture_params.requested_format.pixel_format = media::PIXEL_FORMAT_I420;
+
+  capture_device_->AllocateAndStart(capture_params, std::move(client));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(done_event.TimedWait(TestTimeouts::action_max_timeout()));
+  }
+  capture_device_->StopAndDeAllocate();
+
+  EXPECT_GE(checked_frames, 4);
+  histogram_tester_.ExpectUniqueSample(
+      "WebRTC.DesktopCapture.ConvertedAreaPercentage", 100, checked_frames);
+}
+
+// Provides the thread pool which tiled conversion runs on.
+class DesktopCaptureDeviceTiledConversionTest
+    : public DesktopCaptureDeviceTest {
+ protected:
+  base::test::TaskEnvironment task_environment_;
+};
+
+// Verifies that frames which are converted and scaled in bands on several
+// threads are identical to frames which are converted and scaled as a whole.
+TEST_F(DesktopCaptureDeviceTiledConversionTest, MatchesFullConversion) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeatureWithParameters(
+      kDesktopCaptureTiledConversion,
+      {{"max_threads", "3"}, {"min_pixels", "0"}});
+  PartiallyUpdatedScreenCapturer* capturer = new PartiallyUpdatedScreenCapturer(
+      webrtc::DesktopSize(kTestFrameWidth2, kTestFrameHeight2));
+  CreateScreenCaptureDevice(std::unique_ptr<webrtc::DesktopCapturer>(capturer));
+
+  const gfx::Size output_size(kTestFrameWidth2 / 2, kTestFrameHeight2 / 2);
+  base::WaitableEvent done_event(
+      base::WaitableEvent::ResetPolicy::AUTOMATIC,
+      base::WaitableEvent::InitialState::NOT_SIGNALED);
+
+  int checked_frames = 0;
+  std::unique_ptr<media::MockVideoCaptureDeviceClient> client(
+      CreateMockVideoCaptureDeviceClient());
+  EXPECT_CALL(*client, OnError).Times(0);
+  EXPECT_CALL(*client, OnIncomingCapturedData)
+      .WillRepeatedly(WithArgs<0, 2>(
+          Invoke([&](const uint8_t* data,
+                     const media::VideoCaptureFormat& format) {
+            ASSERT_EQ(output_size, format.frame_size);
+            const std::vector<uint8_t> expected =
+                ConvertToScaledI420(capturer->screen(), output_size);
+            EXPECT_EQ(0, memcmp(data, expected.data(), expected.size()))
+                << "Frame #" << checked_frames;
+            checked_frames++;
+            done_event.Signal();
+          })));
+
+  media::VideoCaptureParams capture_params;
+  capture_params.requested_format.frame_size = output_size;
+  capture_params.requested_format.frame_rate = kFrameRate;
+  capture_params.requested_format.pixel_format = media::PIXEL_FORMAT_I420;
+
+  capture_device_->AllocateAndStart(capture_params, std::move(client));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(done_event.TimedWait(TestTimeouts::action_max_timeout()));
+  }
+  capture_device_->StopAndDeAllocate();
+
+  EXPECT_GE(checked_frames, 3);
+  // Three threads with two bands each.
+  histogram_tester_.ExpectBucketCount(
+      "WebRTC.DesktopCapture.ConversionBandCount", 6, checked_frames);
+}
+
 class DesktopCaptureDeviceThrottledTest : public DesktopCaptureDeviceTest {
  public:
   // Capture frames at kFrameRate for a duration of total_capture_duration and
@@ -34,6 +34,17 @@ bool DevToolsAgentHostClient::UsesBinaryProtocol() {
   return false;
 }
 
+bool DevToolsAgentHostClient::UsesNotificationBatching() {
+  return false;
+}
+
+void DevToolsAgentHostClient::DispatchProtocolMessageBatch(
+    DevToolsAgentHost* agent_host,
+    const std::vector<std::vector<uint8_t>>& messages) {
+  for (const std::vector<uint8_t>& message : messages)
+    DispatchProtocolMessage(agent_host, message);
+}
+
 // Only clients that already have powers of local code execution should override
 // this to true.
 bool DevToolsAgentHostClient::AllowUnsafeOperations() {
@@ -6,6 +6,7 @@
 #define CONTENT_PUBLIC_BROWSER_DEVTOOLS_AGENT_HOST_CLIENT_H_
 
 #include <optional>
+#include <vector>
 
 #include "base/containers/span.h"
 #include "content/common/content_export.h"
@@ -69,6 +70,18 @@ class CONTENT_EXPORT DevToolsAgentHostClient {
   // Determines protocol message format.
   virtual bool UsesBinaryProtocol();
 
+  // Returns true if the client wants notifications generated in the browser
+  // process to be coalesced and delivered via DispatchProtocolMessageBatch().
+  // Each message in a batch is still a complete protocol message.
+  virtual bool UsesNotificationBatching();
+
+  // Dispatches a batch of protocol messages, in order, on the client. Only
+  // called for clients that return true from UsesNotificationBatching().
+  // The default implementation dispatches the messages one by one.
+  virtual void DispatchProtocolMessageBatch(
+      DevToolsAgentHost* agent_host,
+      const std::vector<std::vector<uint8_t>>& messages);
+
   // Returns "DevTools" | "Extension" | "RemoteDebugger" | "Other", which is
   // used to emit to the correct UMA histogram.
   virtual std::string GetTypeForMetrics();
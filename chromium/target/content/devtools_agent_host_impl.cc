@@ -439,8 +439,12 @@ scoped_refptr<DevToolsAgentHost>
 DevToolsAgentHostImpl::ForceDetachAllSessionsImpl() {
   scoped_refptr<DevToolsAgentHost> retain_this(this);
   while (!sessions_.empty()) {
-    DevToolsAgentHostClient* client = (*sessions_.begin())->GetClient();
-    DetachClient(client);
+    DevToolsSession* session = *sessions_.begin();
+    DevToolsAgentHostClient* client = session->GetClient();
+    session->FlushQueuedNotifications();
+    // The client may have detached while receiving the notifications.
+    if (!DetachClient(client))
+      continue;
     client->AgentHostClosed(this);
   }
   return retain_this;
@@ -454,8 +458,13 @@ void DevToolsAgentHostImpl::ForceDetachRestrictedSessions(
   scoped_refptr<DevToolsAgentHostImpl> protect(this);
 
   for (DevToolsSession* session : restricted_sessions) {
+    // Clients may detach while receiving the flushed notifications.
+    if (!base::Contains(sessions_, session))
+      continue;
     DevToolsAgentHostClient* client = session->GetClient();
-    DetachClient(client);
+    session->FlushQueuedNotifications();
+    if (!DetachClient(client))
+      continue;
     client->AgentHostClosed(this);
   }
 }
@@ -4,14 +4,19 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/containers/contains.h"
+#include "base/json/json_reader.h"
 #include "base/location.h"
 #include "base/run_loop.h"
+#include "base/strings/strcat.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/time/time.h"
+#include "base/values.h"
 #include "components/input/input_constants.h"
 #include "content/browser/devtools/devtools_manager.h"
 #include "content/browser/devtools/shared_worker_devtools_manager.h"
@@ -27,6 +32,7 @@
 #include "content/test/test_content_browser_client.h"
 #include "content/test/test_render_view_host.h"
 #include "content/test/test_web_contents.h"
+#include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace content {
@@ -71,6 +77,38 @@ class TestDevToolsClientHost : public DevToolsAgentHostClient {
 
 int TestDevToolsClientHost::close_counter = 0;
 
+class BatchingDevToolsClientHost : public DevToolsAgentHostClient {
+ public:
+  BatchingDevToolsClientHost() = default;
+
+  BatchingDevToolsClientHost(const BatchingDevToolsClientHost&) = delete;
+  BatchingDevToolsClientHost& operator=(const BatchingDevToolsClientHost&) =
+      delete;
+
+  void AgentHostClosed(DevToolsAgentHost* agent_host) override {}
+
+  void DispatchProtocolMessage(DevToolsAgentHost* agent_host,
+                               base::span<const uint8_t> message) override {
+    messages_.emplace_back(base::as_string_view(message));
+  }
+
+  bool UsesNotificationBatching() override { return true; }
+
+  void DispatchProtocolMessageBatch(
+      DevToolsAgentHost* agent_host,
+      const std::vector<std::vector<uint8_t>>& messages) override {
+    batch_sizes_.push_back(messages.size());
+    DevToolsAgentHostClient::DispatchProtocolMessageBatch(agent_host, messages);
+  }
+
+  const std::vector<std::string>& messages() const { return messages_; }
+  const std::vector<size_t>& batch_sizes() const { return batch_sizes_; }
+
+ private:
+  std::vector<std::string> messages_;
+  std::vector<size_t> batch_sizes_;
+};
+
 class TestWebContentsDelegate : public WebContentsDelegate {
  public:
   TestWebContentsDelegate() : renderer_unresponsive_received_(false) {}
@@ -144,6 +182,85 @@ TEST_F(DevToolsAgentHostImplTest, OpenAndManuallyCloseDevToolsClientHost) {
   EXPECT_FALSE(agent->IsAttached());
 }
 
+TEST_F(DevToolsAgentHostImplTest, NotificationBatchingKeepsMessageOrder) {
+  contents()->NavigateAndCommit(GURL("http://www.google.com"));
+  scoped_refptr<DevToolsAgentHost> page_agent(
+      DevToolsAgentHost::GetOrCreateFor(web_contents()));
+  scoped_refptr<DevToolsAgentHost> browser_agent =
+      DevToolsAgentHost::CreateForBrowser(
+          nullptr, DevToolsAgentHost::CreateServerSocketCallback());
+
+  BatchingDevToolsClientHost client_host;
+  browser_agent->AttachClient(&client_host);
+  // Target.targetCreated notifications are sent before the response, and
+  // must be flushed ahead of it.
+  browser_agent->DispatchProtocolMessage(
+      &client_host,
+      base::byte_span_from_cstring("{\"id\":1,\"method\":"
+                                   "\"Target.setDiscoverTargets\","
+                                   "\"params\":{\"discover\":true}}"));
+
+  const std::vector<std::string>& messages = client_host.messages();
+  ASSERT_GE(messages.size(), 2u);
+  for (size_t i = 0; i + 1 < messages.size(); ++i)
+    EXPECT_THAT(messages[i], testing::HasSubstr("Target.targetCreated"));
+  EXPECT_THAT(messages.back(), testing::HasSubstr("\"id\":1"));
+  EXPECT_THAT(client_host.batch_sizes(),
+              testing::ElementsAre(messages.size() - 1));
+
+  browser_agent->DetachClient(&client_host);
+}
+
+TEST_F(DevToolsAgentHostImplTest, NotificationBatchingInFlattenedSession) {
+  contents()->NavigateAndCommit(GURL("http://www.google.com"));
+  scoped_refptr<DevToolsAgentHost> page_agent(
+      DevToolsAgentHost::GetOrCreateFor(web_contents()));
+  scoped_refptr<DevToolsAgentHost> browser_agent =
+      DevToolsAgentHost::CreateForBrowser(
+          nullptr, DevToolsAgentHost::CreateServerSocketCallback());
+
+  BatchingDevToolsClientHost client_host;
+  browser_agent->AttachClient(&client_host);
+  browser_agent->DispatchProtocolMessage(
+      &client_host,
+      base::byte_span_from_cstring(
+          "{\"id\":1,\"method\":\"Target.attachToBrowserTarget\"}"));
+  ASSERT_FALSE(client_host.messages().empty());
+  std::optional<base::Value::Dict> response =
+      base::JSONReader::ReadDict(client_host.messages().back());
+  ASSERT_TRUE(response);
+  ASSERT_EQ(response->FindInt("id"), 1);
+  const std::string* session_id =
+      response->FindStringByDottedPath("result.sessionId");
+  ASSERT_TRUE(session_id);
+
+  // Target.targetCreated notifications of the child session are batched too,
+  // and flushed ahead of the child session's response.
+  const size_t first_message = client_host.messages().size();
+  const size_t first_batch = client_host.batch_sizes().size();
+  std::string message = base::StrCat(
+      {"{\"sessionId\":\"", *session_id,
+       "\",\"id\":2,\"method\":\"Target.setDiscoverTargets\","
+       "\"params\":{\"discover\":true}}"});
+  browser_agent->DispatchProtocolMessage(&client_host,
+                                         base::as_byte_span(message));
+
+  const std::vector<std::string>& messages = client_host.messages();
+  ASSERT_GE(messages.size(), first_message + 2);
+  for (size_t i = first_message; i + 1 < messages.size(); ++i) {
+    EXPECT_THAT(messages[i], testing::HasSubstr("Target.targetCreated"));
+    EXPECT_THAT(messages[i], testing::HasSubstr(*session_id));
+  }
+  EXPECT_THAT(messages.back(), testing::HasSubstr("\"id\":2"));
+  EXPECT_THAT(messages.back(), testing::HasSubstr(*session_id));
+  EXPECT_THAT(
+      std::vector<size_t>(client_host.batch_sizes().begin() + first_batch,
+                          client_host.batch_sizes().end()),
+      testing::ElementsAre(messages.size() - first_message - 1));
+
+  browser_agent->DetachClient(&client_host);
+}
+
 TEST_F(DevToolsAgentHostImplTest, NoUnresponsiveDialogInInspectedContents) {
   const GURL url("http://www.google.com");
   contents()->NavigateAndCommit(url);
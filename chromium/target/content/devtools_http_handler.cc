@@ -12,6 +12,7 @@
 #include <optional>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
@@ -29,6 +30,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/task/thread_pool.h"
 #include "base/threading/thread.h"
@@ -57,6 +59,7 @@
 #include "net/server/http_server_response_info.h"
 #include "net/socket/server_socket.h"
 #include "net/traffic_annotation/network_traffic_annotation.h"
+#include "url/gurl.h"
 #include "v8/include/v8-version-string.h"
 
 #if BUILDFLAG(IS_ANDROID)
@@ -78,6 +81,7 @@ const char kDevToolsHandlerThreadName[] = "Chrome_DevToolsHandlerThread";
 
 const char kPageUrlPrefix[] = "/devtools/page/";
 const char kBrowserUrlPrefix[] = "/devtools/browser";
+const char kBatchNotificationsParam[] = "batchNotifications";
 
 const char kTargetIdField[] = "id";
 const char kTargetParentIdField[] = "parentId";
@@ -317,6 +321,81 @@ void StartServerOnHandlerThread(
                      std::move(ip_address)));
 }
 
+// WebSocketOutbox ------------------------------------------------------------
+// Queues protocol messages for one WebSocket connection on the UI thread and
+// sends them from the handler thread. A burst of messages (e.g. events for
+// many targets) is sent by a single handler thread task instead of one task
+// per message. Messages are sent in the order they are queued.
+class WebSocketOutbox : public base::RefCountedThreadSafe<WebSocketOutbox> {
+ public:
+  WebSocketOutbox(scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+                  ServerWrapper* server_wrapper,
+                  int connection_id)
+      : task_runner_(std::move(task_runner)),
+        server_wrapper_(server_wrapper),
+        connection_id_(connection_id) {}
+
+  WebSocketOutbox(const WebSocketOutbox&) = delete;
+  WebSocketOutbox& operator=(const WebSocketOutbox&) = delete;
+
+  void Push(std::string message) {
+    bool needs_flush;
+    {
+      base::AutoLock lock(lock_);
+      needs_flush = pending_messages_.empty();
+      pending_messages_.push_back(std::move(message));
+    }
+    // A flush is already posted if there were pending messages, and it will
+    // send this one too.
+    if (needs_flush) {
+      task_runner_->PostTask(FROM_HERE,
+                             base::BindOnce(&WebSocketOutbox::Flush, this));
+    }
+  }
+
+  void PushAll(const std::vector<std::vector<uint8_t>>& messages) {
+    bool needs_flush;
+    {
+      base::AutoLock lock(lock_);
+      needs_flush = pending_messages_.empty();
+      for (const std::vector<uint8_t>& message : messages) {
+        pending_messages_.emplace_back(base::as_string_view(message));
+      }
+    }
+    // A flush is already posted if there were pending messages, and it will
+    // send this one too.
+    if (needs_flush) {
+      task_runner_->PostTask(FROM_HERE,
+                             base::BindOnce(&WebSocketOutbox::Flush, this));
+    }
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<WebSocketOutbox>;
+  ~WebSocketOutbox() = default;
+
+  void Flush() {
+    DCHECK(task_runner_->BelongsToCurrentThread());
+    std::vector<std::string> messages;
+    {
+      base::AutoLock lock(lock_);
+      messages.swap(pending_messages_);
+    }
+    UMA_HISTOGRAM_COUNTS_1000("DevTools.HttpHandler.WebSocketMessagesPerFlush",
+                              messages.size());
+    for (std::string& message : messages) {
+      server_wrapper_->SendOverWebSocket(connection_id_, std::move(message));
+    }
+  }
+
+  const scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+  const raw_ptr<ServerWrapper> server_wrapper_;
+  const int connection_id_;
+
+  base::Lock lock_;
+  std::vector<std::string> pending_messages_ GUARDED_BY(lock_);
+};
+
 // DevToolsAgentHostClientImpl -----------------------------------------------
 // An internal implementation of DevToolsAgentHostClient that delegates
 // messages sent to a DebuggerShell instance.
@@ -326,10 +405,15 @@ class DevToolsAgentHostClientImpl : public DevToolsAgentHostClient {
       scoped_refptr<base::SingleThreadTaskRunner> task_runner,
       ServerWrapper* server_wrapper,
       int connection_id,
-      scoped_refptr<DevToolsAgentHost> agent_host)
+      scoped_refptr<DevToolsAgentHost> agent_host,
+      bool batch_notifications)
       : task_runner_(std::move(task_runner)),
         server_wrapper_(server_wrapper),
         connection_id_(connection_id),
+        batch_notifications_(batch_notifications),
+        outbox_(base::MakeRefCounted<WebSocketOutbox>(task_runner_,
+                                                      server_wrapper,
+                                                      connection_id)),
         agent_host_(agent_host) {
     DCHECK_CURRENTLY_ON(BrowserThread::UI);
     // TODO(dgozman): handle return value of AttachClient.
@@ -364,11 +448,17 @@ class DevToolsAgentHostClientImpl : public DevToolsAgentHostClient {
                                base::span<const uint8_t> message) override {
     DCHECK_CURRENTLY_ON(BrowserThread::UI);
     DCHECK(agent_host == agent_host_.get());
-    task_runner_->PostTask(
-        FROM_HERE,
-        base::BindOnce(&ServerWrapper::SendOverWebSocket,
-                       base::Unretained(server_wrapper_), connection_id_,
-                       std::string(message.begin(), message.end())));
+    outbox_->Push(std::string(base::as_string_view(message)));
+  }
+
+  bool UsesNotificationBatching() override { return batch_notifications_; }
+
+  void DispatchProtocolMessageBatch(
+      DevToolsAgentHost* agent_host,
+      const std::vector<std::vector<uint8_t>>& messages) override {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    DCHECK(agent_host == agent_host_.get());
+    outbox_->PushAll(messages);
   }
 
   void OnMessage(base::span<const uint8_t> message) {
@@ -381,6 +471,10 @@ class DevToolsAgentHostClientImpl : public DevToolsAgentHostClient {
   const scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
   const raw_ptr<ServerWrapper> server_wrapper_;
   const int connection_id_;
+  const bool batch_notifications_;
+  // Closing the connection is posted after `outbox_` flushes anything queued
+  // before, so the final messages are sent before the connection is closed.
+  const scoped_refptr<WebSocketOutbox> outbox_;
   scoped_refptr<DevToolsAgentHost> agent_host_;
 };
 
@@ -708,7 +802,7 @@ void DevToolsHttpHandler::DecompressAndSendJsonProtocol(int connection_id) {
   thread_->task_runner()->PostTask(
       FROM_HERE, base::BindOnce(&ServerWrapper::SendResponse,
                                 base::Unretained(server_wrapper_.get()),
-                                connection_id, response));
+                                connection_id, std::move(response)));
 #endif  // BUILDFLAG(IS_ANDROID) || BUILDFLAG(IS_FUCHSIA) || BUILDFLAG(IS_IOS)
 }
 
@@ -771,8 +865,17 @@ void DevToolsHttpHandler::OnWebSocketRequest(
     return;
   }
 
-  if (base::StartsWith(request.path, browser_guid_,
-                       base::CompareCase::SENSITIVE)) {
+  // Clients may opt into receiving browser-generated notifications in batches
+  // by connecting with "?batchNotifications=true".
+  std::string batch_notifications_value;
+  bool batch_notifications =
+      net::GetValueForKeyInQuery(GURL("http://localhost" + request.path),
+                                 kBatchNotificationsParam,
+                                 &batch_notifications_value) &&
+      batch_notifications_value == "true";
+  std::string path = PathWithoutParams(request.path);
+
+  if (base::StartsWith(path, browser_guid_, base::CompareCase::SENSITIVE)) {
     scoped_refptr<DevToolsAgentHost> browser_agent =
         DevToolsAgentHost::CreateForBrowser(
             thread_->task_runner(),
@@ -781,18 +884,17 @@ void DevToolsHttpHandler::OnWebSocketRequest(
     connection_to_client_[connection_id] =
         std::make_unique<DevToolsAgentHostClientImpl>(
             thread_->task_runner(), server_wrapper_.get(), connection_id,
-            browser_agent);
+            browser_agent, batch_notifications);
     AcceptWebSocket(connection_id, request);
     return;
   }
 
-  if (!base::StartsWith(request.path, kPageUrlPrefix,
-                        base::CompareCase::SENSITIVE)) {
+  if (!base::StartsWith(path, kPageUrlPrefix, base::CompareCase::SENSITIVE)) {
     Send404(connection_id);
     return;
   }
 
-  std::string target_id = request.path.substr(strlen(kPageUrlPrefix));
+  std::string target_id = path.substr(strlen(kPageUrlPrefix));
   scoped_refptr<DevToolsAgentHost> agent =
       DevToolsAgentHost::GetForId(target_id);
   if (!agent) {
@@ -802,7 +904,8 @@ void DevToolsHttpHandler::OnWebSocketRequest(
 
   connection_to_client_[connection_id] =
       std::make_unique<DevToolsAgentHostClientImpl>(
-          thread_->task_runner(), server_wrapper_.get(), connection_id, agent);
+          thread_->task_runner(), server_wrapper_.get(), connection_id, agent,
+          batch_notifications);
 
   AcceptWebSocket(connection_id, request);
 }
@@ -872,23 +975,23 @@ void DevToolsHttpHandler::SendJson(int connection_id,
   if (!thread_)
     return;
 
-  // Serialize value and message.
-  std::string json_value;
+  // Serialize value, and append message. Target lists can get large, so avoid
+  // extra copies of the body.
+  std::string body;
   if (value) {
     base::JSONWriter::WriteWithOptions(
-        *value, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json_value);
+        *value, base::JSONWriter::OPTIONS_PRETTY_PRINT, &body);
   }
-  std::string json_message;
-  base::JSONWriter::Write(base::Value(message), &json_message);
+  body.append(message);
 
   net::HttpServerResponseInfo response(status_code);
   response.AddHeader("Content-Security-Policy", "frame-ancestors 'none'");
-  response.SetBody(json_value + message, "application/json; charset=UTF-8");
+  response.SetBody(body, "application/json; charset=UTF-8");
 
   thread_->task_runner()->PostTask(
       FROM_HERE, base::BindOnce(&ServerWrapper::SendResponse,
                                 base::Unretained(server_wrapper_.get()),
-                                connection_id, response));
+                                connection_id, std::move(response)));
 }
 
 void DevToolsHttpHandler::Send200(int connection_id,
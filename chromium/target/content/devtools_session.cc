@@ -11,6 +11,8 @@
 #include "base/containers/flat_set.h"
 #include "base/debug/stack_trace.h"
 #include "base/functional/bind.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/time/time.h"
 #include "base/trace_event/trace_event.h"
 #include "content/browser/devtools/devtools_manager.h"
 #include "content/browser/devtools/protocol/devtools_domain_handler.h"
@@ -24,6 +26,12 @@
 
 namespace content {
 namespace {
+// Bounds on the batches of browser-generated notifications sent to clients
+// that use notification batching.
+constexpr size_t kMaxQueuedNotifications = 256;
+constexpr size_t kMaxQueuedNotificationsSize = 256 * 1024;
+constexpr base::TimeDelta kMaxQueuedNotificationsDelay = base::Milliseconds(2);
+
 // Keep in sync with WebDevToolsAgent::ShouldInterruptForMethod.
 // TODO(petermarshall): find a way to share this.
 bool ShouldSendOnIO(crdtp::span<uint8_t> method) {
@@ -415,20 +423,66 @@ void DevToolsSession::FallThrough(int call_id,
 void DevToolsSession::DispatchProtocolMessageToClient(
     std::vector<uint8_t> message) {
   DCHECK(crdtp::cbor::IsCBORMessage(crdtp::SpanFrom(message)));
+  if (!FlushQueuedNotificationsBeforeDispatch())
+    return;
+  PrepareMessageForClient(client_, message);
+  client_->DispatchProtocolMessage(agent_host_, message);
+}
 
+void DevToolsSession::PrepareMessageForClient(DevToolsAgentHostClient* client,
+                                              std::vector<uint8_t>& message) {
   if (!session_id_.empty()) {
     crdtp::Status status = crdtp::cbor::AppendString8EntryToCBORMap(
         crdtp::SpanFrom(kSessionId), crdtp::SpanFrom(session_id_), &message);
     DCHECK(status.ok()) << status.ToASCIIString();
   }
-  if (!client_->UsesBinaryProtocol()) {
+  if (!client->UsesBinaryProtocol()) {
     std::vector<uint8_t> json;
     crdtp::Status status =
         crdtp::json::ConvertCBORToJSON(crdtp::SpanFrom(message), &json);
     DCHECK(status.ok()) << status.ToASCIIString();
     message = std::move(json);
   }
-  client_->DispatchProtocolMessage(agent_host_, message);
+}
+
+bool DevToolsSession::FlushQueuedNotificationsBeforeDispatch() {
+  DevToolsSession* root = GetRootSession();
+  if (root->queued_notifications_.empty())
+    return true;
+  base::WeakPtr<DevToolsSession> weak_this = weak_factory_.GetWeakPtr();
+  root->FlushQueuedNotifications();
+  return !!weak_this;
+}
+
+void DevToolsSession::QueueNotification(std::vector<uint8_t> message) {
+  DCHECK(!root_session_);
+  queued_notifications_size_ += message.size();
+  queued_notifications_.push_back(std::move(message));
+  if (queued_notifications_.size() >= kMaxQueuedNotifications ||
+      queued_notifications_size_ >= kMaxQueuedNotificationsSize) {
+    FlushQueuedNotifications();
+    // |this| may be deleted at this point.
+    return;
+  }
+  if (!queued_notifications_timer_.IsRunning()) {
+    queued_notifications_timer_.Start(
+        FROM_HERE, kMaxQueuedNotificationsDelay,
+        base::BindOnce(&DevToolsSession::FlushQueuedNotifications,
+                       base::Unretained(this)));
+  }
+}
+
+void DevToolsSession::FlushQueuedNotifications() {
+  queued_notifications_timer_.Stop();
+  if (queued_notifications_.empty())
+    return;
+  std::vector<std::vector<uint8_t>> batch;
+  batch.swap(queued_notifications_);
+  queued_notifications_size_ = 0;
+  UMA_HISTOGRAM_COUNTS_1000("DevTools.Session.NotificationsPerBatch",
+                            batch.size());
+  client_->DispatchProtocolMessageBatch(agent_host_, batch);
+  // |this| may be deleted at this point.
 }
 
 content::DevToolsAgentHost* DevToolsSession::GetAgentHost() {
@@ -514,11 +568,25 @@ void DevToolsSession::SendProtocolResponse(
 
 void DevToolsSession::SendProtocolNotification(
     std::unique_ptr<protocol::Serializable> message) {
-  DispatchProtocolMessageToClient(message->Serialize());
+  // Flattened child sessions reach the client through the root session, so
+  // their notifications are queued on the root session in the root client's
+  // format. This keeps notifications in order across sessions.
+  DevToolsSession* root = GetRootSession();
+  if (!root->client_->UsesNotificationBatching()) {
+    DispatchProtocolMessageToClient(message->Serialize());
+    // |this| may be deleted at this point.
+    return;
+  }
+  std::vector<uint8_t> serialized = message->Serialize();
+  PrepareMessageForClient(root->client_, serialized);
+  root->QueueNotification(std::move(serialized));
   // |this| may be deleted at this point.
 }
 
-void DevToolsSession::FlushProtocolNotifications() {}
+void DevToolsSession::FlushProtocolNotifications() {
+  GetRootSession()->FlushQueuedNotifications();
+  // |this| may be deleted at this point.
+}
 
 // The following methods handle responses or notifications coming from the
 // renderer (blink) to the client. It is important that these messages not be
@@ -547,6 +615,8 @@ void DevToolsSession::DispatchProtocolResponse(
     return;
   pending_messages_.erase(it->second);
   waiting_for_response_.erase(it);
+  if (!FlushQueuedNotificationsBeforeDispatch())
+    return;
   DispatchProtocolResponseOrNotification(client_, agent_host_,
                                          std::move(message));
   // |this| may be deleted at this point.
@@ -556,6 +626,8 @@ void DevToolsSession::DispatchProtocolNotification(
     blink::mojom::DevToolsMessagePtr message,
     blink::mojom::DevToolsSessionStatePtr updates) {
   ApplySessionStateUpdates(std::move(updates));
+  if (!FlushQueuedNotificationsBeforeDispatch())
+    return;
   DispatchProtocolResponseOrNotification(client_, agent_host_,
                                          std::move(message));
   // |this| may be deleted at this point.
@@ -565,6 +637,8 @@ void DevToolsSession::DispatchOnClientHost(base::span<const uint8_t> message) {
   // |message| either comes from a web socket, in which case it's JSON.
   // Or it comes from another devtools_session, in which case it may be CBOR
   // already. We auto-detect and convert to what the client wants as needed.
+  if (!FlushQueuedNotificationsBeforeDispatch())
+    return;
   bool is_cbor_message = crdtp::cbor::IsCBORMessage(crdtp::SpanFrom(message));
   if (client_->UsesBinaryProtocol() == is_cbor_message) {
     client_->DispatchProtocolMessage(agent_host_, message);
@@ -582,6 +656,8 @@ void DevToolsSession::DispatchOnClientHost(base::span<const uint8_t> message) {
 }
 
 void DevToolsSession::ConnectionClosed() {
+  if (!FlushQueuedNotificationsBeforeDispatch())
+    return;
   DevToolsAgentHostClient* client = client_;
   DevToolsAgentHostImpl* agent_host = agent_host_;
   agent_host->DetachInternal(this);
@@ -16,6 +16,7 @@
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
+#include "base/timer/timer.h"
 #include "content/browser/devtools/protocol/protocol.h"
 #include "content/public/browser/devtools_agent_host_client_channel.h"
 #include "content/public/browser/devtools_external_agent_proxy.h"
@@ -126,6 +127,11 @@ class DevToolsSession : public protocol::FrontendChannel,
   bool HasChildSession(const std::string& session_id);
   Mode session_mode() const { return mode_; }
 
+  // Sends notifications queued for clients that use notification batching.
+  // Must be called before the client is detached for reasons other than its
+  // own request, so that it receives everything sent before the detach.
+  void FlushQueuedNotifications();
+
   void AddObserver(ChildObserver* obs);
   void RemoveObserver(ChildObserver* obs);
 
@@ -216,6 +222,16 @@ class DevToolsSession : public protocol::FrontendChannel,
         std::is_same<T, protocol::WebAuthnHandler>>;
   }
   void AddHandler(std::unique_ptr<protocol::DevToolsDomainHandler> handler);
+
+  // Adds the session id and converts |message| to |client|'s format.
+  void PrepareMessageForClient(DevToolsAgentHostClient* client,
+                               std::vector<uint8_t>& message);
+  // Flushes notifications queued on the root session, so that a message which
+  // is about to be dispatched directly is not reordered with them. Returns
+  // false if |this| was deleted by the client while flushing.
+  bool FlushQueuedNotificationsBeforeDispatch();
+  void QueueNotification(std::vector<uint8_t> message);
+
   void PrepareForReload(std::string script_to_evaluate_on_load);
 
   const raw_ptr<DevToolsAgentHostClient> client_;
@@ -252,6 +268,13 @@ class DevToolsSession : public protocol::FrontendChannel,
   base::OnceClosure runtime_resume_;
   raw_ptr<DevToolsExternalAgentProxyDelegate> proxy_delegate_ = nullptr;
   base::ObserverList<ChildObserver, true, false> child_observers_;
+
+  // Browser-generated notifications of this session and its flattened child
+  // sessions waiting to be sent as one batch. Only used by root sessions whose
+  // client uses notification batching.
+  std::vector<std::vector<uint8_t>> queued_notifications_;
+  size_t queued_notifications_size_ = 0;
+  base::OneShotTimer queued_notifications_timer_;
   base::WeakPtrFactory<DevToolsSession> weak_factory_{this};
 };
 
@@ -88,6 +88,7 @@ void DevToolsStreamFile::ReadOnFileSequence(off_t position,
                                             ReadCallback callback) {
   auto data = std::make_unique<std::string>();
   Status status;
+  bool is_sequential = position < 0 || position == last_read_pos_;
   if (!file_.IsValid()) {
     status = StatusFailure;
   } else {
@@ -100,6 +101,46 @@ void DevToolsStreamFile::ReadOnFileSequence(off_t position,
   GetUIThreadTaskRunner({})->PostTask(
       FROM_HERE,
       base::BindOnce(std::move(callback), std::move(data), binary_, status));
+  // Clients pulling a large stream issue IO.read back to back, so fetch the
+  // next chunk while this one is being sent.
+  if (status == StatusSuccess && is_sequential)
+    ReadAheadOnFileSequence(max_size);
+}
+
+bool DevToolsStreamFile::ReadRangeOnFileSequence(off_t position,
+                                                 size_t size,
+                                                 std::string& out_data) {
+  DCHECK(task_runner_->RunsTasksInCurrentSequence());
+  out_data.clear();
+  if (position == read_ahead_pos_) {
+    out_data.append(read_ahead_buffer_, 0,
+                    std::min(size, read_ahead_buffer_.size()));
+  }
+  size_t offset = out_data.size();
+  if (offset == size)
+    return true;
+  out_data.resize(size);
+  std::optional<size_t> size_got = file_.ReadNoBestEffort(
+      position + offset, base::as_writable_byte_span(out_data).subspan(offset));
+  if (!size_got.has_value())
+    return false;
+  out_data.resize(offset + size_got.value());
+  return true;
+}
+
+void DevToolsStreamFile::ReadAheadOnFileSequence(size_t max_size) {
+  DCHECK(task_runner_->RunsTasksInCurrentSequence());
+  if (!file_.IsValid() || read_ahead_pos_ != last_read_pos_ ||
+      !read_ahead_buffer_.empty() || last_read_pos_ >= last_written_pos_) {
+    return;
+  }
+  max_size = std::min(max_size,
+                      static_cast<size_t>(last_written_pos_ - last_read_pos_));
+  read_ahead_buffer_.resize(max_size);
+  std::optional<size_t> size_got = file_.ReadNoBestEffort(
+      last_read_pos_, base::as_writable_byte_span(read_ahead_buffer_));
+  // A failed read-ahead is not an error; the next read will retry and report.
+  read_ahead_buffer_.resize(size_got.value_or(0));
 }
 
 DevToolsIOContext::Stream::Status DevToolsStreamFile::InnerReadOnFileSequence(
@@ -119,21 +160,22 @@ DevToolsIOContext::Stream::Status DevToolsStreamFile::InnerReadOnFileSequence(
 
   max_size =
       std::min(max_size, static_cast<size_t>(last_written_pos_ - position));
-  buffer.resize(max_size);
-
-  std::optional<size_t> size_got =
-      file_.ReadNoBestEffort(position, base::as_writable_byte_span(buffer));
 
-  if (!size_got.has_value()) {
+  if (!ReadRangeOnFileSequence(position, max_size, buffer)) {
     LOG(ERROR) << "Failed to read temporary file";
     return StatusFailure;
   }
+  // The file ends before |last_written_pos_| if a write failed half way.
+  if (buffer.empty()) {
+    return StatusEOF;
+  }
+  size_t size_got = buffer.size();
 
   // Provided client has requested sufficient large block, make their
   // life easier by not truncating in the middle of a UTF-8 character.
-  if (size_got.value() > 6 && !CBU8_IS_SINGLE(buffer[size_got.value() - 1])) {
+  if (size_got > 6 && !CBU8_IS_SINGLE(buffer[size_got - 1])) {
     std::string truncated;
-    base::TruncateUTF8ToByteSize(buffer, size_got.value(), &truncated);
+    base::TruncateUTF8ToByteSize(buffer, size_got, &truncated);
     // If the above failed, we're dealing with binary files, so
     // don't mess with them.
     if (truncated.size()) {
@@ -141,12 +183,19 @@ DevToolsIOContext::Stream::Status DevToolsStreamFile::InnerReadOnFileSequence(
       size_got = buffer.size();
     }
   }
-  buffer.resize(size_got.value());
-  last_read_pos_ = position + size_got.value();
+  last_read_pos_ = position + size_got;
+  // Keep whatever part of the read-ahead buffer was not returned, so that it
+  // still starts at |last_read_pos_|.
+  if (read_ahead_pos_ == position && read_ahead_buffer_.size() > size_got) {
+    read_ahead_buffer_.erase(0, size_got);
+  } else {
+    read_ahead_buffer_.clear();
+  }
+  read_ahead_pos_ = last_read_pos_;
   if (binary_) {
     buffer = base::Base64Encode(buffer);
   }
-  return size_got ? StatusSuccess : StatusEOF;
+  return StatusSuccess;
 }
 
 void DevToolsStreamFile::AppendOnFileSequence(
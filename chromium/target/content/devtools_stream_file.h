@@ -33,6 +33,14 @@ class DevToolsStreamFile : public DevToolsIOContext::Stream {
   Status InnerReadOnFileSequence(off_t position,
                                  size_t max_size,
                                  std::string& out_data);
+  // Reads |size| bytes at |position| into |out_data|, using the read-ahead
+  // buffer when it starts at |position|.
+  bool ReadRangeOnFileSequence(off_t position,
+                               size_t size,
+                               std::string& out_data);
+  // Reads the chunk following the last read into |read_ahead_buffer_|, so
+  // that a sequential reader gets it without waiting on the file.
+  void ReadAheadOnFileSequence(size_t max_size);
   void AppendOnFileSequence(std::unique_ptr<std::string> data);
   bool InitOnFileSequenceIfNeeded();
 
@@ -44,6 +52,8 @@ class DevToolsStreamFile : public DevToolsIOContext::Stream {
   bool had_errors_ = false;
   off_t last_written_pos_ = 0;
   off_t last_read_pos_ = 0;
+  std::string read_ahead_buffer_;
+  off_t read_ahead_pos_ = 0;
 };
 
 }  // namespace content
@@ -0,0 +1,109 @@
+// Copyright 2025 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/devtools/devtools_stream_file.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/memory/scoped_refptr.h"
+#include "base/test/test_future.h"
+#include "content/browser/devtools/devtools_io_context.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+using Status = DevToolsIOContext::Stream::Status;
+
+struct ReadResult {
+  std::string data;
+  int status;
+};
+
+class DevToolsStreamFileTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    stream_ = DevToolsStreamFile::Create(&io_context_, /*binary=*/false);
+  }
+
+  void Append(std::string data) {
+    stream_->Append(std::make_unique<std::string>(std::move(data)));
+  }
+
+  // Reads through the public Stream interface, as IO.read does.
+  ReadResult Read(off_t position, size_t max_size) {
+    base::test::TestFuture<std::unique_ptr<std::string>, bool, int> future;
+    scoped_refptr<DevToolsIOContext::Stream> stream = stream_;
+    stream->Read(position, max_size, future.GetCallback());
+    auto [data, base64_encoded, status] = future.Take();
+    EXPECT_FALSE(base64_encoded);
+    return {std::move(*data), status};
+  }
+
+  BrowserTaskEnvironment task_environment_;
+  DevToolsIOContext io_context_;
+  scoped_refptr<DevToolsStreamFile> stream_;
+};
+
+std::string CreateData(size_t size) {
+  std::string data;
+  for (size_t i = 0; i < size; ++i) {
+    data.push_back('a' + i % 26);
+  }
+  return data;
+}
+
+// Sequential reads of different sizes take part of their data from the chunk
+// read ahead by the previous read, and the rest from the file.
+TEST_F(DevToolsStreamFileTest, ChunkedReadsAcrossReadAhead) {
+  const std::string data = CreateData(1000);
+  Append(data);
+
+  std::string read_data;
+  for (size_t size : {300u, 500u, 100u, 500u}) {
+    ReadResult result = Read(-1, size);
+    EXPECT_EQ(Status::StatusSuccess, result.status);
+    read_data += result.data;
+  }
+  EXPECT_EQ(data, read_data);
+}
+
+TEST_F(DevToolsStreamFileTest, EOFAfterLastChunk) {
+  Append(CreateData(100));
+
+  ReadResult result = Read(-1, 100);
+  EXPECT_EQ(Status::StatusSuccess, result.status);
+  EXPECT_EQ(100u, result.data.size());
+
+  result = Read(-1, 100);
+  EXPECT_EQ(Status::StatusEOF, result.status);
+  EXPECT_TRUE(result.data.empty());
+
+  // Data appended later is read after the EOF.
+  Append(CreateData(50));
+  result = Read(-1, 100);
+  EXPECT_EQ(Status::StatusSuccess, result.status);
+  EXPECT_EQ(CreateData(50), result.data);
+}
+
+// A read at another position than the last read's end does not use the
+// read-ahead chunk.
+TEST_F(DevToolsStreamFileTest, ReadAtPositionSkipsReadAhead) {
+  const std::string data = CreateData(1000);
+  Append(data);
+
+  EXPECT_EQ(data.substr(0, 100), Read(0, 100).data);
+  EXPECT_EQ(data.substr(50, 100), Read(50, 100).data);
+  EXPECT_EQ(data.substr(150, 100), Read(-1, 100).data);
+  EXPECT_EQ(data.substr(900), Read(900, 500).data);
+  EXPECT_EQ(Status::StatusEOF, Read(1000, 100).status);
+}
+
+}  // namespace
+
+}  // namespace content
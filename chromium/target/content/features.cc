@@ -246,6 +246,13 @@ BASE_FEATURE(kInMemoryCodeCache,
              "InMemoryCodeCache",
              base::FEATURE_DISABLED_BY_DEFAULT);
 
+// Keeps recently used deduplicated (checksum-keyed) code cache bodies in
+// memory, so that repeated fetches of very large scripts and wasm modules skip
+// the second disk read.
+BASE_FEATURE(kInMemoryDeduplicatedCodeCache,
+             "InMemoryDeduplicatedCodeCache",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 // Enables the ability to use the updateIfOlderThanMs field in the trusted
 // bidding response to trigger a post-auction update if the group has been
 // updated more recently than updateIfOlderThanMs milliseconds, bypassing the
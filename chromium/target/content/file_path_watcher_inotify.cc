@@ -65,6 +65,10 @@ constexpr size_t kDefaultInotifyMaxUserWatches = 8192u;
 
 #endif  // !BUILDFLAG(IS_FUCHSIA)
 
+// The maximum number of changes the inotify reader thread accumulates before
+// dispatching them, so that a steady stream of events is not held back.
+constexpr size_t kMaxInotifyChangesPerDispatch = 1024u;
+
 class FilePathWatcherImpl;
 class InotifyReader;
 
@@ -119,6 +123,23 @@ class InotifyReader {
     base::WeakPtr<FilePathWatcherImpl> watcher;
   };
 
+  // An inotify event, copied out of the buffer it was read into.
+  struct Event {
+    Watch watch;
+    uint32_t mask;
+    uint32_t cookie;
+    base::FilePath::StringType child_name;
+
+    bool operator==(const Event&) const = default;
+  };
+
+  // A single event, or a coalesced pair of matching IN_MOVED_FROM (`event`)
+  // and IN_MOVED_TO (`moved_to_event`) events.
+  struct Change {
+    Event event;
+    std::optional<Event> moved_to_event;
+  };
+
   static constexpr Watch kInvalidWatch = static_cast<Watch>(-1);
   static constexpr Watch kWatchLimitExceeded = static_cast<Watch>(-2);
 
@@ -132,10 +153,9 @@ class InotifyReader {
   // Remove |watch| if it's valid.
   void RemoveWatch(Watch watch, FilePathWatcherImpl* watcher);
 
-  // Invoked on "inotify_reader" thread to notify relevant watchers.
-  void OnInotifyEvent(const inotify_event* event);
-  void OnInotifyMatchingMoveEvents(const inotify_event* moved_from_event,
-                                   const inotify_event* moved_to_event);
+  // Invoked on "inotify_reader" thread with all the changes read at once, in
+  // order. Each relevant watcher is notified with a single task.
+  void OnInotifyChanges(const std::vector<Change>& changes);
 
   // Returns true if any paths are actively being watched.
   bool HasWatches();
@@ -151,6 +171,19 @@ class InotifyReader {
   // Returns true on successful thread creation.
   bool StartThread();
 
+  // Changes read at once that are to be dispatched to a single watcher.
+  struct WatcherChanges {
+    WatcherEntry watcher_entry;
+    std::vector<Change> changes;
+  };
+  using ChangesByWatcher = std::map<FilePathWatcherImpl*, WatcherChanges>;
+
+  // Appends `change` to the changes to dispatch to `watcher`.
+  static void AddChangeForWatcher(ChangesByWatcher& changes_by_watcher,
+                                  FilePathWatcherImpl* watcher,
+                                  const WatcherEntry& watcher_entry,
+                                  Change change);
+
   base::Lock lock_;
 
   // Tracks which FilePathWatcherImpls to be notified on which watches.
@@ -176,6 +209,10 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate {
   FilePathWatcherImpl& operator=(const FilePathWatcherImpl&) = delete;
   ~FilePathWatcherImpl() override;
 
+  // Called on the original thread with the changes read at once by the
+  // inotify reader thread that are relevant to this watcher.
+  void OnInotifyChanges(std::vector<InotifyReader::Change> changes);
+
   // Called for each event coming from the watch on the original thread.
   // `fired_watch` identifies the watch that fired, `child_name` indicates
   // what has changed, and is relative to the currently watched path for
@@ -359,6 +396,13 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate {
 
   bool HasValidWatchVector() const;
 
+  // Rebuilds `watch_entry_indices_` after `watches_` has been updated.
+  void UpdateWatchEntryIndices();
+
+  // Returns the smallest index into `watches_` that is not less than `start`
+  // and whose entry is for `watch`, or `watches_.size()` if there is none.
+  size_t FindWatchEntryIndex(InotifyReader::Watch watch, size_t start) const;
+
   // Invokes the callback with error, and cancels all watches. This occurs if
   // updating watches has caused the exceeded limit error.
   void CancelAndRunCallbackOnExceededLimit(UsageMonitor& usage_monitor);
@@ -380,6 +424,11 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate {
   // |target_| and always stores an empty next component name in |subdir|.
   std::vector<WatchEntry> watches_;
 
+  // Indices into `watches_` of the entries for each watch, in increasing
+  // order. Several entries may share a watch, e.g. through symlinks.
+  std::unordered_map<InotifyReader::Watch, std::vector<size_t>>
+      watch_entry_indices_;
+
   std::unordered_map<InotifyReader::Watch, base::FilePath>
       recursive_paths_by_watch_;
   std::map<base::FilePath, InotifyReader::Watch> recursive_watches_by_path_;
@@ -412,6 +461,8 @@ void InotifyReaderThreadDelegate::ThreadMain() {
       }
     }
 
+    std::vector<InotifyReader::Change> changes;
+    std::optional<InotifyReader::Event> pending_move_from_event;
     bool has_batch = true;
     while (has_batch) {
       // Adjust buffer size to current event queue size.
@@ -443,8 +494,7 @@ void InotifyReaderThreadDelegate::ThreadMain() {
       // the current buffer, so the matching IN_MOVED_TO is read in the next
       // buffer). We don't want to wait indefinitely for the matching pair due
       // to this lack of guarantee, so perform the best-effort coalescing of
-      // move events only within the same buffer.
-      inotify_event* pending_move_from_event = nullptr;
+      // move events only within batches that are immediately available.
       for (size_t i = 0; i < static_cast<size_t>(bytes_read);) {
         inotify_event* event = reinterpret_cast<inotify_event*>(&buffer[i]);
         size_t event_size = sizeof(inotify_event) + event->len;
@@ -455,31 +505,37 @@ void InotifyReaderThreadDelegate::ThreadMain() {
           continue;
         }
 
+        InotifyReader::Event copied_event{
+            static_cast<InotifyReader::Watch>(event->wd), event->mask,
+            event->cookie,
+            base::FilePath::StringType(event->len ? event->name
+                                                  : FILE_PATH_LITERAL(""))};
+
         if (pending_move_from_event) {
           if (event->mask & IN_MOVED_TO &&
               pending_move_from_event->cookie == event->cookie) {
             // Matching IN_MOVED_TO is observed for the existing pending move.
             // Match up the two move events, and reset
             // `pending_move_from_event`.
-            g_inotify_reader.Get().OnInotifyMatchingMoveEvents(
-                pending_move_from_event, event);
-            pending_move_from_event = nullptr;
+            changes.push_back({std::move(*pending_move_from_event),
+                               std::move(copied_event)});
+            pending_move_from_event.reset();
             continue;
           }
           // No matching IN_MOVED_TO is observed for `pending_move_from_event`.
           // Flush and reset `pending_move_from_event`.
-          g_inotify_reader.Get().OnInotifyEvent(pending_move_from_event);
-          pending_move_from_event = nullptr;
+          changes.push_back({std::move(*pending_move_from_event)});
+          pending_move_from_event.reset();
         }
 
         if (event->mask & IN_MOVED_FROM) {
           // IN_MOVED_FROM event is observed. Save as `pending_move_from_event`,
           // so that it can attempt to find the matching IN_MOVED_TO event for
           // the next iteration.
-          pending_move_from_event = event;
+          pending_move_from_event = std::move(copied_event);
         } else {
           // Process other events as normal.
-          g_inotify_reader.Get().OnInotifyEvent(event);
+          changes.push_back({std::move(copied_event)});
         }
       }
 
@@ -496,9 +552,19 @@ void InotifyReaderThreadDelegate::ThreadMain() {
       // If we don't have another batch to process, assume any pending move-from
       // event doesn't have a matching move-to event.
       if (!has_batch && pending_move_from_event) {
-        g_inotify_reader.Get().OnInotifyEvent(pending_move_from_event);
+        changes.push_back({std::move(*pending_move_from_event)});
+        pending_move_from_event.reset();
+      }
+
+      if (changes.size() >= kMaxInotifyChangesPerDispatch) {
+        g_inotify_reader.Get().OnInotifyChanges(changes);
+        changes.clear();
       }
     }
+
+    // Everything that was immediately available has been read, so dispatch it
+    // all at once rather than event by event.
+    g_inotify_reader.Get().OnInotifyChanges(changes);
   }
 }
 
@@ -573,105 +639,109 @@ void InotifyReader::RemoveWatch(Watch watch, FilePathWatcherImpl* watcher) {
   }
 }
 
-void InotifyReader::OnInotifyEvent(const inotify_event* event) {
-  base::FilePath::StringType child_name(event->len ? event->name
-                                                   : FILE_PATH_LITERAL(""));
-  base::AutoLock auto_lock(lock_);
-
-  // In racing conditions, RemoveWatch() could grab `lock_` first and remove
-  // the entry for `event->wd`.
-  auto watchers_it = watchers_.find(static_cast<Watch>(event->wd));
-  if (watchers_it == watchers_.end()) {
+void InotifyReader::OnInotifyChanges(const std::vector<Change>& changes) {
+  if (changes.empty()) {
     return;
   }
 
-  auto& watcher_map = watchers_it->second;
-  for (const auto& entry : watcher_map) {
-    auto& watcher_entry = entry.second;
-    watcher_entry.task_runner->PostTask(
-        FROM_HERE,
-        base::BindOnce(&FilePathWatcherImpl::OnFilePathChanged,
-                       watcher_entry.watcher, static_cast<Watch>(event->wd),
-                       child_name, event->mask));
-  }
-}
+  ChangesByWatcher changes_by_watcher;
+  {
+    // In racing conditions, RemoveWatch() could grab `lock_` first and remove
+    // the entries for the watches of `changes`.
+    base::AutoLock auto_lock(lock_);
+
+    for (const Change& change : changes) {
+      const Event& event = change.event;
+      const std::map<FilePathWatcherImpl*, WatcherEntry>* watcher_map =
+          nullptr;
+      if (auto it = watchers_.find(event.watch); it != watchers_.end()) {
+        watcher_map = &(it->second);
+      }
 
-void InotifyReader::OnInotifyMatchingMoveEvents(
-    const inotify_event* moved_from_event,
-    const inotify_event* moved_to_event) {
-  DUMP_WILL_BE_CHECK(moved_from_event && moved_to_event);
-  DUMP_WILL_BE_CHECK((moved_from_event->mask & IN_MOVED_FROM) &&
-                     (moved_to_event->mask & IN_MOVED_TO));
-  DUMP_WILL_BE_CHECK((moved_from_event->mask & IN_ISDIR) ==
-                     (moved_to_event->mask & IN_ISDIR));
-  DUMP_WILL_BE_CHECK(moved_from_event->len != 0);
-  DUMP_WILL_BE_CHECK(moved_to_event->len != 0);
-
-  base::FilePath::StringType moved_from_event_child_name(
-      moved_from_event->name);
-  base::FilePath::StringType moved_to_event_child_name(moved_to_event->name);
-  Watch moved_from_watch = static_cast<Watch>(moved_from_event->wd);
-  Watch moved_to_watch = static_cast<Watch>(moved_to_event->wd);
-  auto file_path_type = (moved_from_event->mask & IN_ISDIR)
-                            ? FilePathWatcher::FilePathType::kDirectory
-                            : FilePathWatcher::FilePathType::kFile;
+      if (!change.moved_to_event) {
+        if (watcher_map) {
+          for (const auto& entry : *watcher_map) {
+            AddChangeForWatcher(changes_by_watcher, entry.first, entry.second,
+                                {event});
+          }
+        }
+        continue;
+      }
 
-  // In racing conditions, RemoveWatch() could grab `lock_` first and remove
-  // the entry for `event->wd`.
-  base::AutoLock auto_lock(lock_);
+      const Event& moved_to_event = *change.moved_to_event;
+      DUMP_WILL_BE_CHECK((event.mask & IN_MOVED_FROM) &&
+                         (moved_to_event.mask & IN_MOVED_TO));
+      DUMP_WILL_BE_CHECK((event.mask & IN_ISDIR) ==
+                         (moved_to_event.mask & IN_ISDIR));
+      DUMP_WILL_BE_CHECK(!event.child_name.empty());
+      DUMP_WILL_BE_CHECK(!moved_to_event.child_name.empty());
+
+      const std::map<FilePathWatcherImpl*, WatcherEntry>*
+          moved_to_watcher_map = nullptr;
+      if (auto it = watchers_.find(moved_to_event.watch);
+          it != watchers_.end()) {
+        moved_to_watcher_map = &(it->second);
+      }
 
-  // The set of watchers for IN_MOVED_FROM event is not necessarily the same as
-  // the one for IN_MOVED_TO event. For the intersection of watchers set,
-  // send the related move events to be processed further; for the rest of the
-  // watchers, send a single move event.
-  std::map<FilePathWatcherImpl*, WatcherEntry>* moved_from_watcher_map =
-      nullptr;
-  if (auto it = watchers_.find(moved_from_watch); it != watchers_.end()) {
-    moved_from_watcher_map = &(it->second);
-  }
-  std::map<FilePathWatcherImpl*, WatcherEntry>* moved_to_watcher_map = nullptr;
-  if (auto it = watchers_.find(moved_to_watch); it != watchers_.end()) {
-    moved_to_watcher_map = &(it->second);
-  }
+      // The set of watchers for IN_MOVED_FROM event is not necessarily the
+      // same as the one for IN_MOVED_TO event. For the intersection of
+      // watchers set, send the related move events to be processed further;
+      // for the rest of the watchers, send a single move event.
+      if (watcher_map) {
+        for (const auto& entry : *watcher_map) {
+          if (moved_to_watcher_map &&
+              moved_to_watcher_map->contains(entry.first)) {
+            AddChangeForWatcher(changes_by_watcher, entry.first, entry.second,
+                                change);
+          } else {
+            AddChangeForWatcher(changes_by_watcher, entry.first, entry.second,
+                                {event});
+          }
+        }
+      }
 
-  if (moved_from_watcher_map) {
-    for (const auto& entry : *moved_from_watcher_map) {
-      auto& watcher_entry = entry.second;
-      if (moved_to_watcher_map && moved_to_watcher_map->contains(entry.first)) {
-        watcher_entry.task_runner->PostTask(
-            FROM_HERE,
-            base::BindOnce(&FilePathWatcherImpl::OnFilePathChangedForMoveEvents,
-                           watcher_entry.watcher, moved_from_watch,
-                           moved_from_event_child_name, moved_to_watch,
-                           moved_to_event_child_name, file_path_type));
-      } else {
-        watcher_entry.task_runner->PostTask(
-            FROM_HERE, base::BindOnce(&FilePathWatcherImpl::OnFilePathChanged,
-                                      watcher_entry.watcher, moved_from_watch,
-                                      moved_from_event_child_name,
-                                      moved_from_event->mask));
+      if (moved_to_watcher_map) {
+        for (const auto& entry : *moved_to_watcher_map) {
+          if (watcher_map && watcher_map->contains(entry.first)) {
+            // This moved_to event has been already added with the matching
+            // moved_from event, so we can skip it.
+            continue;
+          }
+          AddChangeForWatcher(changes_by_watcher, entry.first, entry.second,
+                              {moved_to_event});
+        }
       }
     }
   }
 
-  if (moved_to_watcher_map) {
-    for (const auto& entry : *moved_to_watcher_map) {
-      if (moved_from_watcher_map &&
-          moved_from_watcher_map->contains(entry.first)) {
-        // This moved_to event has been already posted with the matching
-        // moved_from event, so we can skip it.
-        continue;
-      }
-      auto& watcher_entry = entry.second;
-      watcher_entry.task_runner->PostTask(
-          FROM_HERE,
-          base::BindOnce(&FilePathWatcherImpl::OnFilePathChanged,
-                         watcher_entry.watcher, moved_to_watch,
-                         moved_to_event_child_name, moved_to_event->mask));
-    }
+  for (auto& [watcher, watcher_changes] : changes_by_watcher) {
+    WatcherEntry& watcher_entry = watcher_changes.watcher_entry;
+    watcher_entry.task_runner->PostTask(
+        FROM_HERE,
+        base::BindOnce(&FilePathWatcherImpl::OnInotifyChanges,
+                       std::move(watcher_entry.watcher),
+                       std::move(watcher_changes.changes)));
   }
 }
 
+// static
+void InotifyReader::AddChangeForWatcher(ChangesByWatcher& changes_by_watcher,
+                                        FilePathWatcherImpl* watcher,
+                                        const WatcherEntry& watcher_entry,
+                                        Change change) {
+  auto [it, inserted] = changes_by_watcher.try_emplace(
+      watcher, WatcherChanges{watcher_entry, {}});
+  std::vector<Change>& watcher_changes = it->second.changes;
+  // Like inotify itself, coalesce an event with an identical previous one, as
+  // they would result in the same notification.
+  if (!change.moved_to_event && !watcher_changes.empty() &&
+      !watcher_changes.back().moved_to_event &&
+      watcher_changes.back().event == change.event) {
+    return;
+  }
+  watcher_changes.push_back(std::move(change));
+}
+
 bool InotifyReader::HasWatches() {
   base::AutoLock auto_lock(lock_);
 
@@ -685,6 +755,29 @@ FilePathWatcherImpl::~FilePathWatcherImpl() {
                      task_runner()->RunsTasksInCurrentSequence());
 }
 
+void FilePathWatcherImpl::OnInotifyChanges(
+    std::vector<InotifyReader::Change> changes) {
+  DUMP_WILL_BE_CHECK(task_runner()->RunsTasksInCurrentSequence());
+
+  base::WeakPtr<FilePathWatcherImpl> weak_this = weak_factory_.GetWeakPtr();
+  for (const InotifyReader::Change& change : changes) {
+    const InotifyReader::Event& event = change.event;
+    if (change.moved_to_event) {
+      OnFilePathChangedForMoveEvents(
+          event.watch, event.child_name, change.moved_to_event->watch,
+          change.moved_to_event->child_name,
+          (event.mask & IN_ISDIR) ? FilePathWatcher::FilePathType::kDirectory
+                                  : FilePathWatcher::FilePathType::kFile);
+    } else {
+      OnFilePathChanged(event.watch, event.child_name, event.mask);
+    }
+    // The callback may have deleted or cancelled `this`.
+    if (!weak_this || is_cancelled()) {
+      return;
+    }
+  }
+}
+
 void FilePathWatcherImpl::OnFilePathChanged(
     InotifyReader::Watch fired_watch,
     const base::FilePath::StringType& child_name,
@@ -816,12 +909,11 @@ FilePathWatcherImpl::FindChangedPathAndUpdateWatches(
   // Used below to avoid multiple recursive updates.
   bool did_update = false;
 
-  // Find the entries in |watches_| that correspond to |fired_watch|.
-  for (size_t i = 0; i < watches_.size(); ++i) {
+  // Find the entries in |watches_| that correspond to |fired_watch|. The
+  // index is looked up on each iteration as UpdateWatches() may change it.
+  for (size_t i = FindWatchEntryIndex(fired_watch, 0); i < watches_.size();
+       i = FindWatchEntryIndex(fired_watch, i + 1)) {
     const WatchEntry& watch_entry = watches_[i];
-    if (fired_watch != watch_entry.watch) {
-      continue;
-    }
 
     // Check whether a path component of |target_| changed.
     bool change_on_target_path = child.empty() ||
@@ -1044,6 +1136,7 @@ void FilePathWatcherImpl::CancelImpl() {
     g_inotify_reader.Get().RemoveWatch(watch.watch, this);
   }
   watches_.clear();
+  watch_entry_indices_.clear();
   target_.clear();
   RemoveRecursiveWatches();
 
@@ -1064,6 +1157,7 @@ bool FilePathWatcherImpl::UpdateWatches() {
     watch_entry.linkname.clear();
     watch_entry.watch = g_inotify_reader.Get().AddWatch(path, this);
     if (watch_entry.watch == InotifyReader::kWatchLimitExceeded) {
+      UpdateWatchEntryIndices();
       return false;
     }
     if (watch_entry.watch == InotifyReader::kInvalidWatch) {
@@ -1073,6 +1167,7 @@ bool FilePathWatcherImpl::UpdateWatches() {
       // scenario.
       if (IsLink(path)) {
         if (!AddWatchForBrokenSymlink(path, &watch_entry)) {
+          UpdateWatchEntryIndices();
           return false;
         }
       }
@@ -1082,6 +1177,7 @@ bool FilePathWatcherImpl::UpdateWatches() {
     }
     path = path.Append(watch_entry.subdir);
   }
+  UpdateWatchEntryIndices();
 
   return UpdateRecursiveWatches(InotifyReader::kInvalidWatch, /*is_dir=*/false);
 }
@@ -1298,6 +1394,25 @@ bool FilePathWatcherImpl::HasValidWatchVector() const {
   return watches_.back().subdir.empty();
 }
 
+void FilePathWatcherImpl::UpdateWatchEntryIndices() {
+  watch_entry_indices_.clear();
+  for (size_t i = 0; i < watches_.size(); ++i) {
+    if (watches_[i].watch != InotifyReader::kInvalidWatch) {
+      watch_entry_indices_[watches_[i].watch].push_back(i);
+    }
+  }
+}
+
+size_t FilePathWatcherImpl::FindWatchEntryIndex(InotifyReader::Watch watch,
+                                                size_t start) const {
+  auto it = watch_entry_indices_.find(watch);
+  if (it == watch_entry_indices_.end()) {
+    return watches_.size();
+  }
+  auto index_it = std::lower_bound(it->second.begin(), it->second.end(), start);
+  return index_it == it->second.end() ? watches_.size() : *index_it;
+}
+
 FilePathWatcherImpl::UsageMonitor::UsageMonitor(
     base::WeakPtr<FilePathWatcherImpl> file_path_watcher_impl,
     bool report_usage_changes)
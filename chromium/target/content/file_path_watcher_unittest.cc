@@ -2096,6 +2096,32 @@ TEST_F(FilePathWatcherTest, ReturnFullPath_RecursiveInRootFolder) {
   delegate.RunUntilEventsMatch(event_expecter);
 }
 
+// Events read from inotify at once are dispatched together; check that they
+// are all reported, in order.
+TEST_F(FilePathWatcherTest, ReturnFullPath_RecursiveManyFiles) {
+  FilePathWatcher directory_watcher;
+  base::FilePath watched_folder(
+      temp_dir_.GetPath().AppendASCII("watched_folder"));
+  ASSERT_TRUE(CreateDirectory(watched_folder));
+
+  TestDelegate delegate;
+  AccumulatingEventExpecter event_expecter;
+  ASSERT_TRUE(SetupWatchWithOptions(watched_folder, &directory_watcher,
+                                    &delegate,
+                                    {.type = FilePathWatcher::Type::kRecursive,
+                                     .report_modified_path = true}));
+
+  for (int i = 0; i < 100; ++i) {
+    base::FilePath file(
+        watched_folder.AppendASCII(base::StringPrintf("file%d", i)));
+    ASSERT_TRUE(WriteFile(file, "test"));
+    for (size_t j = 0; j < kExpectedEventsForNewFileWrite; ++j) {
+      event_expecter.AddExpectedEventForPath(file);
+    }
+  }
+  delegate.RunUntilEventsMatch(event_expecter);
+}
+
 TEST_F(FilePathWatcherTest, ReturnFullPath_RecursiveInNestedFolder) {
   FilePathWatcher directory_watcher;
   base::FilePath watched_folder(
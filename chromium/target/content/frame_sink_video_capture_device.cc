@@ -4,9 +4,11 @@
 
 #include "content/browser/media/capture/frame_sink_video_capture_device.h"
 
+#include <algorithm>
 #include <optional>
 
 #include "base/check_op.h"
+#include "base/containers/flat_set.h"
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "base/location.h"
@@ -20,11 +22,13 @@
 #include "base/task/single_thread_task_runner.h"
 #include "base/time/time.h"
 #include "base/token.h"
+#include "base/values.h"
 #include "build/build_config.h"
 #include "components/viz/common/surfaces/subtree_capture_id.h"
 #include "components/viz/host/host_frame_sink_manager.h"
 #include "content/browser/compositor/surface_utils.h"
 #include "content/browser/gpu/gpu_data_manager_impl.h"
+#include "content/browser/media/media_internals.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/device_service.h"
 #include "gpu/command_buffer/common/capabilities.h"
@@ -45,12 +49,24 @@
 
 namespace content {
 
+BASE_FEATURE(kFrameSinkVideoCaptureBufferPool,
+             "FrameSinkVideoCaptureBufferPool",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 namespace {
 
 #if !BUILDFLAG(IS_ANDROID) && !BUILDFLAG(IS_IOS)
 constexpr int32_t kMouseCursorStackingIndex = 1;
 #endif
 
+// The growth of |frame_callbacks_| should be bounded because the
+// viz::mojom::FrameSinkVideoCapturer should enforce an upper-bound on the
+// number of frames in-flight.
+constexpr size_t kMaxInFlightFrames = 32;  // Arbitrarily-chosen limit.
+
+// Number of recent frames whose buffers size the buffer pool.
+constexpr size_t kBufferPoolSizingWindow = kMaxInFlightFrames;
+
 // Transfers ownership of an object to a std::unique_ptr with a custom deleter
 // that ensures the object is destroyed on the UI BrowserThread.
 template <typename T>
@@ -426,6 +442,7 @@ void FrameSinkVideoCaptureDevice::StopAndDeAllocate() {
   MaybeStopConsuming();
   capturer_.reset();
   context_provider_observer_.reset();
+  ReleaseBufferPool();
   if (receiver_) {
     receiver_.reset();
     DidStop();
@@ -469,24 +486,41 @@ void FrameSinkVideoCaptureDevice::OnFrameCaptured(
     return;
   }
 
-  // Search for the next available element in |frame_callbacks_| and bind
-  // |callbacks| there.
-  size_t index = 0;
-  for (;; ++index) {
-    if (index == frame_callbacks_.size()) {
-      // The growth of |frame_callbacks_| should be bounded because the
-      // viz::mojom::FrameSinkVideoCapturer should enforce an upper-bound on the
-      // number of frames in-flight.
-      constexpr size_t kMaxInFlightFrames = 32;  // Arbitrarily-chosen limit.
-      DCHECK_LT(frame_callbacks_.size(), kMaxInFlightFrames);
-      frame_callbacks_.emplace_back(std::move(callbacks_remote));
-      break;
+  // Pick the element of |frame_callbacks_| to bind |callbacks| to. Its index
+  // is the BufferId the frame is delivered in.
+  const bool use_buffer_pool =
+      data->is_read_only_shmem_region() &&
+      base::FeatureList::IsEnabled(kFrameSinkVideoCaptureBufferPool);
+  bool is_new_buffer = true;
+  size_t index;
+  if (use_buffer_pool) {
+    ReleasePooledBuffersOfOtherFormats(info->pixel_format, info->coded_size);
+    const base::UnguessableToken& guid =
+        data->get_read_only_shmem_region().GetGUID();
+    recent_buffer_guids_.push_back(guid);
+    if (recent_buffer_guids_.size() > kBufferPoolSizingWindow) {
+      recent_buffer_guids_.pop_front();
     }
-    if (!frame_callbacks_[index].is_bound()) {
-      frame_callbacks_[index] = std::move(callbacks_remote);
-      break;
+    ++buffer_pool_stats_.frames_delivered;
+    const std::optional<size_t> pooled_index =
+        AcquirePooledBuffer(guid, &is_new_buffer);
+    if (pooled_index) {
+      index = *pooled_index;
+      pooled_buffers_[index].pixel_format = info->pixel_format;
+      pooled_buffers_[index].coded_size = info->coded_size;
+      pooled_buffers_[index].last_delivery_time = base::TimeTicks::Now();
+      if (!is_new_buffer) {
+        ++buffer_pool_stats_.buffers_reused;
+      }
+    } else {
+      // Deliver the frame in a buffer of its own, as without the pool.
+      ++buffer_pool_stats_.frames_not_pooled;
+      index = AllocateFrameSlot();
     }
+  } else {
+    index = AllocateFrameSlot();
   }
+  frame_callbacks_[index] = std::move(callbacks_remote);
   const BufferId buffer_id = static_cast<BufferId>(index);
 
 #if !BUILDFLAG(IS_ANDROID) && !BUILDFLAG(IS_IOS)
@@ -504,15 +538,22 @@ void FrameSinkVideoCaptureDevice::OnFrameCaptured(
   }
 
   // Pass the video frame to the VideoFrameReceiver. This is done by first
-  // passing the shared memory buffer handle and then notifying it that a new
-  // frame is ready to be read from the buffer.
-  receiver_->OnNewBuffer(buffer_id, std::move(data));
+  // passing the shared memory buffer handle, unless the receiver already has it
+  // from an earlier frame in the same pooled buffer, and then notifying it that
+  // a new frame is ready to be read from the buffer.
+  if (is_new_buffer) {
+    receiver_->OnNewBuffer(buffer_id, std::move(data));
+  }
   receiver_->OnFrameReadyInBuffer(media::ReadyFrameInBuffer(
       buffer_id, buffer_id,
       std::make_unique<media::ScopedFrameDoneHelper>(base::BindOnce(
           &FrameSinkVideoCaptureDevice::OnFramePropagationComplete,
           weak_factory_.GetWeakPtr(), buffer_id)),
       std::move(info)));
+
+  if (use_buffer_pool) {
+    MaybeReportBufferPoolStats();
+  }
 }
 
 void FrameSinkVideoCaptureDevice::OnNewSubCaptureTargetVersion(
@@ -623,19 +664,196 @@ void FrameSinkVideoCaptureDevice::OnFramePropagationComplete(
     BufferId buffer_id) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  // Notify the VideoFrameReceiver that the buffer is no longer valid.
-  if (receiver_) {
-    receiver_->OnBufferRetired(buffer_id);
+  const size_t index = static_cast<size_t>(buffer_id);
+  DCHECK_LT(index, frame_callbacks_.size());
+  const PooledBuffer& pooled_buffer = pooled_buffers_[index];
+  if (pooled_buffer.guid.is_empty()) {
+    // Notify the VideoFrameReceiver that the buffer is no longer valid.
+    if (receiver_) {
+      receiver_->OnBufferRetired(buffer_id);
+    }
+  } else {
+    // Pooled buffers stay registered with the VideoFrameReceiver, to be reused
+    // by the next frame the capturer delivers in them.
+    const base::TimeDelta latency =
+        base::TimeTicks::Now() - pooled_buffer.last_delivery_time;
+    consumer_latency_ = consumer_latency_.is_zero()
+                            ? latency
+                            : (consumer_latency_ * 7 + latency) / 8;
   }
 
   // Notify the capturer that consumption of the frame is complete.
-  const size_t index = static_cast<size_t>(buffer_id);
-  DCHECK_LT(index, frame_callbacks_.size());
   auto& callbacks_ptr = frame_callbacks_[index];
   callbacks_ptr->Done();
   callbacks_ptr.reset();
 }
 
+size_t FrameSinkVideoCaptureDevice::AllocateFrameSlot() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  for (size_t index = 0; index < frame_callbacks_.size(); ++index) {
+    if (!frame_callbacks_[index].is_bound() &&
+        pooled_buffers_[index].guid.is_empty()) {
+      return index;
+    }
+  }
+  DCHECK_LT(frame_callbacks_.size(), kMaxInFlightFrames);
+  frame_callbacks_.emplace_back();
+  pooled_buffers_.emplace_back();
+  return frame_callbacks_.size() - 1;
+}
+
+std::optional<size_t> FrameSinkVideoCaptureDevice::AcquirePooledBuffer(
+    const base::UnguessableToken& guid,
+    bool* is_new_buffer) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(receiver_);
+
+  size_t pool_size = 0;
+  std::optional<size_t> lru_idle_index;
+  for (size_t index = 0; index < pooled_buffers_.size(); ++index) {
+    const PooledBuffer& pooled_buffer = pooled_buffers_[index];
+    if (pooled_buffer.guid.is_empty()) {
+      continue;
+    }
+    const bool in_flight = frame_callbacks_[index].is_bound();
+    if (pooled_buffer.guid == guid) {
+      // The capturer reuses a buffer once it considers the frame previously
+      // delivered in it done, which can be before `receiver_` has released
+      // that frame, e.g. after the capturer was restarted. The BufferId is
+      // still taken by that frame then.
+      if (in_flight) {
+        return std::nullopt;
+      }
+      *is_new_buffer = false;
+      return index;
+    }
+    ++pool_size;
+    if (!in_flight &&
+        (!lru_idle_index || pooled_buffer.last_delivery_time <
+                                pooled_buffers_[*lru_idle_index]
+                                    .last_delivery_time)) {
+      lru_idle_index = index;
+    }
+  }
+
+  *is_new_buffer = true;
+  size_t index;
+  if (pool_size < GetTargetBufferPoolSize()) {
+    index = AllocateFrameSlot();
+  } else if (lru_idle_index) {
+    index = *lru_idle_index;
+    ++buffer_pool_stats_.buffers_evicted;
+    receiver_->OnBufferRetired(static_cast<BufferId>(index));
+  } else {
+    return std::nullopt;
+  }
+  pooled_buffers_[index].guid = guid;
+  return index;
+}
+
+void FrameSinkVideoCaptureDevice::ReleasePooledBuffersOfOtherFormats(
+    media::VideoPixelFormat pixel_format,
+    const gfx::Size& coded_size) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(receiver_);
+
+  for (size_t index = 0; index < pooled_buffers_.size(); ++index) {
+    PooledBuffer& pooled_buffer = pooled_buffers_[index];
+    if (pooled_buffer.guid.is_empty() ||
+        (pooled_buffer.pixel_format == pixel_format &&
+         pooled_buffer.coded_size == coded_size)) {
+      continue;
+    }
+    // Buffers still in flight are retired in OnFramePropagationComplete().
+    if (!frame_callbacks_[index].is_bound()) {
+      receiver_->OnBufferRetired(static_cast<BufferId>(index));
+    }
+    pooled_buffer = PooledBuffer();
+  }
+}
+
+size_t FrameSinkVideoCaptureDevice::GetTargetBufferPoolSize() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  // The capturer cycles through buffers of its own, so the pool needs one entry
+  // for each buffer it recently delivered a frame in.
+  const base::flat_set<base::UnguessableToken> recent_buffers(
+      recent_buffer_guids_.begin(), recent_buffer_guids_.end());
+  return std::clamp(recent_buffers.size(), size_t{1}, kMaxInFlightFrames);
+}
+
+void FrameSinkVideoCaptureDevice::ReleaseBufferPool() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  for (size_t index = 0; index < pooled_buffers_.size(); ++index) {
+    PooledBuffer& pooled_buffer = pooled_buffers_[index];
+    if (pooled_buffer.guid.is_empty()) {
+      continue;
+    }
+    // Buffers still in flight are retired in OnFramePropagationComplete().
+    if (receiver_ && !frame_callbacks_[index].is_bound()) {
+      receiver_->OnBufferRetired(static_cast<BufferId>(index));
+    }
+    pooled_buffer = PooledBuffer();
+  }
+  consumer_latency_ = base::TimeDelta();
+  recent_buffer_guids_.clear();
+  buffer_pool_stats_ = BufferPoolStats();
+  last_buffer_pool_stats_report_time_ = base::TimeTicks();
+
+  if (!buffer_pool_stats_id_.empty()) {
+    // An empty update removes this device from chrome://media-internals.
+    GetIOThreadTaskRunner({})->PostTask(
+        FROM_HERE,
+        base::BindOnce(&MediaInternals::UpdateVideoCaptureBufferPoolStats,
+                       base::Unretained(MediaInternals::GetInstance()),
+                       std::move(buffer_pool_stats_id_), base::Value::Dict()));
+    buffer_pool_stats_id_.clear();
+  }
+}
+
+void FrameSinkVideoCaptureDevice::MaybeReportBufferPoolStats() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  const base::TimeTicks now = base::TimeTicks::Now();
+  if (last_buffer_pool_stats_report_time_.is_null()) {
+    // Wait for a second's worth of counters before the first report.
+    last_buffer_pool_stats_report_time_ = now;
+    return;
+  }
+  if (now - last_buffer_pool_stats_report_time_ < base::Seconds(1)) {
+    return;
+  }
+  last_buffer_pool_stats_report_time_ = now;
+
+  if (buffer_pool_stats_id_.empty()) {
+    buffer_pool_stats_id_ = base::UnguessableToken::Create().ToString();
+  }
+  const size_t pool_size = static_cast<size_t>(std::ranges::count_if(
+      pooled_buffers_,
+      [](const PooledBuffer& buffer) { return !buffer.guid.is_empty(); }));
+
+  base::Value::Dict stats;
+  stats.Set("poolSize", base::saturated_cast<int>(pool_size));
+  stats.Set("targetPoolSize",
+            base::saturated_cast<int>(GetTargetBufferPoolSize()));
+  stats.Set("consumerLatencyMs", consumer_latency_.InMillisecondsF());
+  stats.Set("framesDelivered",
+            base::saturated_cast<int>(buffer_pool_stats_.frames_delivered));
+  stats.Set("buffersReused",
+            base::saturated_cast<int>(buffer_pool_stats_.buffers_reused));
+  stats.Set("buffersEvicted",
+            base::saturated_cast<int>(buffer_pool_stats_.buffers_evicted));
+  stats.Set("framesNotPooled",
+            base::saturated_cast<int>(buffer_pool_stats_.frames_not_pooled));
+  GetIOThreadTaskRunner({})->PostTask(
+      FROM_HERE,
+      base::BindOnce(&MediaInternals::UpdateVideoCaptureBufferPoolStats,
+                     base::Unretained(MediaInternals::GetInstance()),
+                     buffer_pool_stats_id_, std::move(stats)));
+}
+
 void FrameSinkVideoCaptureDevice::OnFatalError(std::string message) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -12,9 +12,13 @@
 #include <vector>
 
 #include "base/check.h"
+#include "base/containers/circular_deque.h"
+#include "base/feature_list.h"
 #include "base/functional/callback_forward.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "base/unguessable_token.h"
 #include "build/build_config.h"
 #include "components/viz/common/gpu/context_lost_observer.h"
 #include "components/viz/common/surfaces/frame_sink_id.h"
@@ -34,6 +38,7 @@
 #include "services/device/public/mojom/wake_lock.mojom.h"
 #include "services/viz/public/cpp/compositing/video_capture_target_mojom_traits.h"
 #include "ui/compositor/compositor.h"
+#include "ui/gfx/geometry/size.h"
 
 namespace content {
 
@@ -41,6 +46,11 @@ class MouseCursorOverlayController;
 
 class ContextProviderObserver;
 
+// When enabled, shared memory frames are delivered from a fixed-size pool of
+// buffers that stay registered with the VideoFrameReceiver across frames, so
+// that the receiver does not have to re-import (map) every frame's buffer.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kFrameSinkVideoCaptureBufferPool);
+
 // A virtualized VideoCaptureDevice that captures the displayed contents of a
 // frame sink (see viz::CompositorFrameSink), such as the composited main view
 // of a WebContents instance, producing a stream of video frames.
@@ -175,6 +185,36 @@ class CONTENT_EXPORT FrameSinkVideoCaptureDevice
   // Notifies the capturer that consumption of the frame is complete.
   void OnFramePropagationComplete(BufferId buffer_id);
 
+  // Returns the index of an entry in `frame_callbacks_` that is neither in use
+  // by a frame nor holding a pooled buffer, growing the vector if needed.
+  size_t AllocateFrameSlot();
+
+  // Returns the index under which to deliver a frame in the shared memory
+  // buffer identified by `guid`. If the buffer is not pooled yet, it is added
+  // to the pool, evicting the least recently used idle buffer if the pool is
+  // full, and `is_new_buffer` is set. Returns std::nullopt if the buffer is
+  // still in flight, or the pool is full and all of its buffers are in flight;
+  // the frame is then delivered outside of the pool.
+  std::optional<size_t> AcquirePooledBuffer(const base::UnguessableToken& guid,
+                                            bool* is_new_buffer);
+
+  // Removes the pooled buffers holding frames of another format or size than
+  // given, which the capturer won't deliver frames in anymore, and retires
+  // them from `receiver_`.
+  void ReleasePooledBuffersOfOtherFormats(media::VideoPixelFormat pixel_format,
+                                          const gfx::Size& coded_size);
+
+  // Returns the number of distinct buffers the capturer delivered the last
+  // frames in, capped by the number of frames that can be in flight.
+  size_t GetTargetBufferPoolSize() const;
+
+  // Retires all pooled buffers from `receiver_`.
+  void ReleaseBufferPool();
+
+  // Sends the buffer pool counters to chrome://media-internals, at most once
+  // per second.
+  void MaybeReportBufferPoolStats();
+
   // Helper that logs the given error |message| to the |receiver_| and then
   // stops capture and this VideoCaptureDevice.
   void OnFatalError(std::string message);
@@ -225,6 +265,44 @@ class CONTENT_EXPORT FrameSinkVideoCaptureDevice
   std::vector<mojo::Remote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks>>
       frame_callbacks_;
 
+  // The shared memory buffer registered with `receiver_` under each BufferId,
+  // when using kFrameSinkVideoCaptureBufferPool. Indexed like
+  // `frame_callbacks_`.
+  struct PooledBuffer {
+    // GUID of the buffer's shared memory region. Empty if the BufferId has no
+    // pooled buffer.
+    base::UnguessableToken guid;
+    // Format and size of the frames delivered in this buffer.
+    media::VideoPixelFormat pixel_format = media::PIXEL_FORMAT_UNKNOWN;
+    gfx::Size coded_size;
+    // When the last frame in this buffer was delivered to `receiver_`.
+    base::TimeTicks last_delivery_time;
+  };
+  std::vector<PooledBuffer> pooled_buffers_;
+
+  // Moving average of the time `receiver_` holds on to a pooled frame.
+  base::TimeDelta consumer_latency_;
+
+  // GUIDs of the buffers of the last frames, which size the pool.
+  base::circular_deque<base::UnguessableToken> recent_buffer_guids_;
+
+  // Counters reported to chrome://media-internals.
+  struct BufferPoolStats {
+    size_t frames_delivered = 0;
+    // Frames delivered in an already registered buffer.
+    size_t buffers_reused = 0;
+    // Buffers retired to make room for a new one because the pool was full.
+    size_t buffers_evicted = 0;
+    // Frames delivered outside of the pool because their buffer, or all
+    // pooled buffers, were in flight.
+    size_t frames_not_pooled = 0;
+  };
+  BufferPoolStats buffer_pool_stats_;
+  base::TimeTicks last_buffer_pool_stats_report_time_;
+  // Identifies this device in chrome://media-internals. Empty until the first
+  // report.
+  std::string buffer_pool_stats_id_;
+
   // Set when `OnFatalError()` is called. This prevents any future
   // AllocateAndStartWithReceiver() calls from succeeding.
   std::optional<std::string> fatal_error_message_;
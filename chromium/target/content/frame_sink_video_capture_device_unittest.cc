@@ -11,6 +11,7 @@
 
 #include <array>
 #include <memory>
+#include <vector>
 
 #include "base/containers/flat_map.h"
 #include "base/functional/bind.h"
@@ -18,6 +19,7 @@
 #include "base/memory/raw_ptr.h"
 #include "base/memory/read_only_shared_memory_region.h"
 #include "base/memory/shared_memory_mapping.h"
+#include "base/test/scoped_feature_list.h"
 #include "components/viz/common/surfaces/region_capture_bounds.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
@@ -41,6 +43,7 @@ using testing::ByRef;
 using testing::Eq;
 using testing::Expectation;
 using testing::Ge;
+using testing::Mock;
 using testing::NiceMock;
 using testing::NotNull;
 using testing::SaveArg;
@@ -392,7 +395,17 @@ class FrameSinkVideoCaptureDeviceTest : public testing::Test {
     CHECK(region.IsValid());
     memset(region.mapping.memory(), GetFrameFillValue(frame_number),
            region.mapping.size());
+    SimulateFrameCaptureInBuffer(frame_number, std::move(region.region),
+                                 callbacks);
+  }
 
+  // Like SimulateFrameCapture(), but delivers the frame in the given |buffer|,
+  // as the VIZ capturer does when it recycles its buffers.
+  void SimulateFrameCaptureInBuffer(
+      int frame_number,
+      base::ReadOnlySharedMemoryRegion buffer,
+      MockFrameSinkVideoConsumerFrameCallbacks* callbacks,
+      const gfx::Size& resolution = kResolution) {
     mojo::PendingRemote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks>
         callbacks_remote;
     callbacks->Bind(callbacks_remote.InitWithNewPipeAndPassReceiver());
@@ -401,6 +414,7 @@ class FrameSinkVideoCaptureDeviceTest : public testing::Test {
     POST_DEVICE_TASK(base::BindOnce(
         [](FrameSinkVideoCaptureDevice* device,
            base::ReadOnlySharedMemoryRegion data, int frame_number,
+           const gfx::Size& resolution,
            mojo::PendingRemote<viz::mojom::FrameSinkVideoConsumerFrameCallbacks>
                callbacks_remote) {
           device->OnFrameCaptured(
@@ -408,12 +422,12 @@ class FrameSinkVideoCaptureDeviceTest : public testing::Test {
                   std::move(data)),
               media::mojom::VideoFrameInfo::New(
                   kMinCapturePeriod * frame_number, media::VideoFrameMetadata(),
-                  kFormat, kResolution, gfx::Rect(kResolution), kNotPremapped,
+                  kFormat, resolution, gfx::Rect(resolution), kNotPremapped,
                   gfx::ColorSpace::CreateREC709(), nullptr),
-              gfx::Rect(kResolution), std::move(callbacks_remote));
+              gfx::Rect(resolution), std::move(callbacks_remote));
         },
-        base::Unretained(device_.get()), std::move(region.region), frame_number,
-        std::move(callbacks_remote)));
+        base::Unretained(device_.get()), std::move(buffer), frame_number,
+        resolution, std::move(callbacks_remote)));
   }
 
   // Returns a byte value based on the given |frame_number|.
@@ -535,6 +549,197 @@ TEST_F(FrameSinkVideoCaptureDeviceTest, CapturesAndDeliversFrames) {
   StopAndDeAllocateSynchronouslyWithExpectations(true /* capturer will stop */);
 }
 
+// Tests that, with kFrameSinkVideoCaptureBufferPool, frames delivered in the
+// same shared memory buffer reuse its registration with the receiver, and that
+// the pooled buffer is only retired when capture stops.
+TEST_F(FrameSinkVideoCaptureDeviceTest, ReusesPooledBuffers) {
+  base::test::ScopedFeatureList feature_list(kFrameSinkVideoCaptureBufferPool);
+  auto receiver_ptr = std::make_unique<MockVideoFrameReceiver>();
+  auto* const receiver = receiver_ptr.get();
+  EXPECT_CALL(*receiver, OnStarted());
+  EXPECT_CALL(*receiver, OnError(_)).Times(0);
+  EXPECT_CALL(*receiver, OnFrameDropped(_)).Times(0);
+
+  AllocateAndStartSynchronouslyWithExpectations(std::move(receiver_ptr));
+
+  base::MappedReadOnlyRegion region = base::ReadOnlySharedMemoryRegion::Create(
+      media::VideoFrame::AllocationSize(kFormat, kResolution));
+  ASSERT_TRUE(region.IsValid());
+
+  // The buffer is registered with the receiver for the first frame only.
+  int buffer_id = -1;
+  EXPECT_CALL(*receiver, MockOnNewBuffer(Ge(0), NotNull()))
+      .WillOnce(SaveArg<0>(&buffer_id));
+  EXPECT_CALL(*receiver, OnBufferRetired(_)).Times(0);
+
+  constexpr int kNumFramesToDeliver = 4;
+  for (int frame_number = 0; frame_number < kNumFramesToDeliver;
+       ++frame_number) {
+    MockFrameSinkVideoConsumerFrameCallbacks callbacks;
+    EXPECT_CALL(*receiver,
+                MockOnFrameReadyInBuffer(Eq(ByRef(buffer_id)), Ge(0),
+                                         NotNull(), NotNull()));
+    SimulateFrameCaptureInBuffer(frame_number, region.region.Duplicate(),
+                                 &callbacks);
+    WAIT_FOR_DEVICE_TASKS();
+
+    if (frame_number == 0) {
+      EXPECT_TRUE(receiver->TakeBufferHandle(buffer_id).IsValid());
+    }
+    const auto info = receiver->TakeVideoFrameInfo(buffer_id);
+    ASSERT_TRUE(info);
+    EXPECT_EQ(kMinCapturePeriod * frame_number, info->timestamp);
+    receiver->TakeFeedbackId(buffer_id);
+
+    EXPECT_CALL(callbacks, Done());
+    receiver->ReleaseAccessPermission(buffer_id);
+    WAIT_FOR_DEVICE_TASKS();
+  }
+
+  EXPECT_CALL(*receiver, OnBufferRetired(buffer_id));
+  StopAndDeAllocateSynchronouslyWithExpectations(true /* capturer will stop */);
+}
+
+// Tests that, with kFrameSinkVideoCaptureBufferPool, a frame delivered in a
+// pooled buffer that the receiver still holds is delivered in a buffer of its
+// own instead, which is retired once the receiver is done with it.
+TEST_F(FrameSinkVideoCaptureDeviceTest, DeliversFrameUnpooledIfBufferInFlight) {
+  base::test::ScopedFeatureList feature_list(kFrameSinkVideoCaptureBufferPool);
+  auto receiver_ptr = std::make_unique<NiceMock<MockVideoFrameReceiver>>();
+  auto* const receiver = receiver_ptr.get();
+  EXPECT_CALL(*receiver, OnFrameDropped(_)).Times(0);
+  AllocateAndStartSynchronouslyWithExpectations(std::move(receiver_ptr));
+
+  base::MappedReadOnlyRegion region = base::ReadOnlySharedMemoryRegion::Create(
+      media::VideoFrame::AllocationSize(kFormat, kResolution));
+  ASSERT_TRUE(region.IsValid());
+
+  int buffer_ids[2] = {-1, -1};
+  EXPECT_CALL(*receiver, MockOnNewBuffer(Ge(0), NotNull()))
+      .WillOnce(SaveArg<0>(&buffer_ids[0]))
+      .WillOnce(SaveArg<0>(&buffer_ids[1]));
+  EXPECT_CALL(*receiver, OnBufferRetired(_)).Times(0);
+  MockFrameSinkVideoConsumerFrameCallbacks callbacks[2];
+  for (int frame_number = 0; frame_number < 2; ++frame_number) {
+    SimulateFrameCaptureInBuffer(frame_number, region.region.Duplicate(),
+                                 &callbacks[frame_number]);
+    WAIT_FOR_DEVICE_TASKS();
+  }
+  EXPECT_NE(buffer_ids[0], buffer_ids[1]);
+  for (int buffer_id : buffer_ids) {
+    EXPECT_TRUE(receiver->TakeBufferHandle(buffer_id).IsValid());
+    ASSERT_TRUE(receiver->TakeVideoFrameInfo(buffer_id));
+    receiver->TakeFeedbackId(buffer_id);
+  }
+
+  // Only the unpooled buffer is retired once released.
+  EXPECT_CALL(*receiver, OnBufferRetired(Eq(ByRef(buffer_ids[1]))));
+  EXPECT_CALL(callbacks[1], Done());
+  receiver->ReleaseAccessPermission(buffer_ids[1]);
+  WAIT_FOR_DEVICE_TASKS();
+  Mock::VerifyAndClearExpectations(receiver);
+
+  EXPECT_CALL(*receiver, OnBufferRetired(Eq(ByRef(buffer_ids[0])))).Times(0);
+  EXPECT_CALL(callbacks[0], Done());
+  receiver->ReleaseAccessPermission(buffer_ids[0]);
+  WAIT_FOR_DEVICE_TASKS();
+  Mock::VerifyAndClearExpectations(receiver);
+
+  EXPECT_CALL(*receiver, OnBufferRetired(Eq(ByRef(buffer_ids[0]))));
+  StopAndDeAllocateSynchronouslyWithExpectations(true /* capturer will stop */);
+}
+
+// Tests that, with kFrameSinkVideoCaptureBufferPool, the pool grows to hold
+// every buffer the capturer cycles through, so none of them is retired.
+TEST_F(FrameSinkVideoCaptureDeviceTest, SizesPoolByBuffersInUse) {
+  base::test::ScopedFeatureList feature_list(kFrameSinkVideoCaptureBufferPool);
+  auto receiver_ptr = std::make_unique<NiceMock<MockVideoFrameReceiver>>();
+  auto* const receiver = receiver_ptr.get();
+  EXPECT_CALL(*receiver, OnFrameDropped(_)).Times(0);
+  AllocateAndStartSynchronouslyWithExpectations(std::move(receiver_ptr));
+
+  constexpr int kNumCapturerBuffers = 6;
+  std::vector<base::ReadOnlySharedMemoryRegion> regions;
+  for (int i = 0; i < kNumCapturerBuffers; ++i) {
+    base::MappedReadOnlyRegion region =
+        base::ReadOnlySharedMemoryRegion::Create(
+            media::VideoFrame::AllocationSize(kFormat, kResolution));
+    ASSERT_TRUE(region.IsValid());
+    regions.push_back(std::move(region.region));
+  }
+
+  EXPECT_CALL(*receiver, MockOnNewBuffer(Ge(0), NotNull()))
+      .Times(kNumCapturerBuffers);
+  EXPECT_CALL(*receiver, OnBufferRetired(_)).Times(0);
+  for (int frame_number = 0; frame_number < 3 * kNumCapturerBuffers;
+       ++frame_number) {
+    MockFrameSinkVideoConsumerFrameCallbacks callbacks;
+    int buffer_id = -1;
+    EXPECT_CALL(*receiver, MockOnFrameReadyInBuffer(Ge(0), Ge(0), NotNull(),
+                                                    NotNull()))
+        .WillOnce(SaveArg<0>(&buffer_id));
+    SimulateFrameCaptureInBuffer(
+        frame_number, regions[frame_number % kNumCapturerBuffers].Duplicate(),
+        &callbacks);
+    WAIT_FOR_DEVICE_TASKS();
+
+    receiver->TakeBufferHandle(buffer_id);
+    receiver->TakeVideoFrameInfo(buffer_id);
+    receiver->TakeFeedbackId(buffer_id);
+    EXPECT_CALL(callbacks, Done());
+    receiver->ReleaseAccessPermission(buffer_id);
+    WAIT_FOR_DEVICE_TASKS();
+  }
+  Mock::VerifyAndClearExpectations(receiver);
+
+  EXPECT_CALL(*receiver, OnBufferRetired(_)).Times(kNumCapturerBuffers);
+  StopAndDeAllocateSynchronouslyWithExpectations(true /* capturer will stop */);
+}
+
+// Tests that, with kFrameSinkVideoCaptureBufferPool, the pooled buffers of the
+// old size are retired once frames arrive in the new size.
+TEST_F(FrameSinkVideoCaptureDeviceTest, ReleasesPooledBuffersOnResize) {
+  base::test::ScopedFeatureList feature_list(kFrameSinkVideoCaptureBufferPool);
+  auto receiver_ptr = std::make_unique<NiceMock<MockVideoFrameReceiver>>();
+  auto* const receiver = receiver_ptr.get();
+  EXPECT_CALL(*receiver, OnFrameDropped(_)).Times(0);
+  AllocateAndStartSynchronouslyWithExpectations(std::move(receiver_ptr));
+
+  constexpr gfx::Size kNewResolution(640, 360);
+  int buffer_ids[2] = {-1, -1};
+  EXPECT_CALL(*receiver, MockOnNewBuffer(Ge(0), NotNull()))
+      .WillOnce(SaveArg<0>(&buffer_ids[0]))
+      .WillOnce(SaveArg<0>(&buffer_ids[1]));
+  EXPECT_CALL(*receiver, OnBufferRetired(_)).Times(0);
+  for (int frame_number = 0; frame_number < 2; ++frame_number) {
+    const gfx::Size resolution =
+        frame_number == 0 ? kResolution : kNewResolution;
+    base::MappedReadOnlyRegion region =
+        base::ReadOnlySharedMemoryRegion::Create(
+            media::VideoFrame::AllocationSize(kFormat, resolution));
+    ASSERT_TRUE(region.IsValid());
+    if (frame_number == 1) {
+      EXPECT_CALL(*receiver, OnBufferRetired(Eq(ByRef(buffer_ids[0]))));
+    }
+
+    MockFrameSinkVideoConsumerFrameCallbacks callbacks;
+    SimulateFrameCaptureInBuffer(frame_number, std::move(region.region),
+                                 &callbacks, resolution);
+    WAIT_FOR_DEVICE_TASKS();
+
+    const int buffer_id = buffer_ids[frame_number];
+    receiver->TakeBufferHandle(buffer_id);
+    receiver->TakeVideoFrameInfo(buffer_id);
+    receiver->TakeFeedbackId(buffer_id);
+    EXPECT_CALL(callbacks, Done());
+    receiver->ReleaseAccessPermission(buffer_id);
+    WAIT_FOR_DEVICE_TASKS();
+  }
+
+  EXPECT_CALL(*receiver, OnBufferRetired(Eq(ByRef(buffer_ids[1]))));
+  StopAndDeAllocateSynchronouslyWithExpectations(true /* capturer will stop */);
+}
+
 // Tests that a client request to Suspend() should stop consumption and ignore
 // all refresh requests. Likewise, a client request to Resume() will
 // re-establish consumption and allow refresh requests to propagate to the
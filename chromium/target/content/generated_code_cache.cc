@@ -277,6 +277,29 @@ void GeneratedCodeCache::CollectStatistics(
   }
 }
 
+void GeneratedCodeCache::CollectDedupBodyCacheStatistics(bool hit,
+                                                         uint32_t data_size) {
+  if (hit) {
+    dedup_body_cache_stats_.hits++;
+    dedup_body_cache_stats_.bytes_saved += data_size;
+  } else {
+    dedup_body_cache_stats_.misses++;
+  }
+
+  const char* type_name =
+      cache_type_ == CodeCacheType::kWebAssembly ? "WASM" : "JS";
+  base::UmaHistogramBoolean(
+      base::StrCat({"SiteIsolatedCodeCache.", type_name,
+                    ".DeduplicatedBodyMemoryCache.Hit"}),
+      hit);
+  if (hit) {
+    base::UmaHistogramMemoryKB(
+        base::StrCat({"SiteIsolatedCodeCache.", type_name,
+                      ".DeduplicatedBodyMemoryCache.BytesSaved"}),
+        data_size / 1024);
+  }
+}
+
 // Stores the information about a pending request while disk backend is
 // being initialized or another request for the same key is live.
 class GeneratedCodeCache::PendingOperation {
@@ -442,7 +465,18 @@ GeneratedCodeCache::GeneratedCodeCache(const base::FilePath& path,
       cache_type_(cache_type),
       lru_cache_(max_size_bytes == 0
                      ? kLruCacheCapacity
-                     : std::min<int64_t>(kLruCacheCapacity, max_size_bytes)) {
+                     : std::min<int64_t>(kLruCacheCapacity, max_size_bytes)),
+      dedup_body_cache_(
+          max_size_bytes == 0
+              ? kDedupBodyCacheCapacity
+              : std::min<int64_t>(kDedupBodyCacheCapacity, max_size_bytes)) {
+  if (IsDeduplicationEnabled() &&
+      base::FeatureList::IsEnabled(
+          features::kInMemoryDeduplicatedCodeCache)) {
+    memory_pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+        FROM_HERE, base::BindRepeating(&GeneratedCodeCache::OnMemoryPressure,
+                                       base::Unretained(this)));
+  }
   CreateBackend();
 }
 
@@ -525,6 +559,10 @@ void GeneratedCodeCache::WriteEntry(const GURL& url,
         result, std::size(result));
     std::string checksum_key = base::HexEncode(result);
     DCHECK_EQ(kSHAKeySizeInBytes, checksum_key.length());
+    if (base::FeatureList::IsEnabled(
+            features::kInMemoryDeduplicatedCodeCache)) {
+      dedup_body_cache_.Put(checksum_key, base::Time(), base::span(copy));
+    }
     small_buffer = base::MakeRefCounted<net::IOBufferWithSize>(
         kHeaderSizeInBytes + checksum_key.length());
     // Copy |checksum_key| into the small buffer.
@@ -884,6 +922,9 @@ void GeneratedCodeCache::ReadComplete(PendingOperation* op) {
          Operation::kFetchWithSHAKey == op->operation());
   if (!op->succeeded()) {
     op->RunReadCallback(this, base::Time(), mojo_base::BigBuffer());
+    if (op->operation() == Operation::kFetchWithSHAKey) {
+      dedup_body_cache_.Delete(op->key());
+    }
     // Doom this entry since it is inaccessible.
     DoomEntry(op);
   } else {
@@ -910,6 +951,20 @@ void GeneratedCodeCache::ReadComplete(PendingOperation* op) {
         std::string checksum_key(
             UNSAFE_TODO(op->small_buffer()->data() + kHeaderSizeInBytes),
             kSHAKeySizeInBytes);
+        if (base::FeatureList::IsEnabled(
+                features::kInMemoryDeduplicatedCodeCache)) {
+          // The body is keyed by its checksum, so a cached copy is always
+          // valid for any origin referring to it. Serve it without issuing
+          // the second disk read.
+          auto cached = dedup_body_cache_.Get(checksum_key);
+          const bool hit = cached && cached->data.size() == data_size;
+          CollectDedupBodyCacheStatistics(hit, data_size);
+          if (hit) {
+            op->RunReadCallback(this, response_time, std::move(cached->data));
+            CloseOperationAndIssueNext(op);
+            return;
+          }
+        }
         auto small_buffer = base::MakeRefCounted<net::IOBufferWithSize>(0);
         auto large_buffer = base::MakeRefCounted<BigIOBuffer>(data_size);
         auto op2 = std::make_unique<PendingOperation>(
@@ -920,8 +975,12 @@ void GeneratedCodeCache::ReadComplete(PendingOperation* op) {
       }
     } else {
       // Large merged code data with no header. |op| holds the response time.
-      op->RunReadCallback(this, op->response_time(),
-                          op->large_buffer()->TakeBuffer());
+      mojo_base::BigBuffer data = op->large_buffer()->TakeBuffer();
+      if (base::FeatureList::IsEnabled(
+              features::kInMemoryDeduplicatedCodeCache)) {
+        dedup_body_cache_.Put(op->key(), base::Time(), base::span(data));
+      }
+      op->RunReadCallback(this, op->response_time(), std::move(data));
     }
   }
   CloseOperationAndIssueNext(op);
@@ -1040,6 +1099,18 @@ void GeneratedCodeCache::SetLastUsedTimeForTest(
 
 void GeneratedCodeCache::ClearInMemoryCache() {
   lru_cache_.Clear();
+  dedup_body_cache_.Clear();
+}
+
+void GeneratedCodeCache::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  if (memory_pressure_level ==
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE) {
+    return;
+  }
+  // Every body held here can be read back from the disk cache, so dropping
+  // them only costs the extra read.
+  dedup_body_cache_.Clear();
 }
 
 void GeneratedCodeCache::OpenCompleteForSetLastUsedForTest(
@@ -10,6 +10,7 @@
 
 #include "base/containers/queue.h"
 #include "base/files/file_path.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/weak_ptr.h"
 #include "base/timer/timer.h"
 #include "content/browser/code_cache/simple_lru_cache.h"
@@ -81,6 +82,15 @@ class CONTENT_EXPORT GeneratedCodeCache {
     kMaxValue = kWriteFailed
   };
 
+  // Counters for the in-memory tier of deduplicated code bodies. See
+  // |dedup_body_cache_|.
+  struct DedupBodyCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Bytes served from memory instead of being read from the disk cache.
+    uint64_t bytes_saved = 0;
+  };
+
   // Returns the resource URL from the key. The key has the format prefix +
   // resource URL + separator + requesting origin. This function extracts and
   // returns resource URL from the key, or the empty string if key is invalid.
@@ -133,9 +143,13 @@ class CONTENT_EXPORT GeneratedCodeCache {
                               base::Time time,
                               base::OnceClosure callback);
 
-  // Clears the in-memory cache.
+  // Clears the in-memory caches.
   void ClearInMemoryCache();
 
+  const DedupBodyCacheStats& dedup_body_cache_stats() const {
+    return dedup_body_cache_stats_;
+  }
+
   void CollectStatisticsForTest(const GURL& resource_url,
                                 const GURL& origin_lock,
                                 GeneratedCodeCache::CacheEntryStatus status);
@@ -213,6 +227,11 @@ class CONTENT_EXPORT GeneratedCodeCache {
   void CollectStatistics(const GURL& resource_url,
                          const GURL& origin_lock,
                          GeneratedCodeCache::CacheEntryStatus status);
+  // Records a lookup in |dedup_body_cache_| of a body of |data_size| bytes.
+  void CollectDedupBodyCacheStatistics(bool hit, uint32_t data_size);
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
 
   // Whether very large cache entries are deduplicated in this cache.
   // Deduplication is disabled in the WebUI code cache, as an additional defense
@@ -246,6 +265,16 @@ class CONTENT_EXPORT GeneratedCodeCache {
   SimpleLruCache lru_cache_;
   static constexpr int64_t kLruCacheCapacity = 50 * 1024 * 1024;
 
+  // Recently fetched or written deduplicated code bodies, keyed by their
+  // SHA-256 checksum key. Since the key is derived from the content, entries
+  // never go stale and can be shared by all origins and renderers using this
+  // cache. Only used when features::kInMemoryDeduplicatedCodeCache is enabled.
+  SimpleLruCache dedup_body_cache_;
+  static constexpr int64_t kDedupBodyCacheCapacity = 32 * 1024 * 1024;
+  DedupBodyCacheStats dedup_body_cache_stats_;
+
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
   base::WeakPtrFactory<GeneratedCodeCache> weak_ptr_factory_{this};
 };
 
@@ -15,6 +15,7 @@
 #include "base/containers/span.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/functional/bind.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/raw_ptr.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/test/metrics/histogram_tester.h"
@@ -628,6 +629,55 @@ TEST_P(GeneratedCodeCacheTest, StressVeryLargeEntries) {
   }
 }
 
+TEST_P(GeneratedCodeCacheTest, DedupBodyCacheServesVeryLargeEntries) {
+  base::test::ScopedFeatureList feature_list(
+      features::kInMemoryDeduplicatedCodeCache);
+  GURL url("http://example.com/script.js");
+  GURL origin_lock1("http://example1.com");
+  GURL origin_lock2("http://example2.com");
+  GURL origin_lock3("http://example3.com");
+  InitializeCache(GeneratedCodeCache::CodeCacheType::kJavaScript);
+
+  std::string large_data(kVeryLargeSizeInBytes, 'x');
+  WriteToCache(url, origin_lock1, large_data, base::Time());
+  WriteToCache(url, origin_lock2, large_data, base::Time());
+  WriteToCache(url, origin_lock3, large_data, base::Time());
+  task_environment_.RunUntilIdle();
+  generated_code_cache_->ClearInMemoryCache();
+
+  // The first fetch reads the body from disk and keeps it in memory.
+  FetchFromCache(url, origin_lock1);
+  task_environment_.RunUntilIdle();
+  ASSERT_TRUE(received_);
+  EXPECT_EQ(large_data, received_data_);
+  EXPECT_EQ(0u, generated_code_cache_->dedup_body_cache_stats().hits);
+  EXPECT_EQ(1u, generated_code_cache_->dedup_body_cache_stats().misses);
+
+  // A fetch from another origin sharing the same body is served from memory.
+  base::HistogramTester histogram_tester;
+  FetchFromCache(url, origin_lock2);
+  task_environment_.RunUntilIdle();
+  ASSERT_TRUE(received_);
+  EXPECT_EQ(large_data, received_data_);
+  EXPECT_EQ(1u, generated_code_cache_->dedup_body_cache_stats().hits);
+  EXPECT_EQ(kVeryLargeSizeInBytes,
+            generated_code_cache_->dedup_body_cache_stats().bytes_saved);
+  histogram_tester.ExpectUniqueSample(
+      "SiteIsolatedCodeCache.JS.DeduplicatedBodyMemoryCache.Hit", true, 1);
+
+  // Memory pressure drops the in-memory bodies, so the next fetch goes back
+  // to disk.
+  base::MemoryPressureListener::SimulatePressureNotification(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  task_environment_.RunUntilIdle();
+  FetchFromCache(url, origin_lock3);
+  task_environment_.RunUntilIdle();
+  ASSERT_TRUE(received_);
+  EXPECT_EQ(large_data, received_data_);
+  EXPECT_EQ(1u, generated_code_cache_->dedup_body_cache_stats().hits);
+  EXPECT_EQ(2u, generated_code_cache_->dedup_body_cache_stats().misses);
+}
+
 TEST_P(GeneratedCodeCacheTest, FetchSucceedsEmptyOriginLock) {
   GURL url("http://example.com/script.js");
   GURL origin_lock = GURL("");
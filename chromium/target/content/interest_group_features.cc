@@ -17,6 +17,14 @@ BASE_FEATURE(kDetectInconsistentPageImpl,
              "DetectInconsistentPageImpl",
              base::FEATURE_ENABLED_BY_DEFAULT);
 
+// When a buyer's interest groups don't fit in the space allotted to it in a
+// B&A request, serialize each group to CBOR only once and find the largest
+// prefix of groups that fits by compressing candidate prefixes, rather than
+// re-serializing groups against an estimated compression ratio.
+BASE_FEATURE(kEnableBandAExactRequestSizing,
+             "EnableBandAExactRequestSizing",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 // Enable parsing and using K-Anonymity features for B&A.
 BASE_FEATURE(kEnableBandAKAnonEnforcement,
              "EnableBandAKAnonEnforcement",
@@ -75,6 +83,25 @@ BASE_FEATURE(kFledgeFacilitatedTestingSignalsHeaders,
              "FledgeFacilitatedTestingSignalsHeaders",
              base::FEATURE_DISABLED_BY_DEFAULT);
 
+// Keeps up to `kFledgeWarmBidderWorkletPoolSize` bidder worklets of a frame
+// alive for `kFledgeWarmBidderWorkletTimeout` after the last auction using
+// them releases them, so a following auction in the same frame with the same
+// buyer scripts can reuse the already loaded worklet, its compiled scripts and
+// its recycled contexts instead of starting from scratch.
+BASE_FEATURE(kFledgeKeepBidderWorkletsWarm,
+             "FledgeKeepBidderWorkletsWarm",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+BASE_FEATURE_PARAM(int,
+                   kFledgeWarmBidderWorkletPoolSize,
+                   &kFledgeKeepBidderWorkletsWarm,
+                   "WarmBidderWorkletPoolSize",
+                   3);
+BASE_FEATURE_PARAM(base::TimeDelta,
+                   kFledgeWarmBidderWorkletTimeout,
+                   &kFledgeKeepBidderWorkletsWarm,
+                   "WarmBidderWorkletTimeout",
+                   base::Seconds(30));
+
 // Check if the owner of joinAdInterestGroup would be able to call
 // joinAdInterestGroup in its own subframe with allow=join-ad-interest-group.
 BASE_FEATURE(kFledgeModifyInterestGroupPolicyCheckOnOwner,
@@ -95,6 +122,13 @@ BASE_FEATURE_PARAM(
     "SelectableBuyerAndSellerReportingIdsFetchedFromKAnonLimit",
     -1);
 
+// When loading all interest groups of an owner, decode each distinct
+// compressed ads / ad components blob only once and copy the result into
+// every group that stores the same blob.
+BASE_FEATURE(kFledgeMemoizeAdVectorDecoding,
+             "FledgeMemoizeAdVectorDecoding",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 // Turning on kFledgeQueryKAnonymity loads k-anonymity status at interest group
 // join and update time. kFledgeQueryKAnonymity is enabled by default. It may
 // be reasonable to disable kFledgeQueryKAnonymity on clients on which
@@ -15,6 +15,7 @@ namespace features {
 // Please keep features in alphabetical order.
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kDetectInconsistentPageImpl);
 
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kEnableBandAExactRequestSizing);
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kEnableBandAKAnonEnforcement);
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kEnableBandAPrivateAggregation);
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kEnableBandASampleDebugReports);
@@ -29,6 +30,13 @@ CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeEnableUnNoisedRealTimeReport);
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeEnableUserAgentOverrides);
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeEnableWALForInterestGroupStorage);
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeFacilitatedTestingSignalsHeaders);
+
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeKeepBidderWorkletsWarm);
+CONTENT_EXPORT BASE_DECLARE_FEATURE_PARAM(int,
+                                          kFledgeWarmBidderWorkletPoolSize);
+CONTENT_EXPORT BASE_DECLARE_FEATURE_PARAM(base::TimeDelta,
+                                          kFledgeWarmBidderWorkletTimeout);
+
 CONTENT_EXPORT BASE_DECLARE_FEATURE(
     kFledgeModifyInterestGroupPolicyCheckOnOwner);
 
@@ -38,6 +46,8 @@ CONTENT_EXPORT BASE_DECLARE_FEATURE_PARAM(
     int,
     kFledgeSelectableBuyerAndSellerReportingIdsFetchedFromKAnonLimit);
 
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeMemoizeAdVectorDecoding);
+
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeQueryKAnonymity);
 
 CONTENT_EXPORT BASE_DECLARE_FEATURE(kFledgeStartAnticipatoryProcesses);
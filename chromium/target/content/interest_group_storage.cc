@@ -10,9 +10,11 @@
 #include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -3493,12 +3495,52 @@ std::optional<std::vector<std::string>> DoClearOriginJoinedInterestGroups(
   "last_k_anon_updated_time,"               \
   "kanon_keys"
 
+// Memoizes decoded ad vectors by their compressed blob for the lifetime of a
+// single multi-row load. Interest groups of the same owner frequently share
+// ad and ad component lists, so this avoids decompressing and re-parsing the
+// same proto for every row that stores it.
+class AdVectorDecodeCache {
+ public:
+  AdVectorDecodeCache() = default;
+  AdVectorDecodeCache(const AdVectorDecodeCache&) = delete;
+  AdVectorDecodeCache& operator=(const AdVectorDecodeCache&) = delete;
+  ~AdVectorDecodeCache() = default;
+
+  std::optional<std::vector<blink::InterestGroup::Ad>> Decode(
+      const PassKey& passkey,
+      std::string_view compressed) {
+    auto it = decoded_.find(compressed);
+    if (it != decoded_.end()) {
+      ++hits_;
+      return it->second;
+    }
+    std::optional<std::vector<blink::InterestGroup::Ad>> result =
+        DecompressAndDeserializeInterestGroupAdVectorProto(passkey,
+                                                           compressed);
+    decoded_.emplace(std::string(compressed), result);
+    return result;
+  }
+
+  size_t hits() const { return hits_; }
+
+ private:
+  std::map<std::string,
+           std::optional<std::vector<blink::InterestGroup::Ad>>,
+           std::less<>>
+      decoded_;
+  size_t hits_ = 0;
+};
+
 // Populate `group` with the current `load` outcome. Prerequisite:
 // `load` is an interest group query with the initial fields being
 // `COMMON_INTEREST_GROUPS_QUERY_FIELDS`, and there is a row of data returned.
-void PopulateInterestGroupFromQueryResult(sql::Statement& load,
-                                          const PassKey& passkey,
-                                          StorageInterestGroup& group) {
+// If `ad_decode_cache` is non-null, it is used to decode the ads and ad
+// components columns.
+void PopulateInterestGroupFromQueryResult(
+    sql::Statement& load,
+    const PassKey& passkey,
+    StorageInterestGroup& group,
+    AdVectorDecodeCache* ad_decode_cache = nullptr) {
   group.interest_group.expiry = load.ColumnTime(0);
   group.joining_origin = DeserializeOrigin(load.ColumnStringView(1));
 
@@ -3542,11 +3584,19 @@ void PopulateInterestGroupFromQueryResult(sql::Statement& load,
   if (load.GetColumnType(21) != sql::ColumnType::kNull) {
     group.interest_group.user_bidding_signals = load.ColumnString(21);
   }
-  group.interest_group.ads = DecompressAndDeserializeInterestGroupAdVectorProto(
-      passkey, load.ColumnStringView(22));
-  group.interest_group.ad_components =
-      DecompressAndDeserializeInterestGroupAdVectorProto(
-          passkey, load.ColumnStringView(23));
+  if (ad_decode_cache) {
+    group.interest_group.ads =
+        ad_decode_cache->Decode(passkey, load.ColumnStringView(22));
+    group.interest_group.ad_components =
+        ad_decode_cache->Decode(passkey, load.ColumnStringView(23));
+  } else {
+    group.interest_group.ads =
+        DecompressAndDeserializeInterestGroupAdVectorProto(
+            passkey, load.ColumnStringView(22));
+    group.interest_group.ad_components =
+        DecompressAndDeserializeInterestGroupAdVectorProto(
+            passkey, load.ColumnStringView(23));
+  }
   group.interest_group.ad_sizes =
       DeserializeStringSizeMap(load.ColumnStringView(24));
   group.interest_group.size_groups =
@@ -5364,6 +5414,12 @@ std::optional<std::vector<StorageInterestGroup>> DoGetInterestGroupsForOwner(
     load.BindString(0, Serialize(owner));
     load.BindTime(1, now);
 
+    std::optional<AdVectorDecodeCache> ad_decode_cache;
+    if (base::FeatureList::IsEnabled(
+            features::kFledgeMemoizeAdVectorDecoding)) {
+      ad_decode_cache.emplace();
+    }
+
     while (load.Step()) {
       std::string name = load.ColumnString(31);
       StorageInterestGroup& db_interest_group = interest_group_by_name[name];
@@ -5373,12 +5429,19 @@ std::optional<std::vector<StorageInterestGroup>> DoGetInterestGroupsForOwner(
       db_interest_group.interest_group.owner = owner;
       db_interest_group.interest_group.name = std::move(name);
 
-      PopulateInterestGroupFromQueryResult(load, passkey, db_interest_group);
+      PopulateInterestGroupFromQueryResult(
+          load, passkey, db_interest_group,
+          ad_decode_cache ? &*ad_decode_cache : nullptr);
     }
 
     if (!load.Succeeded()) {
       return std::nullopt;
     }
+    if (ad_decode_cache) {
+      base::UmaHistogramCounts10000(
+          "Storage.InterestGroup.AdVectorDecodeCacheHits",
+          ad_decode_cache->hits());
+    }
   }
   {
     TRACE_EVENT("fledge", "load_from_join_history_table");
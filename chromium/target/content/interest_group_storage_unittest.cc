@@ -3070,6 +3070,55 @@ TEST_F(InterestGroupStorageTest, ExpiredGroupsNotReturned) {
   EXPECT_EQ(0u, interest_groups.size());
 }
 
+// Interest groups of one owner that share ad and ad component lists should be
+// loaded identically when decoding of those lists is memoized, while distinct
+// lists must stay distinct.
+TEST_F(InterestGroupStorageTest, MemoizedAdVectorDecoding) {
+  base::test::ScopedFeatureList feature_list(
+      features::kFledgeMemoizeAdVectorDecoding);
+  base::HistogramTester histograms;
+  const url::Origin kOrigin = url::Origin::Create(GURL("https://owner.test"));
+  std::unique_ptr<InterestGroupStorage> storage = CreateStorage();
+
+  std::vector<blink::InterestGroup::Ad> shared_ads;
+  shared_ads.emplace_back(GURL("https://owner.test/ad1"), "metadata1");
+  shared_ads.emplace_back(GURL("https://owner.test/ad2"), "metadata2");
+  std::vector<blink::InterestGroup::Ad> shared_components;
+  shared_components.emplace_back(GURL("https://owner.test/component1"),
+                                 "component_metadata");
+
+  InterestGroup shared1 = NewInterestGroup(kOrigin, "shared1");
+  shared1.ads = shared_ads;
+  shared1.ad_components = shared_components;
+  InterestGroup shared2 = NewInterestGroup(kOrigin, "shared2");
+  shared2.ads = shared_ads;
+  shared2.ad_components = shared_components;
+  InterestGroup distinct = NewInterestGroup(kOrigin, "distinct");
+  distinct.ads.emplace();
+  distinct.ads->emplace_back(GURL("https://owner.test/ad3"), "metadata3");
+
+  storage->JoinInterestGroup(shared1, kOrigin.GetURL());
+  storage->JoinInterestGroup(shared2, kOrigin.GetURL());
+  storage->JoinInterestGroup(distinct, kOrigin.GetURL());
+
+  std::vector<StorageInterestGroup> interest_groups =
+      storage->GetInterestGroupsForOwner(kOrigin);
+  ASSERT_EQ(3u, interest_groups.size());
+  for (const StorageInterestGroup& group : interest_groups) {
+    if (group.interest_group.name == "shared1") {
+      IgExpectEqualsForTesting(shared1, group.interest_group);
+    } else if (group.interest_group.name == "shared2") {
+      IgExpectEqualsForTesting(shared2, group.interest_group);
+    } else {
+      IgExpectEqualsForTesting(distinct, group.interest_group);
+    }
+  }
+
+  // The shared ads and shared ad components are each decoded only once.
+  histograms.ExpectUniqueSample("Storage.InterestGroup.AdVectorDecodeCacheHits",
+                                2, 1);
+}
+
 TEST_F(InterestGroupStorageTest, DBMaintenanceExpiresOldInterestGroups) {
   base::HistogramTester histograms;
 
@@ -80,6 +80,14 @@ BASE_FEATURE(kEnumerateDevicesRelaxedCache,
 #endif
 );
 
+BASE_FEATURE(kEnumerateDevicesCapabilityCache,
+             "EnumerateDevicesCapabilityCache",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+BASE_FEATURE(kEnumerateDevicesPipelinedPermissionCheck,
+             "EnumerateDevicesPipelinedPermissionCheck",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
 namespace {
 using media::mojom::DeviceEnumerationResult;
 
@@ -218,6 +226,40 @@ BrowserContext* GetBrowserContextOnUIThread(
   return rfh->GetBrowserContext();
 }
 
+// The video-capture subsystem currently does not support group IDs.
+// If video input devices are requested, also request audio input devices in
+// order to be able to use an heuristic that guesses group IDs for video
+// devices by finding matches in audio input devices.
+// TODO(crbug.com/41263713): Remove this and use `requested_types` directly
+// when video capture supports group IDs.
+MediaDevicesManager::BoolDeviceTypes GetInternalRequestedTypes(
+    const MediaDevicesManager::BoolDeviceTypes& requested_types) {
+  MediaDevicesManager::BoolDeviceTypes internal_requested_types;
+  internal_requested_types[static_cast<size_t>(
+      MediaDeviceType::kMediaAudioInput)] =
+      requested_types[static_cast<size_t>(MediaDeviceType::kMediaAudioInput)] ||
+      requested_types[static_cast<size_t>(MediaDeviceType::kMediaVideoInput)];
+  internal_requested_types[static_cast<size_t>(
+      MediaDeviceType::kMediaVideoInput)] =
+      requested_types[static_cast<size_t>(MediaDeviceType::kMediaVideoInput)];
+  internal_requested_types[static_cast<size_t>(
+      MediaDeviceType::kMediaAudioOutput)] =
+      requested_types[static_cast<size_t>(MediaDeviceType::kMediaAudioOutput)];
+  return internal_requested_types;
+}
+
+void ReportEnumerationLatencyAndRun(
+    base::TimeTicks start_time,
+    MediaDevicesManager::EnumerateDevicesCallback callback,
+    const std::vector<blink::WebMediaDeviceInfoArray>& devices,
+    std::vector<VideoInputDeviceCapabilitiesPtr> video_capabilities,
+    std::vector<AudioInputDeviceCapabilitiesPtr> audio_capabilities) {
+  base::UmaHistogramTimes("Media.MediaDevicesManager.EnumerateDevicesLatency",
+                          base::TimeTicks::Now() - start_time);
+  std::move(callback).Run(devices, std::move(video_capabilities),
+                          std::move(audio_capabilities));
+}
+
 // Sort the devices according to user pref. If the pref is unset or
 // the render frame host doesn't have a `BrowserContext` the ordering will be
 // unmodified.
@@ -649,6 +691,37 @@ void MediaDevicesManager::EnumerateAndRankDevices(
       base::ToString(request_audio_input_capabilities),
       base::ToString(request_video_input_capabilities)));
 
+  callback = base::BindOnce(&ReportEnumerationLatencyAndRun,
+                            base::TimeTicks::Now(), std::move(callback));
+
+  if (base::FeatureList::IsEnabled(
+          kEnumerateDevicesPipelinedPermissionCheck)) {
+    // The device enumeration doesn't depend on the salt or the permissions, so
+    // start it right away rather than after checking those on the UI thread.
+    const uint32_t id = next_pipelined_enumeration_id_++;
+    PipelinedEnumeration& pipelined_enumeration = pipelined_enumerations_[id];
+    pipelined_enumeration.render_frame_host_id = render_frame_host_id;
+    pipelined_enumeration.requested_types = requested_types;
+    pipelined_enumeration.request_video_input_capabilities =
+        request_video_input_capabilities;
+    pipelined_enumeration.request_audio_input_capabilities =
+        request_audio_input_capabilities;
+    pipelined_enumeration.callback = std::move(callback);
+
+    GetUIThreadTaskRunner({})->PostTask(
+        FROM_HERE,
+        base::BindOnce(
+            get_salt_and_origin_cb_, render_frame_host_id,
+            base::BindPostTaskToCurrentDefault(
+                base::BindOnce(&MediaDevicesManager::OnPipelinedSaltAndOrigin,
+                               weak_factory_.GetWeakPtr(), id))));
+    EnumerateAndRankDevices(
+        render_frame_host_id, GetInternalRequestedTypes(requested_types),
+        base::BindOnce(&MediaDevicesManager::OnPipelinedDevicesEnumerated,
+                       weak_factory_.GetWeakPtr(), id));
+    return;
+  }
+
   GetUIThreadTaskRunner({})->PostTask(
       FROM_HERE,
       base::BindOnce(
@@ -770,6 +843,7 @@ void MediaDevicesManager::SetCachePolicy(MediaDeviceType type,
     return;
 
   cache_policies_[static_cast<size_t>(type)] = policy;
+  ClearCapabilityCache(type);
   // If the new policy is SYSTEM_MONITOR, issue an enumeration to populate the
   // cache.
   if (policy == CachePolicy::SYSTEM_MONITOR) {
@@ -939,6 +1013,7 @@ media::VideoCaptureFormats MediaDevicesManager::GetVideoInputFormats(
   }
 
   video_capture_manager_->GetDeviceSupportedFormats(device_id, &formats);
+  ++num_supported_formats_lookups_for_testing_;
   ReplaceInvalidFrameRatesWithFallback(&formats);
   // Remove formats that have zero resolution.
   std::erase_if(formats, [](const media::VideoCaptureFormat& format) {
@@ -1007,26 +1082,8 @@ void MediaDevicesManager::OnPermissionsCheckDone(
     const MediaDeviceSaltAndOrigin& salt_and_origin,
     const MediaDevicesManager::BoolDeviceTypes& has_permissions) {
   DCHECK_CURRENTLY_ON(BrowserThread::IO);
-  // The video-capture subsystem currently does not support group IDs.
-  // If video input devices are requested, also request audio input devices in
-  // order to be able to use an heuristic that guesses group IDs for video
-  // devices by finding matches in audio input devices.
-  // TODO(crbug.com/41263713): Remove |internal_requested_types| and use
-  // |requested_types| directly when video capture supports group IDs.
-  BoolDeviceTypes internal_requested_types;
-  internal_requested_types[static_cast<size_t>(
-      MediaDeviceType::kMediaAudioInput)] =
-      requested_types[static_cast<size_t>(MediaDeviceType::kMediaAudioInput)] ||
-      requested_types[static_cast<size_t>(MediaDeviceType::kMediaVideoInput)];
-  internal_requested_types[static_cast<size_t>(
-      MediaDeviceType::kMediaVideoInput)] =
-      requested_types[static_cast<size_t>(MediaDeviceType::kMediaVideoInput)];
-  internal_requested_types[static_cast<size_t>(
-      MediaDeviceType::kMediaAudioOutput)] =
-      requested_types[static_cast<size_t>(MediaDeviceType::kMediaAudioOutput)];
-
   EnumerateAndRankDevices(
-      render_frame_host_id, internal_requested_types,
+      render_frame_host_id, GetInternalRequestedTypes(requested_types),
       base::BindOnce(&MediaDevicesManager::OnDevicesEnumerated,
                      weak_factory_.GetWeakPtr(), render_frame_host_id,
                      requested_types, request_video_input_capabilities,
@@ -1151,6 +1208,19 @@ void MediaDevicesManager::GetAudioInputCapabilities(
         std::move(capabilities));
     size_t capabilities_index =
         enumeration_states_[state_id].audio_capabilities.size() - 1;
+    if (IsCapabilityCacheEnabled(MediaDeviceType::kMediaAudioInput)) {
+      auto it = audio_input_parameters_cache_.find(raw_device_info.device_id);
+      if (it != audio_input_parameters_cache_.end()) {
+        // Post rather than complete synchronously, since completing may
+        // finalize and erase the state while this loop still uses it.
+        GetIOThreadTaskRunner({})->PostTask(
+            FROM_HERE,
+            base::BindOnce(&MediaDevicesManager::GotAudioInputCapabilities,
+                           weak_factory_.GetWeakPtr(), state_id,
+                           capabilities_index, it->second));
+        continue;
+      }
+    }
     if (use_fake_devices_) {
       GetIOThreadTaskRunner({})->PostTask(
           FROM_HERE,
@@ -1161,9 +1231,11 @@ void MediaDevicesManager::GetAudioInputCapabilities(
     } else {
       audio_system_->GetInputStreamParameters(
           raw_device_info.device_id,
-          base::BindOnce(&MediaDevicesManager::GotAudioInputCapabilities,
-                         weak_factory_.GetWeakPtr(), state_id,
-                         capabilities_index));
+          base::BindOnce(
+              &MediaDevicesManager::GotAudioInputCapabilitiesForDevice,
+              weak_factory_.GetWeakPtr(), raw_device_info.device_id,
+              audio_input_capability_cache_generation_, state_id,
+              capabilities_index));
     }
   }
 }
@@ -1200,6 +1272,21 @@ void MediaDevicesManager::GotAudioInputCapabilities(
   }
 }
 
+void MediaDevicesManager::GotAudioInputCapabilitiesForDevice(
+    const std::string& raw_device_id,
+    uint64_t capability_cache_generation,
+    size_t state_id,
+    size_t capabilities_index,
+    const std::optional<media::AudioParameters>& parameters) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (parameters &&
+      IsCapabilityCacheEnabled(MediaDeviceType::kMediaAudioInput) &&
+      capability_cache_generation == audio_input_capability_cache_generation_) {
+    audio_input_parameters_cache_[raw_device_id] = *parameters;
+  }
+  GotAudioInputCapabilities(state_id, capabilities_index, parameters);
+}
+
 void MediaDevicesManager::FinalizeDevicesEnumerated(
     EnumerationState enumeration_state) {
   std::move(enumeration_state.completion_cb)
@@ -1226,8 +1313,8 @@ MediaDevicesManager::ComputeVideoInputCapabilities(
     VideoInputDeviceCapabilitiesPtr capabilities =
         blink::mojom::VideoInputDeviceCapabilities::New();
     capabilities->device_id = translated_device_infos[i].device_id;
-    capabilities->formats = GetVideoInputFormats(raw_device_infos[i].device_id,
-                                                 false /* try_in_use_first */);
+    capabilities->formats =
+        GetCachedVideoInputFormats(raw_device_infos[i].device_id);
     capabilities->facing_mode = translated_device_infos[i].video_facing;
     if (translated_device_infos[i].availability) {
       capabilities->availability =
@@ -1391,6 +1478,7 @@ void MediaDevicesManager::UpdateSnapshot(
          is_video_with_good_group_ids);
     current_snapshot_[static_cast<size_t>(type)] = new_snapshot;
     current_snapshot_changed = true;
+    ClearCapabilityCache(type);
   }
 
   if (IsRelaxedCacheFeatureEnabled() && !use_group_id) {
@@ -1487,6 +1575,7 @@ void MediaDevicesManager::HandleDevicesChanged(MediaDeviceType type) {
                                       DeviceTypeToString(type)));
   }
   cache_infos_[static_cast<size_t>(type)].InvalidateCache();
+  ClearCapabilityCache(type);
   if (!IsRelaxedCacheFeatureEnabled() ||
       cache_infos_[static_cast<size_t>(type)].NeedsUpdateUponInvalidation()) {
     DoEnumerateDevices(type);
@@ -1702,6 +1791,110 @@ void MediaDevicesManager::UpdateVideoCaptureHostsEmptyState(bool empty) {
 }
 #endif
 
+void MediaDevicesManager::OnPipelinedSaltAndOrigin(
+    uint32_t pipelined_enumeration_id,
+    const MediaDeviceSaltAndOrigin& salt_and_origin) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  auto it = pipelined_enumerations_.find(pipelined_enumeration_id);
+  CHECK(it != pipelined_enumerations_.end());
+  it->second.salt_and_origin = salt_and_origin;
+  permission_checker_->CheckPermissions(
+      it->second.requested_types, it->second.render_frame_host_id.child_id,
+      it->second.render_frame_host_id.frame_routing_id,
+      base::BindOnce(&MediaDevicesManager::OnPipelinedPermissionsChecked,
+                     weak_factory_.GetWeakPtr(), pipelined_enumeration_id));
+}
+
+void MediaDevicesManager::OnPipelinedPermissionsChecked(
+    uint32_t pipelined_enumeration_id,
+    const BoolDeviceTypes& has_permissions) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  auto it = pipelined_enumerations_.find(pipelined_enumeration_id);
+  CHECK(it != pipelined_enumerations_.end());
+  it->second.has_permissions = has_permissions;
+  MaybeFinishPipelinedEnumeration(pipelined_enumeration_id);
+}
+
+void MediaDevicesManager::OnPipelinedDevicesEnumerated(
+    uint32_t pipelined_enumeration_id,
+    const MediaDeviceEnumeration& enumeration) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  auto it = pipelined_enumerations_.find(pipelined_enumeration_id);
+  CHECK(it != pipelined_enumerations_.end());
+  it->second.enumeration = enumeration;
+  MaybeFinishPipelinedEnumeration(pipelined_enumeration_id);
+}
+
+void MediaDevicesManager::MaybeFinishPipelinedEnumeration(
+    uint32_t pipelined_enumeration_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  auto it = pipelined_enumerations_.find(pipelined_enumeration_id);
+  CHECK(it != pipelined_enumerations_.end());
+  if (!it->second.has_permissions || !it->second.enumeration) {
+    return;
+  }
+  // `has_permissions` is only set after `salt_and_origin`.
+  DCHECK(it->second.salt_and_origin);
+
+  PipelinedEnumeration pipelined_enumeration = std::move(it->second);
+  pipelined_enumerations_.erase(it);
+  OnDevicesEnumerated(pipelined_enumeration.render_frame_host_id,
+                      pipelined_enumeration.requested_types,
+                      pipelined_enumeration.request_video_input_capabilities,
+                      pipelined_enumeration.request_audio_input_capabilities,
+                      std::move(pipelined_enumeration.callback),
+                      *pipelined_enumeration.salt_and_origin,
+                      *pipelined_enumeration.has_permissions,
+                      *pipelined_enumeration.enumeration);
+}
+
+bool MediaDevicesManager::IsCapabilityCacheEnabled(MediaDeviceType type) const {
+  // Capabilities can only be cached while device-change monitoring keeps the
+  // device list, and hence the set of devices to invalidate, up to date.
+  return base::FeatureList::IsEnabled(kEnumerateDevicesCapabilityCache) &&
+         cache_policies_[static_cast<size_t>(type)] ==
+             CachePolicy::SYSTEM_MONITOR;
+}
+
+void MediaDevicesManager::ClearCapabilityCache(MediaDeviceType type) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  switch (type) {
+    case MediaDeviceType::kMediaAudioInput:
+      audio_input_parameters_cache_.clear();
+      ++audio_input_capability_cache_generation_;
+      break;
+    case MediaDeviceType::kMediaVideoInput:
+      video_input_formats_cache_.clear();
+      break;
+    default:
+      break;
+  }
+}
+
+media::VideoCaptureFormats MediaDevicesManager::GetCachedVideoInputFormats(
+    const std::string& device_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (!IsCapabilityCacheEnabled(MediaDeviceType::kMediaVideoInput)) {
+    return GetVideoInputFormats(device_id, /*try_in_use_first=*/false);
+  }
+  auto it = video_input_formats_cache_.find(device_id);
+  if (it == video_input_formats_cache_.end()) {
+    it = video_input_formats_cache_
+             .emplace(device_id, GetVideoInputFormats(
+                                     device_id, /*try_in_use_first=*/false))
+             .first;
+  }
+  return it->second;
+}
+
+MediaDevicesManager::PipelinedEnumeration::PipelinedEnumeration() = default;
+MediaDevicesManager::PipelinedEnumeration::PipelinedEnumeration(
+    PipelinedEnumeration&& other) = default;
+MediaDevicesManager::PipelinedEnumeration::~PipelinedEnumeration() = default;
+MediaDevicesManager::PipelinedEnumeration&
+MediaDevicesManager::PipelinedEnumeration::operator=(
+    PipelinedEnumeration&& other) = default;
+
 MediaDevicesManager::EnumerationState::EnumerationState() = default;
 MediaDevicesManager::EnumerationState::EnumerationState(
     EnumerationState&& other) = default;
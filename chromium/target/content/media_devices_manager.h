@@ -8,6 +8,7 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -18,12 +19,14 @@
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/system/system_monitor.h"
+#include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "base/types/strong_alias.h"
 #include "build/build_config.h"
 #include "content/browser/media/media_devices_util.h"
 #include "content/common/content_export.h"
 #include "media/audio/audio_device_description.h"
+#include "media/base/audio_parameters.h"
 #include "media/capture/video/video_capture_device_descriptor.h"
 #include "media/capture/video_capture_types.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
@@ -57,6 +60,15 @@ using MediaDeviceEnumeration =
 BASE_DECLARE_FEATURE(kReleaseVideoSourceProviderIfNotInUse);
 #endif
 
+// Caches audio input parameters and video input formats per device for device
+// types whose device list is kept up to date by device-change monitoring.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kEnumerateDevicesCapabilityCache);
+
+// Starts the low-level device enumeration for EnumerateAndRankDevices() in
+// parallel with the device ID salt and permission checks instead of after
+// them.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kEnumerateDevicesPipelinedPermissionCheck);
+
 // MediaDevicesManager is responsible for doing media-device enumerations.
 // In addition it implements caching for enumeration results and device
 // monitoring in order to keep caches consistent.
@@ -332,6 +344,26 @@ class CONTENT_EXPORT MediaDevicesManager
     std::vector<blink::WebMediaDeviceInfoArray> hashed_enumeration_results;
   };
 
+  // State of an EnumerateAndRankDevices() request with
+  // kEnumerateDevicesPipelinedPermissionCheck, while waiting for the salt and
+  // permission checks and the device enumeration to all complete.
+  struct PipelinedEnumeration {
+    PipelinedEnumeration();
+    PipelinedEnumeration(PipelinedEnumeration&& other);
+    ~PipelinedEnumeration();
+
+    PipelinedEnumeration& operator=(PipelinedEnumeration&& other);
+
+    GlobalRenderFrameHostId render_frame_host_id;
+    BoolDeviceTypes requested_types;
+    bool request_video_input_capabilities = false;
+    bool request_audio_input_capabilities = false;
+    EnumerateDevicesCallback callback;
+    std::optional<MediaDeviceSaltAndOrigin> salt_and_origin;
+    std::optional<BoolDeviceTypes> has_permissions;
+    std::optional<MediaDeviceEnumeration> enumeration;
+  };
+
   // Manually sets a caching policy for a given device type.
   void SetCachePolicy(MediaDeviceType type, CachePolicy policy);
 
@@ -370,8 +402,32 @@ class CONTENT_EXPORT MediaDevicesManager
       size_t state_index,
       size_t capabilities_index,
       const std::optional<media::AudioParameters>& parameters);
+  void GotAudioInputCapabilitiesForDevice(
+      const std::string& raw_device_id,
+      uint64_t capability_cache_generation,
+      size_t state_index,
+      size_t capabilities_index,
+      const std::optional<media::AudioParameters>& parameters);
   void FinalizeDevicesEnumerated(EnumerationState enumeration_state);
 
+  // Helpers for kEnumerateDevicesPipelinedPermissionCheck.
+  void OnPipelinedSaltAndOrigin(
+      uint32_t pipelined_enumeration_id,
+      const MediaDeviceSaltAndOrigin& salt_and_origin);
+  void OnPipelinedPermissionsChecked(
+      uint32_t pipelined_enumeration_id,
+      const BoolDeviceTypes& has_permissions);
+  void OnPipelinedDevicesEnumerated(uint32_t pipelined_enumeration_id,
+                                    const MediaDeviceEnumeration& enumeration);
+  void MaybeFinishPipelinedEnumeration(uint32_t pipelined_enumeration_id);
+
+  // Returns true if capabilities of devices of `type` may be served from the
+  // capability caches below.
+  bool IsCapabilityCacheEnabled(MediaDeviceType type) const;
+  void ClearCapabilityCache(MediaDeviceType type);
+  media::VideoCaptureFormats GetCachedVideoInputFormats(
+      const std::string& device_id);
+
   std::vector<VideoInputDeviceCapabilitiesPtr> ComputeVideoInputCapabilities(
       const blink::WebMediaDeviceInfoArray& raw_device_infos,
       const blink::WebMediaDeviceInfoArray& translated_device_infos);
@@ -494,6 +550,22 @@ class CONTENT_EXPORT MediaDevicesManager
   std::map<uint32_t, EnumerationState> enumeration_states_;
   uint32_t next_enumeration_state_id_ = 0;
 
+  std::map<uint32_t, PipelinedEnumeration> pipelined_enumerations_;
+  uint32_t next_pipelined_enumeration_id_ = 0;
+
+  // Capabilities per raw device ID, used with kEnumerateDevicesCapabilityCache.
+  // Cleared whenever the device list of the corresponding type is invalidated
+  // or its cache policy changes. Audio parameters arrive asynchronously, so
+  // `audio_input_capability_cache_generation_` is used to drop those requested
+  // before the last invalidation.
+  base::flat_map<std::string, media::AudioParameters>
+      audio_input_parameters_cache_;
+  uint64_t audio_input_capability_cache_generation_ = 0;
+  base::flat_map<std::string, media::VideoCaptureFormats>
+      video_input_formats_cache_;
+  // Number of GetDeviceSupportedFormats() calls on `video_capture_manager_`.
+  size_t num_supported_formats_lookups_for_testing_ = 0;
+
   mojo::UniqueReceiverSet<blink::mojom::MediaDevicesDispatcherHost>
       dispatcher_hosts_;
 
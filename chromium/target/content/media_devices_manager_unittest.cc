@@ -116,6 +116,7 @@ class MockAudioManager : public media::FakeAudioManager {
 
   MOCK_METHOD1(MockGetAudioInputDeviceNames, void(media::AudioDeviceNames*));
   MOCK_METHOD1(MockGetAudioOutputDeviceNames, void(media::AudioDeviceNames*));
+  MOCK_METHOD1(MockGetInputStreamParameters, void(const std::string&));
 
   std::string GetDefaultInputDeviceID() override { return default_device_id_; }
 
@@ -167,6 +168,12 @@ class MockAudioManager : public media::FakeAudioManager {
     MockGetAudioOutputDeviceNames(device_names);
   }
 
+  media::AudioParameters GetInputStreamParameters(
+      const std::string& device_id) override {
+    MockGetInputStreamParameters(device_id);
+    return media::FakeAudioManager::GetInputStreamParameters(device_id);
+  }
+
   media::AudioParameters GetOutputStreamParameters(
       const std::string& device_id) override {
     return media::AudioParameters(media::AudioParameters::AUDIO_PCM_LOW_LATENCY,
@@ -501,6 +508,22 @@ class MediaDevicesManagerTest : public ::testing::Test {
     return media_devices_manager_->audio_device_origin_map_;
   }
 
+  size_t GetAudioInputParametersCacheSize() {
+    return media_devices_manager_->audio_input_parameters_cache_.size();
+  }
+
+  size_t GetVideoInputFormatsCacheSize() {
+    return media_devices_manager_->video_input_formats_cache_.size();
+  }
+
+  size_t GetNumSupportedFormatsLookups() {
+    return media_devices_manager_->num_supported_formats_lookups_for_testing_;
+  }
+
+  size_t GetNumPipelinedEnumerations() {
+    return media_devices_manager_->pipelined_enumerations_.size();
+  }
+
 #if BUILDFLAG(IS_MAC) || BUILDFLAG(IS_WIN)
   void InitVideoCaptureDevicesChangedObserver() {
     media_devices_manager_->video_capture_service_device_changed_observer_ =
@@ -1258,6 +1281,113 @@ TEST_F(MediaDevicesManagerTest, EnumerateDevicesWithCapabilities) {
   run_loop.Run();
 }
 
+TEST_F(MediaDevicesManagerTest, EnumerateDevicesWithCachedCapabilities) {
+  base::test::ScopedFeatureList feature_list(kEnumerateDevicesCapabilityCache);
+  EXPECT_CALL(*audio_manager_, MockGetAudioInputDeviceNames(_))
+      .Times(AtLeast(1));
+  EXPECT_CALL(media_devices_manager_client_,
+              InputDevicesChangedUI(MediaDeviceType::kMediaAudioInput, _));
+  EXPECT_CALL(*video_capture_device_factory_, MockGetDevicesInfo())
+      .Times(AtLeast(1));
+  EXPECT_CALL(media_devices_manager_client_,
+              InputDevicesChangedUI(MediaDeviceType::kMediaVideoInput, _));
+  media::FakeVideoCaptureDeviceSettings fake_device;
+  fake_device.device_id = "fake_id_1";
+  fake_device.delivery_mode =
+      media::FakeVideoCaptureDevice::DeliveryMode::USE_DEVICE_INTERNAL_BUFFERS;
+  fake_device.supported_formats = {
+      {{1000, 1000}, 60.0, media::PIXEL_FORMAT_I420}};
+  std::vector<media::FakeVideoCaptureDeviceSettings>
+      fake_capture_device_settings = {fake_device};
+  video_capture_device_factory_->SetToCustomDevicesConfig(
+      fake_capture_device_settings);
+  EnableCache(MediaDeviceType::kMediaAudioInput);
+  EnableCache(MediaDeviceType::kMediaVideoInput);
+
+  MediaDevicesManager::BoolDeviceTypes devices_to_enumerate;
+  devices_to_enumerate[static_cast<size_t>(MediaDeviceType::kMediaVideoInput)] =
+      true;
+  devices_to_enumerate[static_cast<size_t>(MediaDeviceType::kMediaAudioInput)] =
+      true;
+
+  InitializeRenderFrameHost();
+
+  // The second enumeration is served from the capability caches populated by
+  // the first one and must report the same capabilities, without querying the
+  // audio or video capture systems again.
+  for (int i = 0; i < 2; ++i) {
+    const size_t num_supported_formats_lookups =
+        GetNumSupportedFormatsLookups();
+    EXPECT_CALL(*audio_manager_, MockGetInputStreamParameters(_))
+        .Times(i == 0 ? kNumAudioInputDevices : 0);
+    base::RunLoop run_loop;
+    media_devices_manager_->EnumerateAndRankDevices(
+        {-1, -1}, devices_to_enumerate, true, true,
+        base::BindOnce(
+            &MediaDevicesManagerTest::EnumerateWithCapabilitiesCallback,
+            base::Unretained(this), fake_capture_device_settings, &run_loop));
+    EXPECT_EQ(GetNumPipelinedEnumerations(), 0u);
+    run_loop.Run();
+    EXPECT_EQ(GetAudioInputParametersCacheSize(), kNumAudioInputDevices);
+    EXPECT_EQ(GetVideoInputFormatsCacheSize(), 1u);
+    EXPECT_EQ(GetNumSupportedFormatsLookups() - num_supported_formats_lookups,
+              i == 0 ? 1u : 0u);
+  }
+
+  // Device changes invalidate the cached capabilities of the changed type.
+  FireDevicesChanged(base::SystemMonitor::DEVTYPE_AUDIO);
+  EXPECT_EQ(GetAudioInputParametersCacheSize(), 0u);
+  EXPECT_EQ(GetVideoInputFormatsCacheSize(), 1u);
+  FireDevicesChanged(base::SystemMonitor::DEVTYPE_VIDEO_CAPTURE);
+  EXPECT_EQ(GetVideoInputFormatsCacheSize(), 0u);
+}
+
+TEST_F(MediaDevicesManagerTest, EnumerateDevicesWithPipelinedPermissionCheck) {
+  base::test::ScopedFeatureList feature_list(
+      kEnumerateDevicesPipelinedPermissionCheck);
+  EXPECT_CALL(*audio_manager_, MockGetAudioInputDeviceNames(_));
+  EXPECT_CALL(media_devices_manager_client_,
+              InputDevicesChangedUI(MediaDeviceType::kMediaAudioInput, _));
+  EXPECT_CALL(*video_capture_device_factory_, MockGetDevicesInfo());
+  EXPECT_CALL(media_devices_manager_client_,
+              InputDevicesChangedUI(MediaDeviceType::kMediaVideoInput, _));
+  media::FakeVideoCaptureDeviceSettings fake_device;
+  fake_device.device_id = "fake_id_1";
+  fake_device.delivery_mode =
+      media::FakeVideoCaptureDevice::DeliveryMode::USE_DEVICE_INTERNAL_BUFFERS;
+  fake_device.supported_formats = {
+      {{1000, 1000}, 60.0, media::PIXEL_FORMAT_I420}};
+  std::vector<media::FakeVideoCaptureDeviceSettings>
+      fake_capture_device_settings = {fake_device};
+  video_capture_device_factory_->SetToCustomDevicesConfig(
+      fake_capture_device_settings);
+
+  MediaDevicesManager::BoolDeviceTypes devices_to_enumerate;
+  devices_to_enumerate[static_cast<size_t>(MediaDeviceType::kMediaVideoInput)] =
+      true;
+  devices_to_enumerate[static_cast<size_t>(MediaDeviceType::kMediaAudioInput)] =
+      true;
+
+  InitializeRenderFrameHost();
+
+  // The enumeration is started before the salt and permissions are known, and
+  // the request stays pending until both have arrived.
+  base::RunLoop run_loop;
+  media_devices_manager_->EnumerateAndRankDevices(
+      {-1, -1}, devices_to_enumerate, true, true,
+      base::BindOnce(
+          &MediaDevicesManagerTest::EnumerateWithCapabilitiesCallback,
+          base::Unretained(this), fake_capture_device_settings, &run_loop));
+  EXPECT_EQ(GetNumPipelinedEnumerations(), 1u);
+  run_loop.Run();
+  EXPECT_EQ(GetNumPipelinedEnumerations(), 0u);
+  // Without kEnumerateDevicesCapabilityCache nothing is cached.
+  EXPECT_EQ(GetAudioInputParametersCacheSize(), 0u);
+  EXPECT_EQ(GetVideoInputFormatsCacheSize(), 0u);
+  histogram_tester_.ExpectTotalCount(
+      "Media.MediaDevicesManager.EnumerateDevicesLatency", 1);
+}
+
 TEST_F(MediaDevicesManagerTest, EnumerateDevicesUnplugDefaultDevice) {
   // This tests does not apply to CrOS, which is to seamlessly switch device.
 #if !BUILDFLAG(IS_CHROMEOS)
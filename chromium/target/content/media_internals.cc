@@ -6,7 +6,9 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <array>
+#include <limits>
 #include <list>
 #include <string>
 #include <string_view>
@@ -126,6 +128,11 @@ std::string FormatToString(media::AudioParameters::Format format) {
 const char kAudioLogStatusKey[] = "status";
 const char kAudioLogUpdateFunction[] = "media.updateAudioComponent";
 
+// Number of saved events which SendHistoricalMediaEvents() converts and sends
+// per task, so that opening chrome://media-internals next to many players does
+// not block the UI thread.
+constexpr size_t kHistoricalMediaEventsPerTask = 100;
+
 }  // namespace
 
 // This class works as a receiver of logs of events occurring in the
@@ -357,6 +364,15 @@ MediaInternals* MediaInternals::GetInstance() {
   return internals;
 }
 
+MediaInternals::SavedPlayerEvents::SavedPlayerEvents() = default;
+MediaInternals::SavedPlayerEvents::~SavedPlayerEvents() = default;
+
+MediaInternals::SavedProcessEvents::SavedProcessEvents() = default;
+MediaInternals::SavedProcessEvents::~SavedProcessEvents() = default;
+
+MediaInternals::HistoricalEventsReplay::HistoricalEventsReplay() = default;
+MediaInternals::HistoricalEventsReplay::~HistoricalEventsReplay() = default;
+
 MediaInternals::MediaInternals() = default;
 
 MediaInternals::~MediaInternals() {}
@@ -432,6 +448,10 @@ void MediaInternals::OnMediaEvents(
     int render_process_id,
     const std::vector<media::MediaLogRecord>& events) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  // Finish replaying older events first so that the UI sees events in order.
+  if (historical_events_replay_) {
+    ContinueHistoricalMediaEventsReplay(std::numeric_limits<size_t>::max());
+  }
   // Notify observers that |event| has occurred.
   for (const auto& event : events) {
     if (CanUpdate()) {
@@ -461,6 +481,10 @@ void MediaInternals::RemoveUpdateCallback(const UpdateCallback& callback) {
     }
   }
 
+  if (update_callbacks_.empty()) {
+    historical_events_replay_.reset();
+  }
+
   base::AutoLock auto_lock(lock_);
   can_update_ = !update_callbacks_.empty();
   audio_focus_helper_.SetEnabled(can_update_);
@@ -473,15 +497,82 @@ bool MediaInternals::CanUpdate() {
 
 void MediaInternals::SendHistoricalMediaEvents() {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
-  for (const auto& saved_events : saved_events_by_process_) {
-    for (const auto& event : saved_events.second) {
+  // Events are converted lazily, from the saved records, as the replay
+  // progresses. Events saved after this point are sent as they arrive.
+  HistoricalEventsReplay& replay = historical_events_replay_.emplace();
+  replay.end_sequence_number = next_saved_event_sequence_number_;
+  for (const auto& [process_id, saved_events] : saved_events_by_process_) {
+    for (const SavedPlayerEvents& player : saved_events.players) {
+      replay.players.emplace_back(process_id, player.player_id);
+    }
+  }
+  // Do not clear the saved events here so that refreshing the UI or opening a
+  // second UI still works nicely!
+
+  if (!historical_events_replay_task_posted_) {
+    historical_events_replay_task_posted_ = true;
+    GetUIThreadTaskRunner({})->PostTask(
+        FROM_HERE,
+        base::BindOnce(&MediaInternals::SendNextHistoricalMediaEvents,
+                       base::Unretained(this)));
+  }
+}
+
+void MediaInternals::SendNextHistoricalMediaEvents() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  historical_events_replay_task_posted_ = false;
+  if (!historical_events_replay_) {
+    return;
+  }
+  ContinueHistoricalMediaEventsReplay(kHistoricalMediaEventsPerTask);
+  if (historical_events_replay_) {
+    historical_events_replay_task_posted_ = true;
+    GetUIThreadTaskRunner({})->PostTask(
+        FROM_HERE,
+        base::BindOnce(&MediaInternals::SendNextHistoricalMediaEvents,
+                       base::Unretained(this)));
+  }
+}
+
+void MediaInternals::ContinueHistoricalMediaEventsReplay(size_t max_events) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  DCHECK(historical_events_replay_);
+  HistoricalEventsReplay& replay = *historical_events_replay_;
+  size_t sent_events = 0;
+  for (; replay.next_player < replay.players.size();
+       ++replay.next_player, replay.next_sequence_number = 0) {
+    const auto [process_id, player_id] = replay.players[replay.next_player];
+    // The player may have been evicted, or its process gone, since the replay
+    // started.
+    auto process_it = saved_events_by_process_.find(process_id);
+    if (process_it == saved_events_by_process_.end()) {
+      continue;
+    }
+    auto player_it = process_it->second.players_by_id.find(player_id);
+    if (player_it == process_it->second.players_by_id.end()) {
+      continue;
+    }
+    const base::circular_deque<SavedEvent>& events = player_it->second->events;
+    auto event_it = std::lower_bound(
+        events.begin(), events.end(), replay.next_sequence_number,
+        [](const SavedEvent& event, uint64_t sequence_number) {
+          return event.sequence_number < sequence_number;
+        });
+    for (; event_it != events.end() &&
+           event_it->sequence_number < replay.end_sequence_number;
+         ++event_it) {
+      if (sent_events == max_events) {
+        replay.next_sequence_number = event_it->sequence_number;
+        return;
+      }
       std::u16string update;
-      if (ConvertEventToUpdate(saved_events.first, event, &update))
+      if (ConvertEventToUpdate(process_id, event_it->record, &update)) {
         SendUpdate(update);
+      }
+      ++sent_events;
     }
   }
-  // Do not clear the map/list here so that refreshing the UI or opening a
-  // second UI still works nicely!
+  historical_events_replay_.reset();
 }
 
 void MediaInternals::SendGeneralAudioInformation() {
@@ -544,6 +635,16 @@ void MediaInternals::SendVideoCaptureDeviceCapabilities() {
                              video_capture_capabilities_cached_data_));
 }
 
+void MediaInternals::SendVideoCaptureBufferPoolStats() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+
+  if (!CanUpdate())
+    return;
+
+  SendUpdate(SerializeUpdate("media.onReceiveVideoCaptureBufferPoolStats",
+                             video_capture_buffer_pool_stats_cached_data_));
+}
+
 void MediaInternals::SendAudioFocusState() {
   audio_focus_helper_.SendAudioFocusState();
 }
@@ -591,6 +692,20 @@ void MediaInternals::UpdateVideoCaptureDeviceCapabilities(
   SendVideoCaptureDeviceCapabilities();
 }
 
+void MediaInternals::UpdateVideoCaptureBufferPoolStats(
+    const std::string& device_id,
+    base::Value::Dict stats) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (stats.empty()) {
+    video_capture_buffer_pool_stats_cached_data_.Remove(device_id);
+  } else {
+    video_capture_buffer_pool_stats_cached_data_.Set(device_id,
+                                                     std::move(stats));
+  }
+
+  SendVideoCaptureBufferPoolStats();
+}
+
 std::unique_ptr<media::AudioLog> MediaInternals::CreateAudioLog(
     AudioComponent component,
     int component_id) {
@@ -659,15 +774,24 @@ void MediaInternals::SendUpdate(const std::u16string& update) {
 void MediaInternals::SaveEvent(int process_id,
                                const media::MediaLogRecord& event) {
   DCHECK_CURRENTLY_ON(BrowserThread::UI);
-  auto& saved_events = saved_events_by_process_[process_id];
-  saved_events.push_back(event);
-  if (saved_events.size() > media::MediaLog::kLogLimit) {
-    // Remove all events for a given player as soon as we have to remove a
-    // single event for that player to avoid showing incomplete players.
-    const int id_to_remove = saved_events.front().id;
-    std::erase_if(saved_events, [&](const media::MediaLogRecord& event) {
-      return event.id == id_to_remove;
-    });
+  SavedProcessEvents& saved_events = saved_events_by_process_[process_id];
+  auto [player_it, inserted] = saved_events.players_by_id.try_emplace(event.id);
+  if (inserted) {
+    player_it->second =
+        saved_events.players.emplace(saved_events.players.end());
+    player_it->second->player_id = event.id;
+  }
+  player_it->second->events.push_back(
+      {next_saved_event_sequence_number_++, event});
+
+  if (++saved_events.event_count > media::MediaLog::kLogLimit) {
+    // Remove all events for the player with the oldest saved event as soon as
+    // we have to remove a single one of them, to avoid showing incomplete
+    // players.
+    SavedPlayerEvents& oldest_player = saved_events.players.front();
+    saved_events.event_count -= oldest_player.events.size();
+    saved_events.players_by_id.erase(oldest_player.player_id);
+    saved_events.players.pop_front();
   }
 }
 
@@ -8,11 +8,14 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#include "base/containers/circular_deque.h"
 #include "base/functional/callback_forward.h"
 #include "base/scoped_multi_source_observation.h"
 #include "base/synchronization/lock.h"
@@ -82,7 +85,8 @@ class CONTENT_EXPORT MediaInternals : public media::AudioLogFactory,
   // thread.
   bool CanUpdate();
 
-  // Replay all saved media events.
+  // Replay all saved media events. Events are sent in batches from posted
+  // tasks, and the remainder is flushed before any new event is sent.
   void SendHistoricalMediaEvents();
 
   // Sends general audio information to each registered UpdateCallback.
@@ -95,6 +99,10 @@ class CONTENT_EXPORT MediaInternals : public media::AudioLogFactory,
   // UpdateCallback.
   void SendVideoCaptureDeviceCapabilities();
 
+  // Sends all video capture buffer pool cached data to each registered
+  // UpdateCallback.
+  void SendVideoCaptureBufferPoolStats();
+
   // Sends all audio focus information to each registered UpdateCallback.
   void SendAudioFocusState();
 
@@ -107,6 +115,11 @@ class CONTENT_EXPORT MediaInternals : public media::AudioLogFactory,
                                    media::VideoCaptureFormats>>&
           descriptors_and_formats);
 
+  // Called to report the buffer pool counters of the frame sink video capture
+  // device identified by |device_id|. An empty |stats| removes the device.
+  void UpdateVideoCaptureBufferPoolStats(const std::string& device_id,
+                                         base::Value::Dict stats);
+
   // media::AudioLogFactory implementation.  Safe to call from any thread.
   std::unique_ptr<media::AudioLog> CreateAudioLog(AudioComponent component,
                                                   int component_id) override;
@@ -142,6 +155,47 @@ class CONTENT_EXPORT MediaInternals : public media::AudioLogFactory,
   // Inner class to handle reporting pipelinestatus to UMA
   class MediaInternalsUMAHandler;
 
+  // A saved event, tagged with the order in which it was saved.
+  struct SavedEvent {
+    uint64_t sequence_number;
+    media::MediaLogRecord record;
+  };
+
+  // Saved events of a single player, oldest first.
+  struct SavedPlayerEvents {
+    SavedPlayerEvents();
+    ~SavedPlayerEvents();
+
+    int player_id = 0;
+    base::circular_deque<SavedEvent> events;
+  };
+
+  // Saved events of a single render process. Players are kept in the order in
+  // which their oldest saved event arrived, so the player to evict once the
+  // process exceeds media::MediaLog::kLogLimit events is always the first.
+  struct SavedProcessEvents {
+    SavedProcessEvents();
+    ~SavedProcessEvents();
+
+    std::list<SavedPlayerEvents> players;
+    std::map<int, std::list<SavedPlayerEvents>::iterator> players_by_id;
+    size_t event_count = 0;
+  };
+
+  // Progress of the replay started by SendHistoricalMediaEvents().
+  struct HistoricalEventsReplay {
+    HistoricalEventsReplay();
+    ~HistoricalEventsReplay();
+
+    // Render process ID and player ID of each player to replay.
+    std::vector<std::pair<int, int>> players;
+    size_t next_player = 0;
+    // Events of |players[next_player]| before this one have been sent.
+    uint64_t next_sequence_number = 0;
+    // Events saved from this one on were sent when they arrived.
+    uint64_t end_sequence_number = 0;
+  };
+
   MediaInternals();
 
   // Sends |update| to each registered UpdateCallback.  Safe to call from any
@@ -154,6 +208,13 @@ class CONTENT_EXPORT MediaInternals : public media::AudioLogFactory,
   // Erases saved events for |host|, if any.
   void EraseSavedEvents(RenderProcessHost* host);
 
+  // Sends up to |max_events| more events of |historical_events_replay_|, and
+  // resets it once every event has been sent.
+  void ContinueHistoricalMediaEventsReplay(size_t max_events);
+
+  // Posted task which sends the next batch of |historical_events_replay_|.
+  void SendNextHistoricalMediaEvents();
+
   // Caches |value| under |cache_key| so that future UpdateAudioLog() calls
   // will include the current data.  Calls JavaScript |function|(|value|) for
   // each registered UpdateCallback (if any).
@@ -177,10 +238,16 @@ class CONTENT_EXPORT MediaInternals : public media::AudioLogFactory,
   std::vector<UpdateCallback> update_callbacks_;
 
   // Saved events by process ID for showing recent players in the UI.
-  std::map<int, std::list<media::MediaLogRecord>> saved_events_by_process_;
+  std::map<int, SavedProcessEvents> saved_events_by_process_;
+  uint64_t next_saved_event_sequence_number_ = 0;
+
+  // Set while saved events are being replayed to the UI.
+  std::optional<HistoricalEventsReplay> historical_events_replay_;
+  bool historical_events_replay_task_posted_ = false;
 
   // Must only be accessed on the IO thread.
   base::Value::List video_capture_capabilities_cached_data_;
+  base::Value::Dict video_capture_buffer_pool_stats_cached_data_;
 
   base::ScopedMultiSourceObservation<content::RenderProcessHost,
                                      content::RenderProcessHostObserver>
@@ -56,6 +56,7 @@ void MediaInternalsProxy::GetEverythingOnIOThread() {
   // TODO(xhwang): Investigate whether we can update on UI thread directly.
   MediaInternals::GetInstance()->SendAudioStreamData();
   MediaInternals::GetInstance()->SendVideoCaptureDeviceCapabilities();
+  MediaInternals::GetInstance()->SendVideoCaptureBufferPoolStats();
 }
 
 // static
@@ -6,6 +6,9 @@
 
 #include <stddef.h>
 
+#include <utility>
+#include <vector>
+
 #include "base/functional/bind.h"
 #include "base/functional/callback_helpers.h"
 #include "base/json/json_reader.h"
@@ -24,6 +27,7 @@
 #include "media/base/audio_parameters.h"
 #include "media/base/channel_layout.h"
 #include "media/base/media_log.h"
+#include "media/base/media_log_record.h"
 #include "media/base/media_switches.h"
 #include "mojo/public/cpp/bindings/remote.h"
 #include "services/media_session/public/cpp/features.h"
@@ -301,6 +305,98 @@ INSTANTIATE_TEST_SUITE_P(
         media::AudioLogFactory::AudioComponent::kAudioOuputController,
         media::AudioLogFactory::AudioComponent::kAudioOutputStream));
 
+class MediaInternalsSavedEventsTest : public testing::Test {
+ public:
+  MediaInternalsSavedEventsTest()
+      : update_cb_(base::BindRepeating(
+            &MediaInternalsSavedEventsTest::OnUpdate,
+            base::Unretained(this))) {}
+
+  ~MediaInternalsSavedEventsTest() override {
+    MediaInternals::GetInstance()->RemoveUpdateCallback(update_cb_);
+  }
+
+ protected:
+  static media::MediaLogRecord CreateEvent(int player_id, int index) {
+    media::MediaLogRecord event;
+    event.id = player_id;
+    event.type = media::MediaLogRecord::Type::kMessage;
+    event.time = base::TimeTicks::Now();
+    event.params.Set("index", index);
+    return event;
+  }
+
+  // Records the player ID and "index" param of each media event update for
+  // |render_process_id|.
+  void OnUpdate(const std::u16string& update) {
+    const std::string utf8_update = base::UTF16ToUTF8(update);
+    if (!utf8_update.starts_with("media.onMediaEvent(")) {
+      return;
+    }
+    const std::string::size_type first_brace = utf8_update.find('{');
+    const std::string::size_type last_brace = utf8_update.rfind('}');
+    std::optional<base::Value::Dict> dict = base::JSONReader::ReadDict(
+        utf8_update.substr(first_brace, last_brace - first_brace + 1));
+    ASSERT_TRUE(dict);
+    if (dict->FindInt("renderer") != render_process_id_) {
+      return;
+    }
+    received_events_.emplace_back(
+        *dict->FindInt("player"),
+        *dict->FindDict("params")->FindInt("index"));
+  }
+
+  const BrowserTaskEnvironment task_environment_;
+  MediaInternals::UpdateCallback update_cb_;
+  // The saved events of MediaInternals outlive each test, so every test uses
+  // its own render process ID.
+  int render_process_id_ = 0;
+  std::vector<std::pair<int, int>> received_events_;
+};
+
+// Verifies that all events of the player with the oldest saved event are
+// evicted once a process exceeds the log limit.
+TEST_F(MediaInternalsSavedEventsTest, EvictsOldestPlayer) {
+  render_process_id_ = 1001;
+  std::vector<media::MediaLogRecord> events;
+  for (size_t i = 0; i < media::MediaLog::kLogLimit - 1; ++i) {
+    events.push_back(CreateEvent(/*player_id=*/1, static_cast<int>(i)));
+  }
+  events.push_back(CreateEvent(/*player_id=*/2, 0));
+  events.push_back(CreateEvent(/*player_id=*/2, 1));
+  MediaInternals::GetInstance()->OnMediaEvents(render_process_id_, events);
+
+  MediaInternals::GetInstance()->AddUpdateCallback(update_cb_);
+  MediaInternals::GetInstance()->SendHistoricalMediaEvents();
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(received_events_,
+            (std::vector<std::pair<int, int>>{{2, 0}, {2, 1}}));
+}
+
+// Verifies that saved events are replayed in order and exactly once, even when
+// new events arrive before the replay has finished.
+TEST_F(MediaInternalsSavedEventsTest, ReplayPrecedesNewEvents) {
+  render_process_id_ = 1002;
+  std::vector<media::MediaLogRecord> events;
+  for (int i = 0; i < 3; ++i) {
+    events.push_back(CreateEvent(/*player_id=*/1, i));
+  }
+  MediaInternals::GetInstance()->OnMediaEvents(render_process_id_, events);
+
+  MediaInternals::GetInstance()->AddUpdateCallback(update_cb_);
+  MediaInternals::GetInstance()->SendHistoricalMediaEvents();
+  // The replay runs from a posted task.
+  EXPECT_TRUE(received_events_.empty());
+
+  MediaInternals::GetInstance()->OnMediaEvents(render_process_id_,
+                                               {CreateEvent(1, 3)});
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(received_events_, (std::vector<std::pair<int, int>>{
+                                  {1, 0}, {1, 1}, {1, 2}, {1, 3}}));
+}
+
 // TODO(crbug.com/40589017): AudioFocusManager is not available on
 // Android.
 #if !BUILDFLAG(IS_ANDROID)
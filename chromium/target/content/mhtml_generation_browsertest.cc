@@ -4,7 +4,10 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
+#include <set>
+#include <string_view>
 
 #include "base/containers/span.h"
 #include "base/files/file_path.h"
@@ -875,6 +878,53 @@ IN_PROC_BROWSER_TEST_P(MHTMLGenerationSitePerProcessTest, GenerateMHTML) {
                              EndsWith("/title1.html")}));
 }
 
+class MHTMLGenerationParallelSitePerProcessTest
+    : public MHTMLGenerationSitePerProcessTest {
+ public:
+  MHTMLGenerationParallelSitePerProcessTest() {
+    feature_list_.InitAndEnableFeature(kParallelMHTMLGeneration);
+  }
+
+ private:
+  base::test::ScopedFeatureList feature_list_;
+};
+
+// Checks that frames from different processes serialized in parallel are all
+// written to a well-formed file.
+IN_PROC_BROWSER_TEST_P(MHTMLGenerationParallelSitePerProcessTest,
+                       GenerateMHTML) {
+  base::FilePath path =
+      temp_dir_.GetPath().Append(FILE_PATH_LITERAL("test.mht"));
+
+  GURL url(embedded_test_server()->GetURL(
+      "a.com", "/cross_site_iframe_factory.html?a(b,c)"));
+  MHTMLFileInfo info = GenerateMHTML(path, url);
+
+  std::vector<std::string> content_locations = info.ContentLocations();
+  EXPECT_THAT(content_locations,
+              testing::IsSupersetOf({HasSubstr("a.com"), HasSubstr("b.com"),
+                                     HasSubstr("c.com")}));
+  histogram_tester()->ExpectTotalCount(
+      "PageSerialization.MhtmlGeneration.FullPageSavingTime.2To4Frames", 1);
+
+  // The parts are written in frame tree order, as in a sequential save.
+  auto first_part_of = [&content_locations](std::string_view host) {
+    return std::ranges::find_if(content_locations,
+                                [host](const std::string& location) {
+                                  return location.find(host) !=
+                                         std::string::npos;
+                                });
+  };
+  EXPECT_LT(first_part_of("a.com"), first_part_of("b.com"));
+  EXPECT_LT(first_part_of("b.com"), first_part_of("c.com"));
+
+  // Each frame and resource is written once, even though the frames did not
+  // see each other's resources.
+  std::set<std::string> unique_content_locations(content_locations.begin(),
+                                                 content_locations.end());
+  EXPECT_EQ(unique_content_locations.size(), content_locations.size());
+}
+
 IN_PROC_BROWSER_TEST_P(MHTMLGenerationTest, RemovePopupOverlay) {
   base::FilePath path(temp_dir_.GetPath());
   path = path.Append(FILE_PATH_LITERAL("test.mht"));
@@ -1032,6 +1082,9 @@ INSTANTIATE_TEST_SUITE_P(MHTMLGenerationTest,
 INSTANTIATE_TEST_SUITE_P(MHTMLGenerationSitePerProcessTest,
                          MHTMLGenerationSitePerProcessTest,
                          testing::Bool());
+INSTANTIATE_TEST_SUITE_P(MHTMLGenerationParallelSitePerProcessTest,
+                         MHTMLGenerationParallelSitePerProcessTest,
+                         testing::Bool());
 INSTANTIATE_TEST_SUITE_P(MHTMLGenerationImprovedTest,
                          MHTMLGenerationImprovedTest,
                          testing::Bool());
@@ -4,6 +4,10 @@
 
 #include "content/browser/download/mhtml_generation_manager.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string_view>
 #include <tuple>
 #include <utility>
 
@@ -12,11 +16,15 @@
 #include "base/files/file.h"
 #include "base/functional/bind.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/numerics/safe_conversions.h"
 #include "base/stl_util.h"
+#include "base/strings/strcat.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/task/bind_post_task.h"
+#include "base/threading/sequence_bound.h"
 #include "base/time/time.h"
 #include "base/trace_event/trace_event.h"
 #include "base/types/optional_util.h"
@@ -39,6 +47,8 @@
 #include "crypto/sha2.h"
 #include "mojo/core/embedder/embedder.h"
 #include "mojo/public/cpp/bindings/associated_remote.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "mojo/public/cpp/system/simple_watcher.h"
 #include "net/base/mime_util.h"
 #include "third_party/blink/public/common/associated_interfaces/associated_interface_provider.h"
 
@@ -143,6 +153,268 @@ base::File CreateMHTMLFile(const base::FilePath& file_path) {
 
 namespace content {
 
+BASE_FEATURE(kParallelMHTMLGeneration,
+             "ParallelMHTMLGeneration",
+             base::FEATURE_DISABLED_BY_DEFAULT);
+
+const base::FeatureParam<int> kParallelMHTMLGenerationMaxFrames{
+    &kParallelMHTMLGeneration, "max_frames", 4};
+
+namespace {
+
+// Returns the suffix of the saving time histogram for a page with
+// `frame_count` frames.
+const char* GetFrameCountHistogramSuffix(size_t frame_count) {
+  if (frame_count <= 1) {
+    return "SingleFrame";
+  }
+  if (frame_count <= 4) {
+    return "2To4Frames";
+  }
+  if (frame_count <= 16) {
+    return "5To16Frames";
+  }
+  return "Over16Frames";
+}
+
+// The most data MHTMLPartWriter holds in memory for parts that wait for earlier
+// parts. Once reached, it stops reading those parts, which makes their
+// renderers wait on the full data pipes, until earlier parts are written.
+constexpr size_t kMaxBufferedPartBytes = 16 * 1024 * 1024;
+
+// Reads the MHTML parts that renderers stream through data pipes when frames
+// are serialized in parallel, and appends them to the file in frame order. The
+// part of the earliest frame not yet written goes to the file as it streams
+// in; the parts of later frames are buffered, up to kMaxBufferedPartBytes,
+// until all the earlier parts have been written.
+//
+// Renderers serializing in parallel cannot see each other's resources, so they
+// may serialize the same ones. A resource whose URI was already written is
+// dropped, so that the file holds one copy of it, as in a sequential save.
+// Lives on the download sequence.
+class MHTMLPartWriter {
+ public:
+  using PartWrittenCallback =
+      base::OnceCallback<void(mojom::MhtmlSaveStatus)>;
+
+  // |digests_of_written_uris| are the digests of the resources already in
+  // |file|, computed with |salt| like the renderer does.
+  MHTMLPartWriter(base::File file,
+                  const std::string& boundary,
+                  std::string salt,
+                  std::set<std::string> digests_of_written_uris)
+      : file_(std::move(file)),
+        delimiter_(base::StrCat({"\r\n--", boundary, "\r\n"})),
+        salt_(std::move(salt)),
+        digests_of_written_uris_(std::move(digests_of_written_uris)) {}
+  MHTMLPartWriter(const MHTMLPartWriter&) = delete;
+  MHTMLPartWriter& operator=(const MHTMLPartWriter&) = delete;
+  ~MHTMLPartWriter() = default;
+
+  // Reads the part at `part_index` from `consumer` until the renderer closes
+  // it. `callback` is run once the part has been written, or on error.
+  void ReadPart(size_t part_index,
+                mojo::ScopedDataPipeConsumerHandle consumer,
+                PartWrittenCallback callback) {
+    DCHECK(download::GetDownloadTaskRunner()->RunsTasksInCurrentSequence());
+    Part& part = parts_[part_index];
+    part.consumer = std::move(consumer);
+    part.callback = std::move(callback);
+    part.watcher = std::make_unique<mojo::SimpleWatcher>(
+        FROM_HERE, mojo::SimpleWatcher::ArmingPolicy::MANUAL,
+        download::GetDownloadTaskRunner());
+    // base::Unretained is safe, as |this| owns the watcher.
+    if (part.watcher->Watch(
+            part.consumer.get(),
+            MOJO_HANDLE_SIGNAL_READABLE | MOJO_HANDLE_SIGNAL_PEER_CLOSED,
+            MOJO_WATCH_CONDITION_SATISFIED,
+            base::BindRepeating(&MHTMLPartWriter::OnPartReadable,
+                                base::Unretained(this), part_index)) !=
+        MOJO_RESULT_OK) {
+      FailPart(part_index, mojom::MhtmlSaveStatus::kStreamingError);
+      return;
+    }
+    part.watcher->ArmOrNotify();
+  }
+
+ private:
+  struct Part {
+    mojo::ScopedDataPipeConsumerHandle consumer;
+    std::unique_ptr<mojo::SimpleWatcher> watcher;
+    // Data read from |consumer| that does not form a complete MIME part yet.
+    std::string pending;
+    // Where to look for the next delimiter in |pending|.
+    size_t search_start = 0;
+    // Complete MIME parts waiting to be written.
+    std::string buffered;
+    // The first MIME part of a frame is its own document, which is always
+    // kept.
+    bool at_first_mime_part = true;
+    // Whether reading stopped at kMaxBufferedPartBytes.
+    bool paused = false;
+    bool complete = false;
+    PartWrittenCallback callback;
+  };
+
+  void OnPartReadable(size_t part_index,
+                      MojoResult result,
+                      const mojo::HandleSignalsState& state) {
+    Part& part = parts_.at(part_index);
+    while (result == MOJO_RESULT_OK) {
+      if (part_index != next_part_index_ &&
+          buffered_bytes_ >= kMaxBufferedPartBytes) {
+        // Resumed by WriteCompletedParts() once earlier parts are written.
+        part.paused = true;
+        break;
+      }
+      base::span<const uint8_t> buffer;
+      result = part.consumer->BeginReadData(MOJO_READ_DATA_FLAG_NONE, buffer);
+      if (result == MOJO_RESULT_OK) {
+        part.pending.append(base::as_string_view(buffer));
+        buffered_bytes_ += buffer.size();
+        part.consumer->EndReadData(buffer.size());
+      }
+    }
+    // MOJO_RESULT_FAILED_PRECONDITION means that the renderer closed the pipe
+    // and everything has been read.
+    const bool at_end = result == MOJO_RESULT_FAILED_PRECONDITION;
+    if (result != MOJO_RESULT_OK && result != MOJO_RESULT_SHOULD_WAIT &&
+        !at_end) {
+      DLOG(ERROR) << "Error streaming MHTML data to the Browser.";
+      FailPart(part_index, mojom::MhtmlSaveStatus::kStreamingError);
+      return;
+    }
+
+    SplitMimeParts(part, at_end);
+    if (at_end) {
+      part.watcher.reset();
+      part.consumer.reset();
+      part.complete = true;
+    } else if (result == MOJO_RESULT_SHOULD_WAIT) {
+      part.watcher->ArmOrNotify();
+    }
+    WriteCompletedParts();
+  }
+
+  // Moves the complete MIME parts at the start of |part.pending|, or all of it
+  // at the end of the stream, to |part.buffered|, dropping the resources that
+  // were already written.
+  void SplitMimeParts(Part& part, bool at_end) {
+    while (!part.pending.empty()) {
+      size_t end = part.pending.find(delimiter_, part.search_start);
+      if (end == std::string::npos) {
+        if (!at_end) {
+          part.search_start =
+              part.pending.size() - std::min(part.pending.size(),
+                                             delimiter_.size() - 1);
+          return;
+        }
+        end = part.pending.size();
+      } else {
+        // The line break before the delimiter belongs to this MIME part.
+        end += 2;
+      }
+      std::string_view mime_part = std::string_view(part.pending).substr(0, end);
+      if (part.at_first_mime_part || !IsAlreadyWritten(mime_part)) {
+        part.buffered.append(mime_part);
+      } else {
+        buffered_bytes_ -= mime_part.size();
+      }
+      part.at_first_mime_part = false;
+      part.pending.erase(0, end);
+      part.search_start = 0;
+    }
+  }
+
+  // Returns whether |mime_part| is a resource whose URI was already written,
+  // and otherwise records its URI as written.
+  bool IsAlreadyWritten(std::string_view mime_part) {
+    static constexpr std::string_view kContentLocation =
+        "\r\nContent-Location: ";
+    const std::string_view headers =
+        mime_part.substr(0, mime_part.find("\r\n\r\n"));
+    size_t start = headers.find(kContentLocation);
+    if (start == std::string_view::npos) {
+      return false;
+    }
+    start += kContentLocation.size();
+    const std::string_view uri =
+        headers.substr(start, headers.find("\r\n", start) - start);
+    return !digests_of_written_uris_
+                .insert(crypto::SHA256HashString(base::StrCat({salt_, uri})))
+                .second;
+  }
+
+  void FailPart(size_t part_index, mojom::MhtmlSaveStatus save_status) {
+    auto it = parts_.find(part_index);
+    buffered_bytes_ -= it->second.pending.size() + it->second.buffered.size();
+    PartWrittenCallback callback = std::move(it->second.callback);
+    parts_.erase(it);
+    std::move(callback).Run(save_status);
+  }
+
+  // Writes what the earliest unwritten part has buffered, and the parts after
+  // it once it is complete. Then resumes the parts that were paused, if that
+  // freed enough memory.
+  void WriteCompletedParts() {
+    for (auto it = parts_.find(next_part_index_); it != parts_.end();
+         it = parts_.find(next_part_index_)) {
+      Part& part = it->second;
+      if (!part.buffered.empty()) {
+        buffered_bytes_ -= part.buffered.size();
+        const bool written = WriteToFile(part.buffered);
+        std::string().swap(part.buffered);
+        if (!written) {
+          FailPart(next_part_index_,
+                   mojom::MhtmlSaveStatus::kFileWritingError);
+          return;
+        }
+      }
+      if (!part.complete) {
+        break;
+      }
+      PartWrittenCallback callback = std::move(part.callback);
+      parts_.erase(it);
+      ++next_part_index_;
+      std::move(callback).Run(mojom::MhtmlSaveStatus::kSuccess);
+    }
+
+    for (auto& [part_index, part] : parts_) {
+      // The earliest unwritten part is always read, so that it cannot be held
+      // up by the parts waiting for it.
+      if (part.paused && (part_index == next_part_index_ ||
+                          buffered_bytes_ < kMaxBufferedPartBytes)) {
+        part.paused = false;
+        part.watcher->ArmOrNotify();
+      }
+    }
+  }
+
+  bool WriteToFile(std::string_view data) {
+#if BUILDFLAG(IS_FUCHSIA)
+    // On fuchsia, fds do not share state, so seek past what the renderer
+    // wrote for the main frame.
+    if (file_.Seek(base::File::FROM_END, 0) == -1) {
+      return false;
+    }
+#endif  // BUILDFLAG(IS_FUCHSIA)
+    return file_.WriteAtCurrentPosAndCheck(base::as_byte_span(data));
+  }
+
+  base::File file_;
+  // Separates the MIME parts of the file.
+  const std::string delimiter_;
+  const std::string salt_;
+  std::set<std::string> digests_of_written_uris_;
+  // Parts that are being read, or have been read and wait for earlier parts.
+  std::map<size_t, Part> parts_;
+  size_t next_part_index_ = 0;
+  // The size of |Part::pending| and |Part::buffered| across |parts_|.
+  size_t buffered_bytes_ = 0;
+};
+
+}  // namespace
+
 // The class and all of its members live on the UI thread.  Only static methods
 // are executed on other threads.
 // Job instances are created in MHTMLGenerationManager::Job::StartNewJob(),
@@ -246,14 +518,37 @@ class MHTMLGenerationManager::Job {
       const std::vector<std::string>& digests_of_uris_of_serialized_resources);
 
   // Records newly serialized resource digests into
-  // |digests_of_already_serialized_uris_|.
+  // |digests_of_already_serialized_uris_|. |digests_of_uris_to_skip| are the
+  // digests the renderer was told to skip.
   void RecordDigests(
-      const std::vector<std::string>& digests_of_uris_of_serialized_resources);
+      const std::vector<std::string>& digests_of_uris_of_serialized_resources,
+      const std::set<std::string>& digests_of_uris_to_skip);
 
   // Continues sending serialization requests to the next frame if ready and
   // there are more frames to be serialized.
   void MaybeSendToNextRenderFrame(mojom::MhtmlSaveStatus save_status);
 
+  // Called once the main frame is serialized when kParallelMHTMLGeneration is
+  // enabled. Moves the remaining frames to |parallel_pending_frames_| and sets
+  // up |part_writer_|.
+  void StartParallelSerialization();
+
+  // Sends serialization requests to as many frames of
+  // |parallel_pending_frames_| as allowed, skipping frames whose process is
+  // already serializing another frame.
+  mojom::MhtmlSaveStatus SendToParallelFrames();
+
+  // Called when the renderer responds for, or |part_writer_| has written, the
+  // part at |part_index|.
+  void OnParallelFrameResponse(
+      size_t part_index,
+      mojom::MhtmlSaveStatus save_status,
+      const std::vector<std::string>& digests_of_uris_of_serialized_resources);
+  void OnParallelPartWritten(size_t part_index,
+                             mojom::MhtmlSaveStatus save_status);
+  void OnParallelFrameProgress(size_t part_index,
+                               mojom::MhtmlSaveStatus save_status);
+
   // Packs up the current status of the MHTML file save operation into a Mojo
   // struct to send to the renderer process.
   mojom::SerializeAsMHTMLParamsPtr CreateMojoParams();
@@ -264,7 +559,8 @@ class MHTMLGenerationManager::Job {
   mojom::MhtmlSaveStatus SendToNextRenderFrame();
 
   // Indicates if the writing operation on the IO thread is complete, and
-  // we have received a response from the Renderer.
+  // we have received a response from the Renderer, including for all the
+  // frames serialized in parallel.
   // This check is necessary to provide synchronization between file writing
   // operations and MHTML serialization.
   bool CurrentFrameDone() const;
@@ -337,6 +633,31 @@ class MHTMLGenerationManager::Job {
   // download sequence.
   std::unique_ptr<crypto::SecureHash> secure_hash_;
 
+  // A frame being serialized in parallel with others.
+  struct ParallelFrame {
+    mojo::AssociatedRemote<mojom::MhtmlFileWriter> writer;
+    int process_id;
+    bool responded = false;
+    bool part_written = false;
+    // The digests the renderer was told to skip. Frames serialized at the
+    // same time do not see each other's resources, so this can be older than
+    // |digests_of_already_serialized_uris_| by the time the frame responds.
+    std::set<std::string> digests_of_uris_to_skip;
+  };
+
+  // Frames yet to be serialized in parallel, with the index of their part.
+  std::vector<std::pair<size_t, FrameTreeNodeId>> parallel_pending_frames_;
+
+  // Frames being serialized in parallel, keyed by the index of their part.
+  std::map<size_t, ParallelFrame> parallel_frames_;
+
+  // Writes the parts of frames serialized in parallel to the file.
+  base::SequenceBound<MHTMLPartWriter> part_writer_;
+
+  // The number of frames to serialize and when the job started, for metrics.
+  size_t frame_count_ = 0;
+  base::TimeTicks start_time_;
+
   base::WeakPtrFactory<Job> weak_factory_{this};
 };
 
@@ -377,6 +698,8 @@ void MHTMLGenerationManager::Job::initializeJob(WebContents* web_contents) {
     }
     pending_frame_tree_node_ids_.push(node->frame_tree_node_id());
   }
+  frame_count_ = pending_frame_tree_node_ids_.size();
+  start_time_ = base::TimeTicks::Now();
 
   // Main frame needs to be processed first.
   DCHECK(!pending_frame_tree_node_ids_.empty());
@@ -579,6 +902,13 @@ void MHTMLGenerationManager::Job::OnFinished(
                                   "job save status", save_status, "file size",
                                   file_size);
 
+  if (save_status == mojom::MhtmlSaveStatus::kSuccess) {
+    base::UmaHistogramMediumTimes(
+        base::StrCat({"PageSerialization.MhtmlGeneration.FullPageSavingTime.",
+                      GetFrameCountHistogramSuffix(frame_count_)}),
+        base::TimeTicks::Now() - start_time_);
+  }
+
   std::move(callback_).Run(close_file_result.toMHTMLGenerationResult());
 
   delete this;  // This is the last time the Job is referenced.
@@ -593,6 +923,7 @@ void MHTMLGenerationManager::Job::MarkAsFinished() {
   }
   is_finished_ = true;
   writer_.reset();
+  parallel_frames_.clear();
 
   // Additionally, |watcher_| may also invoke DoneWritingToDisk() from
   // the download sequence, potentially calling this twice. We cannot disable
@@ -613,6 +944,10 @@ void MHTMLGenerationManager::Job::CloseFile(
       save_status == mojom::MhtmlSaveStatus::kSuccess)
     save_status = mojom::MhtmlSaveStatus::kFileWritingError;
 
+  // Destroy the part writer first, its file handle is a duplicate of
+  // |browser_file_|.
+  part_writer_.Reset();
+
   // If no previous error occurred the boundary should be sent.
   download::GetDownloadTaskRunner()->PostTaskAndReplyWithResult(
       FROM_HERE,
@@ -634,17 +969,20 @@ void MHTMLGenerationManager::Job::SerializeAsMHTMLResponse(
   frame_tree_node_id_of_busy_frame_ = FrameTreeNodeId();
 
   // If the renderer succeeded, update the resource digests.
-  if (save_status == mojom::MhtmlSaveStatus::kSuccess)
-    RecordDigests(digests_of_uris_of_serialized_resources);
+  if (save_status == mojom::MhtmlSaveStatus::kSuccess) {
+    RecordDigests(digests_of_uris_of_serialized_resources,
+                  digests_of_already_serialized_uris_);
+  }
 
   MaybeSendToNextRenderFrame(save_status);
 }
 
 void MHTMLGenerationManager::Job::RecordDigests(
-    const std::vector<std::string>& digests_of_uris_of_serialized_resources) {
+    const std::vector<std::string>& digests_of_uris_of_serialized_resources,
+    const std::set<std::string>& digests_of_uris_to_skip) {
   // Renderer should be deduping resources with the same uris.
   DCHECK_EQ(0u, base::STLSetIntersection<std::set<std::string>>(
-                    digests_of_already_serialized_uris_,
+                    digests_of_uris_to_skip,
                     std::set<std::string>(
                         digests_of_uris_of_serialized_resources.begin(),
                         digests_of_uris_of_serialized_resources.end()))
@@ -660,7 +998,15 @@ void MHTMLGenerationManager::Job::MaybeSendToNextRenderFrame(
   // let save status depend on the result of sending the next request.
   if (save_status == mojom::MhtmlSaveStatus::kSuccess &&
       !pending_frame_tree_node_ids_.empty() && CurrentFrameDone()) {
-    save_status = SendToNextRenderFrame();
+    if (base::FeatureList::IsEnabled(kParallelMHTMLGeneration)) {
+      StartParallelSerialization();
+    } else {
+      save_status = SendToNextRenderFrame();
+    }
+  }
+  if (save_status == mojom::MhtmlSaveStatus::kSuccess &&
+      !parallel_pending_frames_.empty()) {
+    save_status = SendToParallelFrames();
   }
 
   // If there was a failure (either from the renderer or from the job) then
@@ -676,9 +1022,126 @@ void MHTMLGenerationManager::Job::MaybeSendToNextRenderFrame(
     Finalize(mojom::MhtmlSaveStatus::kSuccess);
 }
 
+void MHTMLGenerationManager::Job::StartParallelSerialization() {
+  DCHECK(!part_writer_);
+  // The main frame, which wrote the MHTML header, is done.
+  writer_.reset();
+  size_t part_index = 0;
+  while (!pending_frame_tree_node_ids_.empty()) {
+    parallel_pending_frames_.emplace_back(part_index++,
+                                          pending_frame_tree_node_ids_.front());
+    pending_frame_tree_node_ids_.pop();
+  }
+  part_writer_ = base::SequenceBound<MHTMLPartWriter>(
+      download::GetDownloadTaskRunner(), browser_file_.Duplicate(),
+      mhtml_boundary_marker_, salt_, digests_of_already_serialized_uris_);
+}
+
+mojom::MhtmlSaveStatus MHTMLGenerationManager::Job::SendToParallelFrames() {
+  DCHECK(part_writer_);
+  const size_t max_frames =
+      std::max(1, kParallelMHTMLGenerationMaxFrames.Get());
+  for (auto it = parallel_pending_frames_.begin();
+       it != parallel_pending_frames_.end() &&
+       parallel_frames_.size() < max_frames;) {
+    auto [part_index, frame_tree_node_id] = *it;
+    FrameTreeNode* ftn = FrameTreeNode::GloballyFindByID(frame_tree_node_id);
+    if (!ftn) {  // The contents went away.
+      return mojom::MhtmlSaveStatus::kFrameNoLongerExists;
+    }
+    RenderFrameHost* rfh = ftn->current_frame_host();
+
+    // Frames of a process are serialized on the same renderer thread, so only
+    // send one at a time. This also lets them skip resources already
+    // serialized by the previous one.
+    int process_id = rfh->GetProcess()->GetDeprecatedID();
+    if (std::ranges::any_of(parallel_frames_, [process_id](const auto& entry) {
+          return entry.second.process_id == process_id;
+        })) {
+      ++it;
+      continue;
+    }
+
+    mojo::ScopedDataPipeProducerHandle producer;
+    mojo::ScopedDataPipeConsumerHandle consumer;
+    if (mojo::CreateDataPipe(nullptr, producer, consumer) != MOJO_RESULT_OK) {
+      return mojom::MhtmlSaveStatus::kStreamingError;
+    }
+
+    ParallelFrame& frame = parallel_frames_[part_index];
+    frame.process_id = process_id;
+    rfh->GetRemoteAssociatedInterfaces()->GetInterface(&frame.writer);
+    // Safe, as the writer is owned by this Job instance.
+    frame.writer.set_disconnect_handler(
+        base::BindOnce(&Job::OnConnectionError, base::Unretained(this)));
+
+    mojom::SerializeAsMHTMLParamsPtr params(CreateMojoParams());
+    frame.digests_of_uris_to_skip = digests_of_already_serialized_uris_;
+    params->output_handle =
+        mojom::MhtmlOutputHandle::NewProducerHandle(std::move(producer));
+    frame.writer->SerializeAsMHTML(
+        std::move(params),
+        base::BindOnce(&Job::OnParallelFrameResponse,
+                       weak_factory_.GetWeakPtr(), part_index));
+    part_writer_.AsyncCall(&MHTMLPartWriter::ReadPart)
+        .WithArgs(part_index, std::move(consumer),
+                  base::BindPostTaskToCurrentDefault(
+                      base::BindOnce(&Job::OnParallelPartWritten,
+                                     weak_factory_.GetWeakPtr(), part_index)));
+
+    it = parallel_pending_frames_.erase(it);
+  }
+  return mojom::MhtmlSaveStatus::kSuccess;
+}
+
+void MHTMLGenerationManager::Job::OnParallelFrameResponse(
+    size_t part_index,
+    mojom::MhtmlSaveStatus save_status,
+    const std::vector<std::string>& digests_of_uris_of_serialized_resources) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (is_finished_) {
+    return;
+  }
+  if (save_status == mojom::MhtmlSaveStatus::kSuccess) {
+    RecordDigests(digests_of_uris_of_serialized_resources,
+                  parallel_frames_.at(part_index).digests_of_uris_to_skip);
+  }
+  ParallelFrame& frame = parallel_frames_.at(part_index);
+  frame.responded = true;
+  // The renderer is done with this frame, so stop watching for disconnection.
+  frame.writer.reset();
+  OnParallelFrameProgress(part_index, save_status);
+}
+
+void MHTMLGenerationManager::Job::OnParallelPartWritten(
+    size_t part_index,
+    mojom::MhtmlSaveStatus save_status) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (is_finished_) {
+    return;
+  }
+  parallel_frames_.at(part_index).part_written = true;
+  OnParallelFrameProgress(part_index, save_status);
+}
+
+void MHTMLGenerationManager::Job::OnParallelFrameProgress(
+    size_t part_index,
+    mojom::MhtmlSaveStatus save_status) {
+  if (save_status != mojom::MhtmlSaveStatus::kSuccess) {
+    Finalize(save_status);
+    return;
+  }
+  auto it = parallel_frames_.find(part_index);
+  if (it->second.responded && it->second.part_written) {
+    parallel_frames_.erase(it);
+  }
+  MaybeSendToNextRenderFrame(save_status);
+}
+
 bool MHTMLGenerationManager::Job::CurrentFrameDone() const {
   bool waiting_for_response_from_renderer = !!frame_tree_node_id_of_busy_frame_;
-  return !waiting_for_response_from_renderer && !waiting_on_data_streaming_;
+  return !waiting_for_response_from_renderer && !waiting_on_data_streaming_ &&
+         parallel_pending_frames_.empty() && parallel_frames_.empty();
 }
 
 void MHTMLGenerationManager::Job::Finalize(mojom::MhtmlSaveStatus save_status) {
@@ -6,8 +6,11 @@
 
 #include <stdint.h>
 
+#include "base/feature_list.h"
 #include "base/memory/singleton.h"
+#include "base/metrics/field_trial_params.h"
 #include "base/process/process.h"
+#include "content/common/content_export.h"
 #include "content/public/browser/mhtml_generation_result.h"
 #include "content/public/common/mhtml_generation_params.h"
 
@@ -15,6 +18,14 @@ namespace content {
 
 class WebContents;
 
+// When enabled, once the main frame has been serialized, the remaining frames
+// are serialized concurrently, at most one per renderer process, each into its
+// own data pipe. Their parts are then appended to the file in frame order.
+CONTENT_EXPORT BASE_DECLARE_FEATURE(kParallelMHTMLGeneration);
+// The maximum number of frames serialized at the same time.
+CONTENT_EXPORT extern const base::FeatureParam<int>
+    kParallelMHTMLGenerationMaxFrames;
+
 // The class and all of its members live on the UI thread.  Only static methods
 // are executed on other threads.
 //
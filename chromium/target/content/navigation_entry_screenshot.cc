@@ -10,9 +10,15 @@
 #include "content/browser/renderer_host/navigation_transitions/navigation_transition_config.h"
 
 #if BUILDFLAG(IS_ANDROID)
+#include <algorithm>
+#include <vector>
+
 #include "base/functional/callback.h"
-#include "base/task/bind_post_task.h"
+#include "base/metrics/field_trial_params.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/no_destructor.h"
 #include "base/task/thread_pool.h"
+#include "base/time/time.h"
 #include "ui/android/resources/etc1_utils.h"
 #endif
 
@@ -25,29 +31,142 @@ BASE_FEATURE(kNavigationEntryScreenshotCompression,
              "NavigationEntryScreenshotCompression",
              base::FEATURE_ENABLED_BY_DEFAULT);
 
+// The maximum number of screenshots compressed concurrently on worker threads.
+const base::FeatureParam<int> kMaxConcurrentCompressions{
+    &kNavigationEntryScreenshotCompression, "max_concurrent_compressions", 2};
+
 static bool g_disable_compression_for_testing = false;
 
 using CompressionDoneCallback = base::OnceCallback<void(sk_sp<SkPixelRef>)>;
-void CompressNavigationScreenshotOnWorkerThread(
+sk_sp<SkPixelRef> CompressNavigationScreenshotOnWorkerThread(
     SkBitmap bitmap,
-    bool supports_etc_non_power_of_two,
-    CompressionDoneCallback done_callback) {
+    bool supports_etc_non_power_of_two) {
   SCOPED_UMA_HISTOGRAM_TIMER("Navigation.GestureTransition.CompressionTime");
   TRACE_EVENT0("navigation", "CompressNavigationScreenshotOnWorkerThread");
 
-  sk_sp<SkPixelRef> compressed_bitmap = nullptr;
   if (base::FeatureList::IsEnabled(ui::kCompressBitmapAtBackgroundPriority)) {
-    compressed_bitmap = ui::Etc1::CompressBitmapAtBackgroundPriority(
+    return ui::Etc1::CompressBitmapAtBackgroundPriority(
         bitmap, supports_etc_non_power_of_two);
-  } else {
-    compressed_bitmap =
-        ui::Etc1::CompressBitmap(bitmap, supports_etc_non_power_of_two);
   }
+  return ui::Etc1::CompressBitmap(bitmap, supports_etc_non_power_of_two);
+}
 
-  if (compressed_bitmap) {
-    std::move(done_callback).Run(std::move(compressed_bitmap));
+// Schedules the compression of the screenshots of all tabs on the UI thread.
+// At most `kMaxConcurrentCompressions` run at a time, and the most recently
+// captured screenshot, i.e. the one for the entry closest to the current entry
+// of its tab, is compressed first. Pending screenshots that are destroyed (e.g.
+// evicted by the cache because they didn't fit in the budget) are dropped
+// without being compressed.
+class ScreenshotCompressionQueue {
+ public:
+  static ScreenshotCompressionQueue& Get() {
+    static base::NoDestructor<ScreenshotCompressionQueue> instance;
+    return *instance;
   }
-}
+
+  // `done_callback` is run on the UI thread with the compressed bitmap, unless
+  // `screenshot` is destroyed first or the compression fails.
+  void Enqueue(base::WeakPtr<NavigationEntryScreenshot> screenshot,
+               const SkBitmap& bitmap,
+               bool supports_etc_non_power_of_two,
+               CompressionDoneCallback done_callback) {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    pending_bytes_ += bitmap.computeByteSize();
+    peak_pending_bytes_ = std::max(peak_pending_bytes_, pending_bytes_);
+    pending_.push_back({std::move(screenshot), bitmap,
+                        supports_etc_non_power_of_two, std::move(done_callback),
+                        base::TimeTicks::Now()});
+    MaybeStartNext();
+  }
+
+  size_t pending_count() const { return pending_.size() + in_flight_; }
+
+  void set_compression_started_callback_for_testing(
+      NavigationEntryScreenshot::CompressionStartedCallback callback) {
+    compression_started_callback_for_testing_ = std::move(callback);
+  }
+
+ private:
+  struct PendingCompression {
+    base::WeakPtr<NavigationEntryScreenshot> screenshot;
+    SkBitmap bitmap;
+    bool supports_etc_non_power_of_two;
+    CompressionDoneCallback done_callback;
+    base::TimeTicks enqueue_time;
+  };
+
+  void MaybeStartNext() {
+    const size_t max_in_flight =
+        static_cast<size_t>(std::max(1, kMaxConcurrentCompressions.Get()));
+    while (in_flight_ < max_in_flight && !pending_.empty()) {
+      PendingCompression next = std::move(pending_.back());
+      pending_.pop_back();
+      const size_t bitmap_bytes = next.bitmap.computeByteSize();
+      if (!next.screenshot) {
+        pending_bytes_ -= bitmap_bytes;
+        continue;
+      }
+      ++in_flight_;
+      if (compression_started_callback_for_testing_) {
+        compression_started_callback_for_testing_.Run(
+            next.screenshot->unique_id());
+      }
+      base::ThreadPool::PostTaskAndReplyWithResult(
+          FROM_HERE,
+          {base::TaskPriority::BEST_EFFORT,
+           base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
+          base::BindOnce(&CompressNavigationScreenshotOnWorkerThread,
+                         std::move(next.bitmap),
+                         next.supports_etc_non_power_of_two),
+          base::BindOnce(&ScreenshotCompressionQueue::OnCompressed,
+                         base::Unretained(this), std::move(next.screenshot),
+                         std::move(next.done_callback), bitmap_bytes,
+                         next.enqueue_time));
+    }
+    MaybeRecordPeak();
+  }
+
+  void OnCompressed(base::WeakPtr<NavigationEntryScreenshot> screenshot,
+                    CompressionDoneCallback done_callback,
+                    size_t bitmap_bytes,
+                    base::TimeTicks enqueue_time,
+                    sk_sp<SkPixelRef> compressed_bitmap) {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    CHECK_GT(in_flight_, 0u);
+    --in_flight_;
+    pending_bytes_ -= bitmap_bytes;
+    if (screenshot && compressed_bitmap) {
+      base::UmaHistogramMediumTimes(
+          "Navigation.GestureTransition.TimeToCompressed",
+          base::TimeTicks::Now() - enqueue_time);
+      std::move(done_callback).Run(std::move(compressed_bitmap));
+    }
+    MaybeStartNext();
+  }
+
+  // Records the peak uncompressed bytes waiting for compression once the queue
+  // is drained.
+  void MaybeRecordPeak() {
+    if (pending_count() || !peak_pending_bytes_) {
+      return;
+    }
+    base::UmaHistogramMemoryKB(
+        "Navigation.GestureTransition.PeakPendingCompressionSize",
+        peak_pending_bytes_ / 1024);
+    peak_pending_bytes_ = 0;
+  }
+
+  // LIFO: the most recently captured screenshot is at the back.
+  std::vector<PendingCompression> pending_;
+  size_t in_flight_ = 0;
+
+  // Uncompressed bytes of the screenshots in `pending_` or in flight.
+  size_t pending_bytes_ = 0;
+  size_t peak_pending_bytes_ = 0;
+
+  NavigationEntryScreenshot::CompressionStartedCallback
+      compression_started_callback_for_testing_;
+};
 
 }  // namespace
 #endif
@@ -65,6 +184,28 @@ void NavigationEntryScreenshot::SetDisableCompressionForTesting(bool disable) {
 #endif
 }
 
+// static
+size_t NavigationEntryScreenshot::GetPendingCompressionCountForTesting() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+#if BUILDFLAG(IS_ANDROID)
+  return ScreenshotCompressionQueue::Get().pending_count();
+#else
+  return 0u;
+#endif
+}
+
+// static
+void NavigationEntryScreenshot::SetCompressionStartedCallbackForTesting(
+    CompressionStartedCallback callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+
+#if BUILDFLAG(IS_ANDROID)
+  ScreenshotCompressionQueue::Get()
+      .set_compression_started_callback_for_testing(std::move(callback));
+#endif
+}
+
 NavigationEntryScreenshot::NavigationEntryScreenshot(
     const SkBitmap& bitmap,
     NavigationTransitionData::UniqueId unique_id,
@@ -120,17 +261,10 @@ void NavigationEntryScreenshot::StartCompression(
     return;
   }
 
-  CompressionDoneCallback done_callback = base::BindPostTask(
-      GetUIThreadTaskRunner(),
+  ScreenshotCompressionQueue::Get().Enqueue(
+      weak_factory_.GetWeakPtr(), bitmap, supports_etc_non_power_of_two,
       base::BindOnce(&NavigationEntryScreenshot::OnCompressionFinished,
                      weak_factory_.GetWeakPtr()));
-
-  base::ThreadPool::PostTask(
-      FROM_HERE,
-      {base::TaskPriority::BEST_EFFORT,
-       base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
-      base::BindOnce(&CompressNavigationScreenshotOnWorkerThread, bitmap,
-                     supports_etc_non_power_of_two, std::move(done_callback)));
 #endif
 }
 
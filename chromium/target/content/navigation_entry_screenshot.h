@@ -5,6 +5,7 @@
 #ifndef CONTENT_BROWSER_RENDERER_HOST_NAVIGATION_TRANSITIONS_NAVIGATION_ENTRY_SCREENSHOT_H_
 #define CONTENT_BROWSER_RENDERER_HOST_NAVIGATION_TRANSITIONS_NAVIGATION_ENTRY_SCREENSHOT_H_
 
+#include "base/functional/callback.h"
 #include "base/supports_user_data.h"
 #include "cc/resources/ui_resource_bitmap.h"
 #include "cc/resources/ui_resource_client.h"
@@ -51,6 +52,17 @@ class CONTENT_EXPORT NavigationEntryScreenshot
 
   static void SetDisableCompressionForTesting(bool disable);
 
+  // Returns the number of screenshots waiting for or undergoing compression,
+  // across all tabs.
+  static size_t GetPendingCompressionCountForTesting();
+
+  // `callback` is run with the screenshot's unique ID whenever a screenshot is
+  // handed to a worker thread for compression.
+  using CompressionStartedCallback =
+      base::RepeatingCallback<void(NavigationTransitionData::UniqueId)>;
+  static void SetCompressionStartedCallbackForTesting(
+      CompressionStartedCallback callback);
+
   NavigationEntryScreenshot(const SkBitmap& bitmap,
                             NavigationTransitionData::UniqueId unique_id,
                             bool supports_etc_non_power_of_two);
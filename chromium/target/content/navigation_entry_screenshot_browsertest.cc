@@ -4,14 +4,17 @@
 
 #include "content/browser/renderer_host/navigation_transitions/navigation_entry_screenshot.h"
 
+#include <memory>
 #include <optional>
 #include <string_view>
 #include <vector>
 
 #include "base/functional/bind.h"
+#include "base/functional/callback_helpers.h"
 #include "base/strings/stringprintf.h"
 #include "base/system/sys_info.h"
 #include "base/test/bind.h"
+#include "base/test/run_until.h"
 #include "base/test/scoped_feature_list.h"
 #include "base/test/simple_test_tick_clock.h"
 #include "base/test/test_future.h"
@@ -50,6 +53,7 @@
 #include "services/viz/privileged/mojom/compositing/features.mojom-features.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/gfx/switches.h"
 #include "url/url_constants.h"
 
@@ -2434,6 +2438,13 @@ class NavigationEntryScreenshotCompressionBrowserTest
     return web_contents()->GetController();
   }
 
+  static SkBitmap MakeScreenshotBitmap() {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 64);
+    bitmap.eraseColor(SK_ColorRED);
+    return bitmap;
+  }
+
  private:
   base::test::ScopedFeatureList scoped_feature_list_;
 };
@@ -2486,6 +2497,77 @@ IN_PROC_BROWSER_TEST_F(NavigationEntryScreenshotCompressionBrowserTest, Basic) {
                   controller(), controller().GetLastCommittedEntryIndex() - 1));
     ASSERT_EQ(manager->GetCurrentCacheSize(), 2 * compressed_screenshot_bytes);
   }
+
+  // The evicted red screenshot is not compressed after being evicted, and
+  // nothing is left in the compression queue.
+  EXPECT_EQ(NavigationEntryScreenshot::GetPendingCompressionCountForTesting(),
+            0u);
+}
+
+// Screenshots are compressed at most two at a time, most recently captured
+// first.
+IN_PROC_BROWSER_TEST_F(NavigationEntryScreenshotCompressionBrowserTest,
+                       CompressesMostRecentFirstAndAtMostTwoAtOnce) {
+  std::vector<NavigationTransitionData::UniqueId> started;
+  NavigationEntryScreenshot::SetCompressionStartedCallbackForTesting(
+      base::BindLambdaForTesting([&](NavigationTransitionData::UniqueId id) {
+        started.push_back(id);
+      }));
+
+  std::vector<NavigationTransitionData::UniqueId> ids;
+  std::vector<std::unique_ptr<NavigationEntryScreenshot>> screenshots;
+  for (int i = 0; i < 4; ++i) {
+    ids.emplace_back(i);
+    screenshots.push_back(std::make_unique<NavigationEntryScreenshot>(
+        MakeScreenshotBitmap(), ids.back(),
+        /*supports_etc_non_power_of_two=*/true));
+  }
+
+  // The first two start right away, and the others wait for them, since no
+  // compression finishes before the UI thread runs its replies.
+  EXPECT_THAT(started, testing::ElementsAre(ids[0], ids[1]));
+  EXPECT_EQ(NavigationEntryScreenshot::GetPendingCompressionCountForTesting(),
+            4u);
+
+  ASSERT_TRUE(base::test::RunUntil([]() {
+    return NavigationEntryScreenshot::GetPendingCompressionCountForTesting() ==
+           0u;
+  }));
+  EXPECT_THAT(started, testing::ElementsAre(ids[0], ids[1], ids[3], ids[2]));
+
+  NavigationEntryScreenshot::SetCompressionStartedCallbackForTesting(
+      base::NullCallback());
+}
+
+// Screenshots destroyed while waiting for compression, e.g. when the cache
+// evicts them, never reach a worker thread.
+IN_PROC_BROWSER_TEST_F(NavigationEntryScreenshotCompressionBrowserTest,
+                       DestroyedScreenshotIsNotCompressed) {
+  std::vector<NavigationTransitionData::UniqueId> started;
+  NavigationEntryScreenshot::SetCompressionStartedCallbackForTesting(
+      base::BindLambdaForTesting([&](NavigationTransitionData::UniqueId id) {
+        started.push_back(id);
+      }));
+
+  std::vector<NavigationTransitionData::UniqueId> ids;
+  std::vector<std::unique_ptr<NavigationEntryScreenshot>> screenshots;
+  for (int i = 0; i < 3; ++i) {
+    ids.emplace_back(i);
+    screenshots.push_back(std::make_unique<NavigationEntryScreenshot>(
+        MakeScreenshotBitmap(), ids.back(),
+        /*supports_etc_non_power_of_two=*/true));
+  }
+  EXPECT_THAT(started, testing::ElementsAre(ids[0], ids[1]));
+
+  screenshots[2].reset();
+  ASSERT_TRUE(base::test::RunUntil([]() {
+    return NavigationEntryScreenshot::GetPendingCompressionCountForTesting() ==
+           0u;
+  }));
+  EXPECT_THAT(started, testing::ElementsAre(ids[0], ids[1]));
+
+  NavigationEntryScreenshot::SetCompressionStartedCallbackForTesting(
+      base::NullCallback());
 }
 
 }  // namespace content
@@ -7,6 +7,7 @@
 
 #include <map>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 #include "base/feature_list.h"
@@ -153,9 +154,15 @@ void IterateCandidates(
     // The URLs starting with `https://example.com/index.html` don't necessarily
     // have the same non-ref/query parts. See
     // `NoVarySearchHelperTest.DoNotPrefixMatch` unit tests for concrete
-    // examples.
-    if (prefetch_container_url.ReplaceComponents(replacements) !=
-        url_with_no_query) {
+    // examples. As both specs are canonical, the non-ref/query parts are the
+    // same iff the remainder after the common prefix is empty or starts the
+    // query or the ref. This avoids re-parsing every candidate URL, which
+    // matters for pages that prefetch many URLs differing only in the query.
+    std::string_view remainder =
+        std::string_view(prefetch_container_url.possibly_invalid_spec())
+            .substr(url_with_no_query.possibly_invalid_spec().size());
+    if (!remainder.empty() && remainder.front() != '?' &&
+        remainder.front() != '#') {
       continue;
     }
 
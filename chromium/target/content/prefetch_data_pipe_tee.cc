@@ -4,6 +4,8 @@
 
 #include "content/browser/preloading/prefetch/prefetch_data_pipe_tee.h"
 
+#include <algorithm>
+
 #include "base/containers/span.h"
 #include "base/notreached.h"
 #include "mojo/public/cpp/system/string_data_source.h"
@@ -13,6 +15,11 @@ namespace content {
 
 namespace {
 
+// Upper bound on the part of `buffer_` allocated upfront from the expected body
+// size. The expected size comes from the server and can't be trusted, so larger
+// bodies grow `buffer_` as they're actually read.
+constexpr size_t kMaxInitialBufferReservation = 64 * 1024;
+
 MojoResult CreateDataPipeForServingData(
     mojo::ScopedDataPipeProducerHandle& producer_handle,
     mojo::ScopedDataPipeConsumerHandle& consumer_handle) {
@@ -31,7 +38,8 @@ MojoResult CreateDataPipeForServingData(
 
 PrefetchDataPipeTee::PrefetchDataPipeTee(
     mojo::ScopedDataPipeConsumerHandle source,
-    size_t buffer_limit)
+    size_t buffer_limit,
+    std::optional<size_t> expected_body_size)
     : source_(std::move(source)),
       source_watcher_(FROM_HERE,
                       mojo::SimpleWatcher::ArmingPolicy::MANUAL,
@@ -40,6 +48,10 @@ PrefetchDataPipeTee::PrefetchDataPipeTee(
       target_watcher_(FROM_HERE,
                       mojo::SimpleWatcher::ArmingPolicy::AUTOMATIC,
                       base::SequencedTaskRunner::GetCurrentDefault()) {
+  if (expected_body_size) {
+    buffer_.reserve(std::min(
+        {*expected_body_size, buffer_limit_, kMaxInitialBufferReservation}));
+  }
   source_watcher_.Watch(source_.get(), MOJO_HANDLE_SIGNAL_READABLE,
                         MOJO_TRIGGER_CONDITION_SIGNALS_SATISFIED,
                         base::BindRepeating(&PrefetchDataPipeTee::OnReadable,
@@ -52,6 +64,15 @@ PrefetchDataPipeTee::~PrefetchDataPipeTee() {
 
   base::UmaHistogramEnumeration(
       "Preloading.Prefetch.PrefetchDataPipeTeeDtorState", state_);
+  if (state_ == State::kLoaded) {
+    // Memory held by the shared body buffer, and how many consumers shared it.
+    base::UmaHistogramMemoryKB(
+        "Preloading.Prefetch.PrefetchDataPipeTeeLoadedBufferSize",
+        buffer_.capacity() / 1024);
+    base::UmaHistogramCounts100(
+        "Preloading.Prefetch.PrefetchDataPipeTeeLoadedCloneCount",
+        count_clone_served_from_loaded_buffer_);
+  }
 }
 
 mojo::ScopedDataPipeConsumerHandle PrefetchDataPipeTee::Clone() {
@@ -77,6 +98,7 @@ mojo::ScopedDataPipeConsumerHandle PrefetchDataPipeTee::Clone() {
           count_clone_called_);
       return {};
     case State::kLoaded:
+      ++count_clone_served_from_loaded_buffer_;
       break;
   }
 
@@ -143,10 +165,11 @@ void PrefetchDataPipeTee::OnReadable(MojoResult result,
           break;
         }
 
-        // If there is a target, clear the current `buffer_` because it was
-        // already written to the target. The current read data is written to
-        // the target below.
-        buffer_.clear();
+        // If there is a target, drop the current `buffer_` because it was
+        // already written to the target, and release its memory since from now
+        // on it only holds one chunk at a time. The current read data is
+        // written to the target below.
+        std::string().swap(buffer_);
         state_ = State::kSizeExceeded;
         [[fallthrough]];
 
@@ -173,6 +196,12 @@ void PrefetchDataPipeTee::OnReadable(MojoResult result,
         state_ = State::kLoaded;
         // Closes the producer handle, if any.
         ResetTarget({});
+        // `buffer_` won't grow anymore but can be kept for a while to serve
+        // future clones, so release the spare capacity. This is safe because
+        // reading is blocked (and thus this is not reached) while any write
+        // referring to `buffer_` is ongoing.
+        CHECK_EQ(pending_writes_, 0u);
+        buffer_.shrink_to_fit();
         break;
       case State::kSizeExceeded:
         // Closes the producer handle, if any.
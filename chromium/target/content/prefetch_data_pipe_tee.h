@@ -5,6 +5,8 @@
 #ifndef CONTENT_BROWSER_PRELOADING_PREFETCH_PREFETCH_DATA_PIPE_TEE_H_
 #define CONTENT_BROWSER_PRELOADING_PREFETCH_PREFETCH_DATA_PIPE_TEE_H_
 
+#include <optional>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
@@ -38,8 +40,13 @@ namespace content {
 class CONTENT_EXPORT PrefetchDataPipeTee final
     : public base::RefCounted<PrefetchDataPipeTee> {
  public:
-  explicit PrefetchDataPipeTee(mojo::ScopedDataPipeConsumerHandle source,
-                               size_t buffer_limit);
+  // `expected_body_size` is a hint (e.g. from `Content-Length`) used to
+  // allocate the start of `buffer_` upfront, so that small bodies aren't
+  // repeatedly reallocated and copied as they're read.
+  PrefetchDataPipeTee(
+      mojo::ScopedDataPipeConsumerHandle source,
+      size_t buffer_limit,
+      std::optional<size_t> expected_body_size = std::nullopt);
 
   PrefetchDataPipeTee(const PrefetchDataPipeTee&) = delete;
   PrefetchDataPipeTee& operator=(const PrefetchDataPipeTee&) = delete;
@@ -47,6 +54,8 @@ class CONTENT_EXPORT PrefetchDataPipeTee final
   // Returns a cloned data pipe, or a null handle when failed.
   mojo::ScopedDataPipeConsumerHandle Clone();
 
+  size_t buffer_capacity_for_testing() const { return buffer_.capacity(); }
+
   // Public for unit tests.
   //
   // These values are persisted to logs. Entries should not be renumbered and
@@ -87,7 +96,9 @@ class CONTENT_EXPORT PrefetchDataPipeTee final
     // Reading data from `source_` is completed and the data is fully stored in
     // `buffer_` without reaching the buffer limit.
     // `target_` is null.
-    // Any number of cloned data pipes can be created.
+    // Any number of cloned data pipes can be created. `buffer_` is immutable
+    // from here on, and all cloned data pipes are written directly from it
+    // without making further copies.
     kLoaded = 3,
 
     kMaxValue = kLoaded,
@@ -143,6 +154,9 @@ class CONTENT_EXPORT PrefetchDataPipeTee final
   // How many times `Clone()` is called.
   int count_clone_called_ = 0;
 
+  // How many cloned data pipes are served from `buffer_` in `kLoaded`.
+  int count_clone_served_from_loaded_buffer_ = 0;
+
   base::WeakPtrFactory<PrefetchDataPipeTee> weak_factory_{this};
 };
 
@@ -259,6 +259,69 @@ TEST_P(PrefetchDataPipeTeeTest, LoadedThenFirstTargetAdded) {
                     .GetTotalCountsForPrefix(
                         "Preloading.Prefetch.PrefetchDataPipeTeeCloneFailed.")
                     .size());
+  // Both targets are served from the shared buffer.
+  histogram_tester().ExpectUniqueSample(
+      "Preloading.Prefetch.PrefetchDataPipeTeeLoadedCloneCount", 2, 1);
+  histogram_tester().ExpectTotalCount(
+      "Preloading.Prefetch.PrefetchDataPipeTeeLoadedBufferSize", 1);
+}
+
+TEST_P(PrefetchDataPipeTeeTest, ExpectedBodySize) {
+  mojo::ScopedDataPipeConsumerHandle source_consumer_handle;
+  mojo::ScopedDataPipeProducerHandle source_producer_handle;
+  ASSERT_EQ(mojo::CreateDataPipe(kProducerPipeCapacity, source_producer_handle,
+                                 source_consumer_handle),
+            MOJO_RESULT_OK);
+  auto source_producer = std::make_unique<mojo::DataPipeProducer>(
+      std::move(source_producer_handle));
+
+  // An expected size larger than the limit is capped, and a wrong hint
+  // doesn't affect the served data.
+  auto tee = base::MakeRefCounted<PrefetchDataPipeTee>(
+      std::move(source_consumer_handle), kBufferLimit,
+      /*expected_body_size=*/kBufferLimit * 100);
+
+  base::RunLoop loop;
+  source_producer->Write(
+      std::make_unique<mojo::StringDataSource>(
+          "Body", mojo::StringDataSource::AsyncWritingMode::
+                      STRING_STAYS_VALID_UNTIL_COMPLETION),
+      base::BindOnce([](base::OnceClosure quit,
+                        MojoResult result) { std::move(quit).Run(); },
+                     loop.QuitClosure()));
+  loop.Run();
+  source_producer.reset();
+  task_environment().RunUntilIdle();
+
+  auto target1 = DataPipeReader(tee->Clone());
+  auto target2 = DataPipeReader(tee->Clone());
+  if (GetParam()) {
+    tee.reset();
+  }
+
+  EXPECT_EQ(target1.ReadData(32), "Body");
+  EXPECT_EQ(target2.ReadData(32), "Body");
+}
+
+TEST_P(PrefetchDataPipeTeeTest, ExpectedBodySizeReservation) {
+  constexpr size_t kLargeBufferLimit = 10 * 1024 * 1024;
+  auto create_tee = [&](size_t expected_body_size) {
+    mojo::ScopedDataPipeConsumerHandle source_consumer_handle;
+    mojo::ScopedDataPipeProducerHandle source_producer_handle;
+    CHECK_EQ(mojo::CreateDataPipe(kProducerPipeCapacity, source_producer_handle,
+                                  source_consumer_handle),
+             MOJO_RESULT_OK);
+    return base::MakeRefCounted<PrefetchDataPipeTee>(
+        std::move(source_consumer_handle), kLargeBufferLimit,
+        expected_body_size);
+  };
+
+  // A small expected size is allocated upfront.
+  EXPECT_GE(create_tee(4096)->buffer_capacity_for_testing(), 4096u);
+
+  // A large expected size, which might be wrong, is not.
+  EXPECT_LT(create_tee(kLargeBufferLimit)->buffer_capacity_for_testing(),
+            1024u * 1024u);
 }
 
 TEST_P(PrefetchDataPipeTeeTest, FirstTargetAddedThenExceedLimit) {
@@ -463,7 +463,10 @@ void PrefetchResponseReader::OnReceiveResponse(
   head_ = std::move(head);
   if (is_reusable_) {
     body_tee_ = base::MakeRefCounted<PrefetchDataPipeTee>(
-        std::move(body), GetPrefetchDataPipeTeeBodySizeLimit());
+        std::move(body), GetPrefetchDataPipeTeeBodySizeLimit(),
+        head_->content_length > 0
+            ? std::make_optional(static_cast<size_t>(head_->content_length))
+            : std::nullopt);
   } else {
     body_ = std::move(body);
   }
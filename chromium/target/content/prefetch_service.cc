@@ -305,6 +305,13 @@ bool IsReferrerPolicySufficientlyStrict(
   }
 }
 
+GURL GetURLWithoutRefAndQuery(const GURL& url) {
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  replacements.ClearQuery();
+  return url.ReplaceComponents(replacements);
+}
+
 }  // namespace
 
 // static
@@ -455,19 +462,61 @@ void PrefetchService::AddPrefetchContainerWithoutStartingPrefetch(
       ResetPrefetchContainer(prefetch_iter->second->GetWeakPtr());
       owned_prefetches_[prefetch_container_key] =
           std::move(owned_prefetch_container);
+      AddToUrlIndex(prefetch_container_key);
       break;
     case Action::kTakeNew:
       owned_prefetches_[prefetch_container_key] =
           std::move(owned_prefetch_container);
+      AddToUrlIndex(prefetch_container_key);
       break;
   }
 }
 
+void PrefetchService::AddToUrlIndex(const PrefetchContainer::Key& key) {
+  prefetch_keys_by_url_without_ref_and_query_[GetURLWithoutRefAndQuery(
+                                                  key.url())]
+      .insert(key);
+}
+
+void PrefetchService::RemoveFromUrlIndex(const PrefetchContainer::Key& key) {
+  auto it = prefetch_keys_by_url_without_ref_and_query_.find(
+      GetURLWithoutRefAndQuery(key.url()));
+  CHECK(it != prefetch_keys_by_url_without_ref_and_query_.end());
+  it->second.erase(key);
+  if (it->second.empty()) {
+    prefetch_keys_by_url_without_ref_and_query_.erase(it);
+  }
+}
+
+std::vector<PrefetchContainer*>
+PrefetchService::GetPrefetchesWithSameUrlWithoutRefAndQuery(
+    const GURL& url) const {
+  std::vector<PrefetchContainer*> result;
+  auto it = prefetch_keys_by_url_without_ref_and_query_.find(
+      GetURLWithoutRefAndQuery(url));
+  if (it == prefetch_keys_by_url_without_ref_and_query_.end()) {
+    return result;
+  }
+  result.reserve(it->second.size());
+  for (const PrefetchContainer::Key& key : it->second) {
+    auto prefetch_it = owned_prefetches_.find(key);
+    CHECK(prefetch_it != owned_prefetches_.end());
+    if (prefetch_it->second) {
+      result.push_back(prefetch_it->second.get());
+    }
+  }
+  return result;
+}
+
 bool PrefetchService::IsPrefetchDuplicate(
     GURL& url,
     std::optional<net::HttpNoVarySearchData> no_vary_search_hint) {
   TRACE_EVENT0("loading", "PrefetchService::IsPrefetchDuplicate");
-  for (const auto& [key, prefetch_container] : owned_prefetches_) {
+  // URLs that are equivalent under a No-Vary-Search hint only differ in their
+  // query, so only the prefetches with the same URL without ref and query need
+  // to be checked.
+  for (PrefetchContainer* prefetch_container :
+       GetPrefetchesWithSameUrlWithoutRefAndQuery(url)) {
     if (IsPrefetchStale(prefetch_container->GetWeakPtr())) {
       continue;
     }
@@ -487,10 +536,11 @@ bool PrefetchService::IsPrefetchDuplicate(
 
     bool urls_equal;
     if (no_vary_search_hint) {
-      urls_equal = no_vary_search_hint->AreEquivalent(url, key.url());
+      urls_equal =
+          no_vary_search_hint->AreEquivalent(url, prefetch_container->GetURL());
     } else {
       // If there is no no-vary-search hint, just compare the URLs.
-      urls_equal = url == key.url();
+      urls_equal = url == prefetch_container->GetURL();
     }
 
     if (!urls_equal) {
@@ -1363,6 +1413,7 @@ void PrefetchService::ResetPrefetchContainer(
     active_prefetch_ = std::nullopt;
   }
 
+  RemoveFromUrlIndex(it->first);
   owned_prefetches_.erase(it);
 }
 
@@ -1815,35 +1866,35 @@ void PrefetchService::RecordExistingPrefetchWithMatchingURL(
   int num_matching_prefetch_same_referrer = 0;
   int num_matching_prefetch_same_rfh = 0;
 
-  for (const auto& prefetch_iter : owned_prefetches_) {
-    if (prefetch_iter.second &&
-        prefetch_iter.second->GetURL() == prefetch_container->GetURL()) {
+  for (PrefetchContainer* existing_prefetch :
+       GetPrefetchesWithSameUrlWithoutRefAndQuery(
+           prefetch_container->GetURL())) {
+    if (existing_prefetch->GetURL() == prefetch_container->GetURL()) {
       matching_prefetch = true;
       num_matching_prefetches++;
 
-      if (prefetch_iter.second->IsInitialPrefetchEligible()) {
+      if (existing_prefetch->IsInitialPrefetchEligible()) {
         num_matching_eligible_prefetch++;
       }
 
-      switch (
-          prefetch_iter.second->GetServableState(PrefetchCacheableDuration())) {
+      switch (existing_prefetch->GetServableState(PrefetchCacheableDuration())) {
         case PrefetchContainer::ServableState::kNotServable:
         case PrefetchContainer::ServableState::kShouldBlockUntilHeadReceived:
         case PrefetchContainer::ServableState::kShouldBlockUntilEligibilityGot:
           break;
         case PrefetchContainer::ServableState::kServable:
-          if (!prefetch_iter.second->HasPrefetchBeenConsideredToServe()) {
+          if (!existing_prefetch->HasPrefetchBeenConsideredToServe()) {
             num_matching_servable_prefetch++;
           }
           break;
       }
 
-      if (prefetch_iter.second->HasSameReferringURLForMetrics(
+      if (existing_prefetch->HasSameReferringURLForMetrics(
               *prefetch_container)) {
         num_matching_prefetch_same_referrer++;
       }
 
-      if (prefetch_iter.second->GetReferringRenderFrameHostId() ==
+      if (existing_prefetch->GetReferringRenderFrameHostId() ==
           prefetch_container->GetReferringRenderFrameHostId()) {
         num_matching_prefetch_same_rfh++;
       }
@@ -7,7 +7,9 @@
 
 #include <map>
 #include <optional>
+#include <set>
 #include <string_view>
+#include <vector>
 
 #include "base/dcheck_is_on.h"
 #include "base/functional/callback_forward.h"
@@ -426,6 +428,19 @@ class CONTENT_EXPORT PrefetchService {
   void ResetPrefetchContainer(
       base::WeakPtr<PrefetchContainer> prefetch_container);
 
+  // Adds/removes `key` to/from `prefetch_keys_by_url_without_ref_and_query_`.
+  // Must be called whenever a key is added to/removed from
+  // `owned_prefetches_`.
+  void AddToUrlIndex(const PrefetchContainer::Key& key);
+  void RemoveFromUrlIndex(const PrefetchContainer::Key& key);
+
+  // Returns the prefetches in `owned_prefetches_` whose URL, ignoring the ref
+  // and query, is the same as that of `url`, regardless of the referring
+  // document. Any two URLs that are equal, or equivalent under a
+  // No-Vary-Search hint or header, are in the same set.
+  std::vector<PrefetchContainer*> GetPrefetchesWithSameUrlWithoutRefAndQuery(
+      const GURL& url) const;
+
   // Returns `true` if the `prefetch_container` is stale. I.e.
   // the prefetch either is not or never will be servable to a
   // navigation.
@@ -462,6 +477,12 @@ class CONTENT_EXPORT PrefetchService {
   std::map<PrefetchContainer::Key, std::unique_ptr<PrefetchContainer>>
       owned_prefetches_;
 
+  // Index of the keys of `owned_prefetches_` by their URL without ref and
+  // query. Lets duplicate checks and per-URL metrics visit only the prefetches
+  // that can possibly be relevant, instead of all prefetches of all documents.
+  std::map<GURL, std::set<PrefetchContainer::Key>>
+      prefetch_keys_by_url_without_ref_and_query_;
+
 // Protects against Prefetch() being called recursively.
 #if DCHECK_IS_ON()
   bool prefetch_reentrancy_guard_ = false;
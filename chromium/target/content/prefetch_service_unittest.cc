@@ -7023,6 +7023,44 @@ TEST_F(PrefetchServiceTest,
   EXPECT_FALSE(browser_context()->IsPrefetchDuplicate(pf_four_url, nvs_hint));
 }
 
+TEST_F(PrefetchServiceTest,
+       DISABLED_CHROMEOS(IsPrefetchDuplicateOnlyMatchesSameUrlWithoutQuery)) {
+  base::test::ScopedFeatureList scoped_feature_list(
+      features::kPrefetchBrowserInitiatedTriggers);
+  MakePrefetchService(
+      std::make_unique<testing::NiceMock<MockPrefetchServiceDelegate>>(
+          /*num_on_prefetch_likely_calls=*/std::nullopt));
+
+  std::unique_ptr<ProbePrefetchRequestStatusListener> probe_listener =
+      std::make_unique<ProbePrefetchRequestStatusListener>();
+
+  std::vector<std::string> no_vary_params = {"ts"};
+  net::HttpNoVarySearchData nvs_hint =
+      net::HttpNoVarySearchData::CreateFromNoVaryParams(no_vary_params, false);
+  GURL pf_one_url("https://example.com/search?q=ai&ts=1000");
+  std::unique_ptr<content::PrefetchHandle> handle =
+      MakePrefetchFromBrowserContext(
+          pf_one_url, nvs_hint, {},
+          std::make_unique<TestablePrefetchRequestStatusListener>(
+              probe_listener->GetWeakPtr()));
+  task_environment()->RunUntilIdle();
+
+  GURL pf_same_path_url("https://example.com/search?q=ai&ts=1001");
+  EXPECT_TRUE(
+      browser_context()->IsPrefetchDuplicate(pf_same_path_url, nvs_hint));
+
+  // A URL sharing the path as a string prefix isn't a duplicate.
+  GURL pf_prefix_path_url("https://example.com/search2?q=ai&ts=1001");
+  EXPECT_FALSE(
+      browser_context()->IsPrefetchDuplicate(pf_prefix_path_url, nvs_hint));
+
+  // Once the prefetch is released, it's no longer considered.
+  handle.reset();
+  task_environment()->RunUntilIdle();
+  EXPECT_FALSE(
+      browser_context()->IsPrefetchDuplicate(pf_same_path_url, nvs_hint));
+}
+
 // These tests check the behavior of
 // `PrefetchService::AddPrefetchContainerWithoutStartingPrefetch()` if an old
 // prefetch is registered and yet another new prefetch for the same key is